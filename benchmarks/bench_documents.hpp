@@ -0,0 +1,109 @@
+// Generated TOML documents of the C++ benchmark (fasttoml_bench), also
+// parsed by the C++ tests: each workload repeats one kind of section until
+// the document reaches the requested size.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace fasttoml_bench {
+
+// Deterministic pseudo-random numbers, so every run parses the same bytes
+struct Random {
+    uint64_t state = 0x853C49E6748FEA9Bull;
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    unsigned below(unsigned n) { return static_cast<unsigned>(next() % n); }
+};
+
+// Each generator appends one top-level section; documents repeat them until
+// they reach the requested size
+
+inline void strings_section(std::string& out, Random& rng, size_t n) {
+    out += "[text" + std::to_string(n) + "]\n";
+    out += "name = \"service-" + std::to_string(rng.below(100000)) + "\"\n";
+    out += "description = \"A string with \\\"escapes\\\", tabs\\t and unicode \\u00e9 in the middle\"\n";
+    out += "path = 'C:\\Users\\literal\\strings\\skip\\escapes'\n";
+    out += "plain = \"" + std::string(16 + rng.below(96), 'a' + static_cast<char>(rng.below(26))) + "\"\n";
+    out += "multi = \"\"\"\nFirst line of a multi-line basic string\nsecond line\\n  indented\"\"\"\n";
+    out += "tags = [\"alpha\", \"beta\", \"gamma\", \"delta\"]\n";
+}
+
+inline void numbers_section(std::string& out, Random& rng, size_t n) {
+    out += "[metrics" + std::to_string(n) + "]\n";
+    out += "count = " + std::to_string(rng.next() % 1000000000) + "\n";
+    out += "negative = -" + std::to_string(rng.below(100000)) + "\n";
+    out += "grouped = 1_000_" + std::to_string(100 + rng.below(900)) + "\n";
+    out += "hex = 0xDEAD_BEEF\n";
+    out += "ratio = " + std::to_string(rng.below(1000)) + "." + std::to_string(rng.below(1000000)) + "\n";
+    out += "exp = 6.626e-34\n";
+    out += "samples = [";
+    for (int i = 0; i < 16; ++i) out += (i ? ", " : "") + std::to_string(rng.below(65536));
+    out += "]\nweights = [";
+    for (int i = 0; i < 8; ++i) out += (i ? ", " : "") + std::to_string(rng.below(100)) + ".25";
+    out += "]\n";
+}
+
+inline void deep_section(std::string& out, Random& rng, size_t n) {
+    std::string path = "root" + std::to_string(n);
+    for (int depth = 0; depth < 6; ++depth) {
+        path += ".level" + std::to_string(depth);
+        out += "[" + path + "]\n";
+        out += "id = " + std::to_string(rng.below(1000)) + "\n";
+        out += "a.b.c = true\n";
+    }
+    out += "inline = { x = 1, y = { z = [1, { w = \"deep\" }] } }\n";
+}
+
+inline void array_tables_section(std::string& out, Random& rng, size_t n) {
+    // Shaped like a Cargo.lock [[package]] entry
+    out += "[[package]]\n";
+    out += "name = \"crate-" + std::to_string(n) + "\"\n";
+    out += "version = \"" + std::to_string(rng.below(10)) + "." + std::to_string(rng.below(30)) + ".0\"\n";
+    out += "source = \"registry+https://github.com/rust-lang/crates.io-index\"\n";
+    out += "checksum = \"";
+    for (int i = 0; i < 64; ++i) out += "0123456789abcdef"[rng.below(16)];
+    out += "\"\ndependencies = [\n \"libc\",\n \"serde\",\n]\n";
+}
+
+inline void datetimes_section(std::string& out, Random& rng, size_t n) {
+    char buf[160];
+    std::snprintf(buf, sizeof(buf),
+                  "[event%zu]\nat = %04u-%02u-%02uT%02u:%02u:%02uZ\n"
+                  "offset = 2024-%02u-15T08:30:00.%03u+05:30\nlocal = 1979-05-27T07:32:00\n",
+                  n, 1970 + rng.below(60), 1 + rng.below(12), 1 + rng.below(28), rng.below(24), rng.below(60),
+                  rng.below(60), 1 + rng.below(12), rng.below(1000));
+    out += buf;
+    out += "day = 1979-05-27\ntime = 07:32:00.999\n";
+    out += "history = [2020-01-01T00:00:00Z, 2021-06-30T12:00:00-07:00]\n";
+}
+
+struct Workload {
+    const char* name;
+    void (*section)(std::string&, Random&, size_t);
+};
+
+inline const Workload kWorkloads[] = {
+    {"strings", strings_section},
+    {"numbers", numbers_section},
+    {"deep", deep_section},
+    {"array_tables", array_tables_section},
+    {"datetimes", datetimes_section},
+};
+
+inline std::string generate(const Workload& workload, size_t size) {
+    std::string out;
+    out.reserve(size + 1024);
+    out += "title = \"fasttoml benchmark\"\n";
+    Random rng;
+    for (size_t n = 0; out.size() < size; ++n) workload.section(out, rng, n);
+    return out;
+}
+
+} // namespace fasttoml_bench
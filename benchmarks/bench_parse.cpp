@@ -0,0 +1,184 @@
+// Throughput of TomlParser::parse alone (no Python conversion) on generated
+// documents, in MB/s per workload and size. Built with
+// -DFASTTOML_BUILD_BENCHMARKS=ON; see BUILD.md.
+#include "fasttoml/toml_parser.hpp"
+#include "bench_documents.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace fasttoml;
+using namespace fasttoml_bench;
+
+namespace {
+
+// "64K", "1M", "500M" or a number of bytes
+bool parse_size(const std::string& text, size_t& size) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) return false;
+    size_t scale = 1;
+    if (*end == 'K' || *end == 'k') scale = 1024, ++end;
+    else if (*end == 'M' || *end == 'm') scale = 1024 * 1024, ++end;
+    if (*end != '\0' || value == 0) return false;
+    size = static_cast<size_t>(value) * scale;
+    return true;
+}
+
+std::string size_name(size_t size) {
+    if (size % (1024 * 1024) == 0) return std::to_string(size / (1024 * 1024)) + "M";
+    if (size % 1024 == 0) return std::to_string(size / 1024) + "K";
+    return std::to_string(size);
+}
+
+std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    for (std::string part; std::getline(stream, part, ',');) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+// Baselines are one "workload/size": MB/s pair per line between braces, as
+// written by --save-baseline
+std::map<std::string, double> read_baseline(const std::string& path, bool& ok) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    ok = static_cast<bool>(in);
+    char name[128];
+    double mbps;
+    for (std::string line; std::getline(in, line);) {
+        if (std::sscanf(line.c_str(), " \"%127[^\"]\" : %lf", name, &mbps) == 2) baseline[name] = mbps;
+    }
+    return baseline;
+}
+
+bool write_baseline(const std::string& path, const std::vector<std::pair<std::string, double>>& results) {
+    std::ofstream out(path);
+    out << "{\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        char line[192];
+        std::snprintf(line, sizeof(line), "  \"%s\": %.1f%s\n", results[i].first.c_str(), results[i].second,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: fasttoml_bench [--workloads strings,numbers,deep,array_tables,datetimes]\n"
+                 "                      [--sizes 1K,64K,1M,16M] [--min-time SECONDS] [--arena]\n"
+                 "                      [--baseline FILE [--tolerance FRACTION]] [--save-baseline FILE]\n"
+                 "                      [--write-inputs DIR]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> workloads;
+    for (const Workload& workload : kWorkloads) workloads.push_back(workload.name);
+    std::vector<std::string> sizes = {"1K", "64K", "1M", "16M"};
+    double min_time = 0.5;
+    double tolerance = 0.2;
+    std::string baseline_path, save_path, inputs_dir;
+    ParseOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--workloads" && has_value) workloads = split(argv[++i]);
+        else if (arg == "--sizes" && has_value) sizes = split(argv[++i]);
+        else if (arg == "--min-time" && has_value) min_time = std::atof(argv[++i]);
+        else if (arg == "--tolerance" && has_value) tolerance = std::atof(argv[++i]);
+        else if (arg == "--baseline" && has_value) baseline_path = argv[++i];
+        else if (arg == "--save-baseline" && has_value) save_path = argv[++i];
+        else if (arg == "--write-inputs" && has_value) inputs_dir = argv[++i];
+        else if (arg == "--arena") options.use_arena = options.string_views = true;  // what the Python module uses
+        else return usage();
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baseline_path.empty()) {
+        bool ok;
+        baseline = read_baseline(baseline_path, ok);
+        if (!ok) {
+            std::fprintf(stderr, "cannot read %s\n", baseline_path.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<std::pair<std::string, double>> results;
+    int regressions = 0;
+    std::printf("%-14s %8s %10s %10s %10s\n", "workload", "size", "MB/s", "baseline", "change");
+    for (const std::string& name : workloads) {
+        const Workload* workload = nullptr;
+        for (const Workload& w : kWorkloads) {
+            if (name == w.name) workload = &w;
+        }
+        if (!workload) {
+            std::fprintf(stderr, "unknown workload %s\n", name.c_str());
+            return usage();
+        }
+        for (const std::string& size_text : sizes) {
+            size_t size;
+            if (!parse_size(size_text, size)) {
+                std::fprintf(stderr, "bad size %s\n", size_text.c_str());
+                return usage();
+            }
+            const std::string input = generate(*workload, size);
+            const std::string key = (options.use_arena ? "arena/" : "") + name + "/" + size_name(size);
+            if (!inputs_dir.empty()) {
+                std::ofstream(inputs_dir + "/" + name + "-" + size_name(size) + ".toml", std::ios::binary) << input;
+            }
+
+            // Fastest of the runs: the least disturbed by the rest of the machine.
+            // Only the parse is timed; the document is freed after the clock stops.
+            TomlParser parser(options);
+            double best = 1e9, total = 0;
+            for (int runs = 0; runs < 3 || total < min_time; ++runs) {
+                const auto start = std::chrono::steady_clock::now();
+                TablePtr document = parser.parse(input);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!document) {
+                    std::fprintf(stderr, "%s: %s\n", key.c_str(), parser.get_error().c_str());
+                    return 1;
+                }
+                best = std::min(best, seconds);
+                total += seconds;
+            }
+            const double mbps = static_cast<double>(input.size()) / best / 1e6;
+            results.emplace_back(key, mbps);
+
+            const auto expected = baseline.find(key);
+            if (expected == baseline.end()) {
+                std::printf("%-14s %8s %10.1f\n", name.c_str(), size_name(size).c_str(), mbps);
+                continue;
+            }
+            const double change = mbps / expected->second - 1;
+            const bool regressed = change < -tolerance;
+            regressions += regressed;
+            std::printf("%-14s %8s %10.1f %10.1f %+9.1f%%%s\n", name.c_str(), size_name(size).c_str(), mbps,
+                        expected->second, change * 100, regressed ? "  REGRESSION" : "");
+        }
+    }
+
+    if (!save_path.empty() && !write_baseline(save_path, results)) {
+        std::fprintf(stderr, "cannot write %s\n", save_path.c_str());
+        return 2;
+    }
+    if (regressions) {
+        std::fprintf(stderr, "%d result(s) more than %.0f%% below the baseline\n", regressions, tolerance * 100);
+        return 1;
+    }
+    return 0;
+}
@@ -7,11 +7,36 @@ better performance.
 """
 from __future__ import annotations
 
+import os
 import re
-from typing import BinaryIO, TextIO, Union
+import threading
+import warnings
+from collections.abc import Mapping
+from typing import Any, BinaryIO, Dict, Iterable, Iterator, List, Optional, TextIO, Tuple, Union
 
 try:
     from ._native import loads as _loads
+    from ._native import loads_bytes as _loads_bytes
+    from ._native import load_path as _load_path
+    from ._native import loads_many as _loads_many
+    from ._native import load_many as _load_many
+    from ._native import start_load as _start_load
+    from ._native import start_load_many as _start_load_many
+    from ._native import start_loads_many as _start_loads_many
+    from ._native import loads_lazy as _loads_lazy
+    from ._native import load_lazy as _load_lazy
+    from ._native import LazyTable
+    from ._native import EventParser
+    from ._native import TOMLDecodeError
+    from ._native import Parser as _Parser
+    from ._native import dumps as _native_dumps
+    from ._native import dump_path as _dump_path
+    from ._native import load_snapshot as _load_snapshot
+    from ._native import loads_stats as _loads_stats
+    from ._native import loads_bytes_stats as _loads_bytes_stats
+    from ._native import load_path_stats as _load_path_stats
+    from ._native import make_snapshot as _make_snapshot
+    from ._native import simd_isa
 except ImportError as e:
     raise ImportError(
         "fasttoml native extension not found. "
@@ -36,23 +61,80 @@ def _get_version() -> str:
 
 __version__ = _get_version()
 
-from ._dumps import dumps, dump
+import codecs
 
-__all__ = ["loads", "load", "dumps", "dump", "__version__"]
+# LazyTable implements the read-only mapping protocol natively
+Mapping.register(LazyTable)
 
+__all__ = [
+    "loads", "loads_bytes", "loads_many", "loads_lazy", "load", "load_path", "load_many", "load_lazy",
+    "load_cached", "aload", "aload_many", "aloads_many", "LazyTable", "Parser", "EventParser", "iter_events", "dumps",
+    "dump", "TOMLDecodeError", "simd_isa",
+    "__version__",
+]
 
-def loads(s: str) -> dict:
+
+def _numeric_buffers(numeric_arrays: str) -> bool:
+    if numeric_arrays == "list":
+        return False
+    if numeric_arrays == "buffer":
+        return True
+    raise ValueError(f"numeric_arrays must be 'list' or 'buffer', not {numeric_arrays!r}")
+
+
+def _check_stats(select: Optional[Iterable[str]]) -> None:
+    if select is not None:
+        raise ValueError("stats=True cannot be combined with select")
+
+
+def _warn_arena(arena: Optional[bool]) -> None:
+    # arena= selected the arena for the C++ tree loads() used to convert; it
+    # is accepted for one more release
+    if arena is not None:
+        warnings.warn("arena= is deprecated and ignored: dicts are built while parsing, without a C++ tree",
+                      DeprecationWarning, stacklevel=3)
+
+
+def loads(s: str, *, select: Optional[Iterable[str]] = None, numeric_arrays: str = "list",
+          threads: int = 1, stats: bool = False,
+          arena: Optional[bool] = None) -> Union[dict, Tuple[dict, Dict[str, int]]]:
     """
     Parse a TOML string and return a dictionary.
     
     Args:
         s: The TOML string to parse
+        select: Optional iterable of key paths such as "database.pool.size" or
+            "servers[*].host". Only these parts of the document are parsed and
+            returned (with their enclosing tables); everything else is skipped
+            without being parsed, so errors in skipped values are not reported.
+        numeric_arrays: "list" (default) or "buffer". With "buffer", arrays
+            whose elements are all integers or all floats (and not empty) are
+            returned as array.array of typecode 'q' (int64) or 'd' (double)
+            instead of lists; they support the buffer protocol, so
+            numpy.asarray() and memoryview() use them without copying.
+        threads: Native threads for documents of 1 MiB or more (0 = one per
+            CPU). The document is split at its top-level [table] and [[array]]
+            headers and the sections are parsed concurrently; the result and
+            any error are the same as with one thread. Ignored with select.
+        stats: Also profile the parse and return (data, stats). stats holds
+            "bytes"; counts of "integers", "floats", "booleans", "strings",
+            "datetimes", "arrays", "inline_tables", "tables" and
+            "array_tables" headers, and "keys"; "max_depth"; the document's
+            arena memory ("arena_bytes", "arena_blocks", "arena_reserved");
+            and nanoseconds in "validate_ns", "strings_ns", "numbers_ns",
+            "datetimes_ns", "tables_ns" (headers and key paths), the whole
+            native "parse_ns" and the conversion to Python, "convert_ns".
+            The profiled parse runs on one thread and is somewhat slower (a
+            clock read per value). Not with select.
+        arena: Deprecated and ignored (dicts are built while parsing, with no
+            intermediate tree to allocate); passing it warns.
         
     Returns:
-        dict: Parsed TOML data as a Python dictionary
+        dict: Parsed TOML data as a Python dictionary ((dict, dict) with stats)
         
     Raises:
-        ValueError: If parsing fails
+        TOMLDecodeError: If parsing fails (a ValueError; its lineno, colno
+            and pos attributes locate the error)
         
     Example:
         >>> import fasttoml
@@ -61,35 +143,485 @@ def loads(s: str) -> dict:
         >>> print(data)
         {'key': 'value'}
     """
+    _warn_arena(arena)
+    numeric_buffers = _numeric_buffers(numeric_arrays)
+    if stats:
+        _check_stats(select)
+        return _loads_stats(s, numeric_buffers)
+    return _loads(s, select, numeric_buffers, threads)
+
+
+def loads_bytes(b: Union[bytes, bytearray, memoryview], *,
+                select: Optional[Iterable[str]] = None, numeric_arrays: str = "list", threads: int = 1,
+                stats: bool = False) -> Union[dict, Tuple[dict, Dict[str, int]]]:
+    """
+    Parse UTF-8 encoded TOML from a bytes-like object and return a dictionary.
+
+    The buffer is parsed in place (no decode to str, no copy) with the GIL released.
+
+    Args:
+        b: bytes, bytearray, memoryview or another C-contiguous buffer.
+        select: Optional iterable of key paths to parse, see loads().
+        numeric_arrays: "list" or "buffer", see loads().
+        threads: Threads for large documents, see loads().
+        stats: Also return a profile of the parse, see loads().
+
+    Returns:
+        Parsed TOML data as a Python dictionary.
+
+    Raises:
+        TOMLDecodeError: If the content is not valid TOML or not valid UTF-8.
+    """
+    numeric_buffers = _numeric_buffers(numeric_arrays)
+    if stats:
+        _check_stats(select)
+        return _loads_bytes_stats(b, numeric_buffers)
+    return _loads_bytes(b, select, numeric_buffers, threads)
+
+
+def load_path(path: Union[str, bytes, os.PathLike], *,
+              select: Optional[Iterable[str]] = None, numeric_arrays: str = "list", threads: int = 1,
+              stats: bool = False) -> Union[dict, Tuple[dict, Dict[str, int]]]:
+    """
+    Parse a TOML file given by path and return a dictionary.
+
+    The file is memory-mapped and parsed in place with the GIL released.
+
+    Args:
+        path: File path (str, bytes or path-like object).
+        select: Optional iterable of key paths to parse, see loads().
+        numeric_arrays: "list" or "buffer", see loads().
+        threads: Threads for large documents, see loads().
+        stats: Also return a profile of the parse, see loads().
+
+    Returns:
+        Parsed TOML data as a Python dictionary.
+
+    Raises:
+        TOMLDecodeError: If the content is not valid TOML or not valid UTF-8.
+        FileNotFoundError: If the file does not exist.
+        OSError: If the file cannot be opened or mapped.
+    """
+    numeric_buffers = _numeric_buffers(numeric_arrays)
+    if stats:
+        _check_stats(select)
+        return _load_path_stats(os.fspath(path), numeric_buffers)
+    return _load_path(os.fspath(path), select, numeric_buffers, threads)
+
+
+def load_cached(path: Union[str, bytes, os.PathLike], *,
+                snapshot: Optional[Union[str, bytes, os.PathLike]] = None, check: str = "mtime") -> dict:
+    """
+    Parse a TOML file like load_path(), reusing a binary snapshot of the last parse.
+
+    The first call parses the file and writes a snapshot next to it (by
+    default ".<name>.ftsnap" in the same directory); later calls build the
+    dictionary straight from the memory-mapped snapshot, without parsing, as
+    long as the file has not changed. A stale, damaged or unreadable snapshot
+    is replaced, and if the snapshot cannot be written the file is just parsed.
+
+    Args:
+        path: File path (str, bytes or path-like object).
+        snapshot: Snapshot path (default: a hidden file next to path).
+        check: How to tell the file has changed: "mtime" compares its size and
+            modification time (like .pyc files); "hash" compares its size and a
+            hash of its contents, which also notices edits that keep the mtime.
+
+    Returns:
+        Parsed TOML data as a Python dictionary.
+
+    Raises:
+        TOMLDecodeError: If the content is not valid TOML.
+        ValueError: If check is invalid.
+        FileNotFoundError: If the file does not exist.
+        OSError: If the file cannot be opened or mapped.
+    """
+    if check not in ("mtime", "hash"):
+        raise ValueError(f"check must be 'mtime' or 'hash', got {check!r}")
+    path = os.fsdecode(path)
+    if snapshot is None:
+        directory, name = os.path.split(path)
+        snapshot = os.path.join(directory, f".{name}.ftsnap")
+    snapshot = os.fsdecode(snapshot)
+    st = os.stat(path)
+    data = _load_snapshot(snapshot, path, st.st_size, st.st_mtime_ns, check == "hash")
+    if data is not None:
+        return data
+    data, blob = _make_snapshot(path, st.st_size, st.st_mtime_ns)
+    if blob:
+        # Write next to the snapshot and rename, so readers never see half of one
+        tmp = f"{snapshot}.{os.getpid()}.tmp"
+        try:
+            with open(tmp, "wb") as f:
+                f.write(blob)
+            os.replace(tmp, snapshot)
+        except OSError:
+            try:
+                os.remove(tmp)
+            except OSError:
+                pass
+    return data
+
+
+def loads_many(docs: Iterable[Union[str, bytes, bytearray, memoryview]], *,
+               threads: Optional[int] = None) -> List[dict]:
+    """
+    Parse many TOML documents in parallel and return one dictionary per document.
+
+    Documents are parsed on a pool of native threads without the GIL; the
+    calling thread converts finished documents to dictionaries in input order.
+
+    Args:
+        docs: TOML documents as str or UTF-8 bytes-like objects.
+        threads: Number of worker threads (default: one per CPU).
+
+    Returns:
+        List of parsed documents, in the same order as docs.
+
+    Raises:
+        TOMLDecodeError: If any document is not valid TOML (the message names its index).
+    """
+    return _loads_many(list(docs), threads or 0)
+
+
+def load_many(paths: Iterable[Union[str, bytes, os.PathLike]], *,
+              threads: Optional[int] = None) -> List[dict]:
+    """
+    Memory-map and parse many TOML files in parallel (see loads_many()).
+
+    Args:
+        paths: File paths (str, bytes or path-like objects).
+        threads: Number of worker threads (default: one per CPU).
+
+    Returns:
+        List of parsed documents, in the same order as paths.
+
+    Raises:
+        TOMLDecodeError: If any file is not valid TOML (the message names its index).
+        FileNotFoundError: If a file does not exist.
+        OSError: If a file cannot be opened or mapped.
+    """
+    return _load_many([os.fsdecode(p) for p in paths], threads or 0)
+
+
+async def _await_batch(start, *args) -> List[dict]:
+    # The batch is parsed on native threads; the last one wakes the loop
+    # through call_soon_threadsafe, and only the dict conversion runs on it.
+    # asyncio is imported here so that "import fasttoml" does not pay for it.
+    import asyncio
+
+    loop = asyncio.get_running_loop()
+    parsed = loop.create_future()
+
+    def notify():
+        try:
+            loop.call_soon_threadsafe(_set_parsed, parsed)
+        except RuntimeError:
+            pass  # the loop was closed while parsing
+
+    batch = start(*args, notify)
     try:
-        return _loads(s)
-    except RuntimeError as e:
-        raise ValueError(str(e)) from e
+        await parsed
+    except asyncio.CancelledError:
+        batch.cancel()
+        raise
+    return batch.result()
+
+
+def _set_parsed(future: asyncio.Future) -> None:
+    if not future.done():
+        future.set_result(None)
+
+
+async def aload(path: Union[str, bytes, os.PathLike]) -> dict:
+    """
+    Memory-map and parse a TOML file on a native thread, without blocking the event loop.
+
+    The file is read and parsed without the GIL; the event loop only converts
+    the result to a dictionary once it is parsed.
+
+    Args:
+        path: File path (str, bytes or path-like object).
+
+    Returns:
+        Parsed TOML as a dictionary.
+
+    Raises:
+        TOMLDecodeError: If the file is not valid TOML.
+        FileNotFoundError: If the file does not exist.
+        OSError: If the file cannot be opened or mapped.
+    """
+    return (await _await_batch(_start_load, os.fsdecode(path)))[0]
+
+
+async def aload_many(paths: Iterable[Union[str, bytes, os.PathLike]], *,
+                     threads: Optional[int] = None) -> List[dict]:
+    """
+    Memory-map and parse many TOML files on native threads, without blocking the event loop (see aload()).
+
+    Args:
+        paths: File paths (str, bytes or path-like objects).
+        threads: Number of worker threads (default: one per CPU).
+
+    Returns:
+        List of parsed documents, in the same order as paths.
+
+    Raises:
+        TOMLDecodeError: If any file is not valid TOML (the message names its index).
+        FileNotFoundError: If a file does not exist.
+        OSError: If a file cannot be opened or mapped.
+    """
+    return await _await_batch(_start_load_many, [os.fsdecode(p) for p in paths], threads or 0)
+
+
+async def aloads_many(docs: Iterable[Union[str, bytes, bytearray, memoryview]], *,
+                      threads: Optional[int] = None) -> List[dict]:
+    """
+    Parse many TOML documents on native threads, without blocking the event loop (see aload()).
+
+    Args:
+        docs: TOML documents as str or UTF-8 bytes-like objects; they must not
+            be modified until the parse is done.
+        threads: Number of worker threads (default: one per CPU).
+
+    Returns:
+        List of parsed documents, in the same order as docs.
+
+    Raises:
+        TOMLDecodeError: If any document is not valid TOML (the message names its index).
+    """
+    return await _await_batch(_start_loads_many, list(docs), threads or 0)
+
+
+def loads_lazy(s: Union[str, bytes, bytearray, memoryview]) -> LazyTable:
+    """
+    Index a TOML document and return its root table, parsing values only when accessed.
+
+    One fast pass checks the document structure (tables, arrays of tables,
+    dotted keys) and records where each value is; a value is parsed the first
+    time it is looked up and then cached. Sub-tables are LazyTable objects too,
+    so reading a few keys of a large document costs little more than the pass.
+    The document text is kept alive by the returned table (str and bytes are
+    referenced in place, other buffers copied).
+
+    Args:
+        s: The TOML document as str or a UTF-8 bytes-like object.
+
+    Returns:
+        LazyTable: read-only mapping over the root table; to_dict() parses it all.
+
+    Raises:
+        TOMLDecodeError: If the structure is not valid TOML or the text not valid UTF-8.
+            Errors inside a value are raised when that value is accessed.
+
+    Example:
+        >>> doc = fasttoml.loads_lazy('[server]\nport = 8080\nhosts = ["a", "b"]')
+        >>> doc["server"]["port"]
+        8080
+    """
+    return _loads_lazy(s)
+
+
+def load_lazy(path: Union[str, bytes, os.PathLike]) -> LazyTable:
+    """
+    Memory-map a TOML file and index it for lazy access (see loads_lazy()).
+
+    The mapping stays open while any table of the document is referenced.
+
+    Args:
+        path: File path (str, bytes or path-like object).
+
+    Returns:
+        LazyTable: read-only mapping over the root table.
+
+    Raises:
+        TOMLDecodeError: If the structure is not valid TOML or the text not valid UTF-8.
+        FileNotFoundError: If the file does not exist.
+        OSError: If the file cannot be opened or mapped.
+    """
+    return _load_lazy(os.fspath(path))
+
+
+class Parser:
+    """
+    Parser reused for many documents.
+
+    The module-level functions set up a new native parser for every call; a
+    Parser keeps its scratch buffers and the arena of the trees parsed without
+    the GIL between calls, which matters when many small documents are parsed.
+    Results are ordinary dicts and do not depend on the parser afterwards.
+
+    A Parser may be shared between threads, but its calls are serialized; use
+    one per thread to parse in parallel.
+
+    Example:
+        >>> parser = fasttoml.Parser()
+        >>> [parser.loads(s) for s in ('a = 1', 'b = 2')]
+        [{'a': 1}, {'b': 2}]
+    """
+
+    def __init__(self) -> None:
+        self._native = _Parser()
+        self._lock = threading.Lock()
+
+    def loads(self, s: str, *, select: Optional[Iterable[str]] = None, numeric_arrays: str = "list") -> dict:
+        """Parse a TOML string, see fasttoml.loads()."""
+        numeric_buffers = _numeric_buffers(numeric_arrays)
+        with self._lock:
+            return self._native.loads(s, select, numeric_buffers)
+
+    def loads_bytes(self, b: Union[bytes, bytearray, memoryview], *,
+                    select: Optional[Iterable[str]] = None, numeric_arrays: str = "list") -> dict:
+        """Parse UTF-8 TOML from a bytes-like object, see fasttoml.loads_bytes()."""
+        numeric_buffers = _numeric_buffers(numeric_arrays)
+        with self._lock:
+            return self._native.loads_bytes(b, select, numeric_buffers)
+
+    def load_path(self, path: Union[str, bytes, os.PathLike], *,
+                  select: Optional[Iterable[str]] = None, numeric_arrays: str = "list") -> dict:
+        """Memory-map and parse a TOML file, see fasttoml.load_path()."""
+        numeric_buffers = _numeric_buffers(numeric_arrays)
+        with self._lock:
+            return self._native.load_path(os.fspath(path), select, numeric_buffers)
+
+    def load(self, fp: Union[str, os.PathLike, BinaryIO, TextIO], *,
+             select: Optional[Iterable[str]] = None, numeric_arrays: str = "list") -> dict:
+        """Parse a TOML file given by path or file-like object, see fasttoml.load()."""
+        if isinstance(fp, (str, os.PathLike)):
+            return self.load_path(fp, select=select, numeric_arrays=numeric_arrays)
+        content = fp.read()
+        if isinstance(content, (bytes, bytearray)):
+            return self.loads_bytes(content, select=select, numeric_arrays=numeric_arrays)
+        return self.loads(content, select=select, numeric_arrays=numeric_arrays)
+
+    def reset(self) -> None:
+        """Drop the state of the previous parse; its memory is kept for the next one."""
+        with self._lock:
+            self._native.reset()
+
+
+def iter_events(source: Union[str, os.PathLike, bytes, bytearray, memoryview, BinaryIO, TextIO,
+                               Iterable[Union[str, bytes]]],
+                *, chunk_size: int = 1 << 20) -> Iterator[Tuple[str, Any]]:
+    """
+    Parse a TOML document incrementally and yield (kind, payload) events.
+
+    Input is read chunk by chunk and only the statement being read is
+    buffered, so documents far larger than memory can be processed. Events:
+
+        ("table", path) / ("array_table", path)   [header] / [[header]]
+        ("key", path)                             key of the value that follows
+        ("scalar", value)                         string, number, bool or datetime
+        ("begin_array", None) / ("begin_inline_table", None) ... ("end", None)
+
+    path is a tuple of str (a dotted key has several parts). Syntax and values
+    are checked as with loads(), but nothing is kept between statements, so
+    duplicate keys and redefined tables are not reported.
+
+    Args:
+        source: File path (str or path-like), file-like object open for
+            reading, a whole document as bytes-like, or an iterable of str or
+            bytes chunks.
+        chunk_size: Bytes read at a time from paths and file-like objects.
+
+    Yields:
+        (kind, payload) tuples in document order.
+
+    Raises:
+        TOMLDecodeError: If the content is not valid TOML or not valid UTF-8.
+
+    Example:
+        >>> list(fasttoml.iter_events(iter(["[a]\nb = [1]\n"])))
+        [('table', ('a',)), ('key', ('b',)), ('begin_array', None), ('scalar', 1), ('end', None)]
+    """
+    parser = EventParser()
+    if isinstance(source, (str, os.PathLike)):
+        with open(source, "rb") as f:
+            while chunk := f.read(chunk_size):
+                yield from parser.feed(chunk)
+    elif hasattr(source, "read"):
+        while chunk := source.read(chunk_size):
+            yield from parser.feed(chunk)
+    elif isinstance(source, (bytes, bytearray, memoryview)):
+        yield from parser.feed(source)
+    else:
+        for chunk in source:
+            yield from parser.feed(chunk)
+    yield from parser.finish()
 
 
-def load(fp: Union[str, BinaryIO, TextIO]) -> dict:
+def load(fp: Union[str, os.PathLike, BinaryIO, TextIO], *,
+         select: Optional[Iterable[str]] = None, numeric_arrays: str = "list", threads: int = 1,
+         stats: bool = False, arena: Optional[bool] = None) -> Union[dict, Tuple[dict, Dict[str, int]]]:
     """
     Parse a TOML file and return a dictionary.
 
     Args:
-        fp: File path (str) or file-like object open for reading (text or binary).
+        fp: File path (str or path-like, see load_path()) or file-like object
+            open for reading (text or binary).
+        select: Optional iterable of key paths to parse, see loads().
+        numeric_arrays: "list" or "buffer", see loads().
+        threads: Threads for large documents, see loads().
+        stats: Also return a profile of the parse, see loads().
+        arena: Deprecated and ignored, see loads().
 
     Returns:
         Parsed TOML data as a Python dictionary.
 
     Raises:
-        ValueError: If the content is not valid TOML.
+        TOMLDecodeError: If the content is not valid TOML.
         FileNotFoundError: If fp is a path and the file does not exist.
         OSError: If the file cannot be read.
     """
-    if isinstance(fp, str):
+    _warn_arena(arena)
+    if isinstance(fp, (str, os.PathLike)):
         # File path provided
-        with open(fp, 'r', encoding='utf-8') as f:
-            content = f.read()
-        return loads(content)
+        return load_path(fp, select=select, numeric_arrays=numeric_arrays, threads=threads, stats=stats)
     else:
         # File-like object
         content = fp.read()
-        if isinstance(content, bytes):
-            content = content.decode('utf-8')
-        return loads(content)
+        if isinstance(content, (bytes, bytearray)):
+            return loads_bytes(content, select=select, numeric_arrays=numeric_arrays, threads=threads, stats=stats)
+        return loads(content, select=select, numeric_arrays=numeric_arrays, threads=threads, stats=stats)
+
+
+def dumps(obj: dict) -> str:
+    """
+    Serialize a Python dict to a TOML string.
+
+    The dict should have the same structure as returned by loads():
+    str, int, float, bool, datetime, list, dict. Strings that match
+    date (YYYY-MM-DD), time (HH:MM:SS), or datetime-local are emitted
+    as TOML date/time/datetime literals. Keys are sorted; plain values
+    come first, then [tables], then [[arrays of tables]].
+
+    Args:
+        obj: Root table (dict) to serialize.
+
+    Returns:
+        TOML string.
+
+    Raises:
+        TypeError: If obj is not a dict or contains unsupported types.
+    """
+    return _native_dumps(obj)
+
+
+def dump(obj: dict, fp, *, encoding: str = "utf-8") -> None:
+    """
+    Serialize a Python dict to TOML and write to a file-like object.
+
+    Args:
+        obj: Root table (dict) to serialize.
+        fp: File-like object (with .write()) or file path (str).
+        encoding: Used when fp is a file path. Default "utf-8".
+    """
+    if isinstance(fp, str):
+        if codecs.lookup(encoding).name == "utf-8":
+            # Written natively, without building a Python str
+            _dump_path(obj, fp)
+            return
+        with open(fp, "w", encoding=encoding) as f:
+            f.write(dumps(obj))
+    else:
+        fp.write(dumps(obj))
@@ -1,5 +1,8 @@
 """
-Serialize Python dict (loads() output) to TOML string.
+Pure-Python reference serializer for dicts as returned by loads().
+
+fasttoml.dumps()/dump() use the native emitter, which produces identical text;
+this module documents the format and is kept for comparison in tests.
 """
 from __future__ import annotations
 
@@ -9,7 +12,7 @@ from typing import Any
 
 
 def _is_bare_key(s: str) -> bool:
-    return bool(s) and re.match(r"^[A-Za-z0-9_-]+$", s)
+    return bool(s) and re.fullmatch(r"[A-Za-z0-9_-]+", s) is not None
 
 
 def _escape_string(s: str) -> str:
@@ -25,7 +28,7 @@ def _escape_string(s: str) -> str:
             out.append("\\r")
         elif c == "\t":
             out.append("\\t")
-        elif ord(c) < 0x20:
+        elif ord(c) < 0x20 or c == "\x7f":
             out.append(f"\\u{(ord(c)):04x}")
         else:
             out.append(c)
@@ -106,7 +109,7 @@ def _format_scalar(value: Any) -> str:
         # RFC 3339 with Z or ±HH:MM
         if value.tzinfo is None:
             value = value.replace(tzinfo=timezone.utc)
-        s = value.strftime("%Y-%m-%dT%H:%M:%S")
+        s = f"{value.year:04d}-{value.month:02d}-{value.day:02d}T{value.hour:02d}:{value.minute:02d}:{value.second:02d}"
         if value.microsecond:
             s += f".{value.microsecond:06d}".rstrip("0").rstrip(".")
         offset = value.utcoffset()
@@ -164,11 +167,11 @@ def _serialize_table_body(table: dict, path_prefix: str) -> list[str]:
     for k, v in scalars:
         lines.append(f"{_format_key(k)} = {_format_value(v, inline=True)}")
     for k, v in tables:
-        path = f"{path_prefix}.{k}" if path_prefix else k
+        path = f"{path_prefix}.{_format_key(k)}" if path_prefix else _format_key(k)
         lines.append(f"[{path}]")
         lines.extend(_serialize_table_body(v, path))
     for k, v in array_tables:
-        path = f"{path_prefix}.{k}" if path_prefix else k
+        path = f"{path_prefix}.{_format_key(k)}" if path_prefix else _format_key(k)
         for item in v:
             lines.append(f"[[{path}]]")
             lines.extend(_serialize_table_body(item, path))
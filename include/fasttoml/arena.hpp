@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fasttoml {
+
+// Monotonic per-parse arena: bump-pointer allocation from growing blocks,
+// everything released at once when the arena is destroyed, or recycled for
+// the next parse with reset().
+// Not thread-safe; one arena belongs to one parse.
+class Arena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit Arena(size_t initial_block_size = kDefaultBlockSize)
+        : next_block_size_(initial_block_size < kMinBlockSize ? kMinBlockSize : initial_block_size) {}
+
+    ~Arena() {
+        free_blocks(head_);
+        free_blocks(free_);
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t align) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(ptr_) + (align - 1)) & ~(uintptr_t(align) - 1);
+        if (ptr_ == nullptr || p + bytes > reinterpret_cast<uintptr_t>(limit_)) {
+            grow(bytes + align);
+            p = (reinterpret_cast<uintptr_t>(ptr_) + (align - 1)) & ~(uintptr_t(align) - 1);
+        }
+        ptr_ = reinterpret_cast<char*>(p + bytes);
+        bytes_used_ += bytes;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // Give memory back only if it is the most recent allocation (e.g. a vector
+    // that grew in place of its previous buffer); otherwise a no-op.
+    void deallocate(void* p, size_t bytes) {
+        if (static_cast<char*>(p) + bytes == ptr_) {
+            ptr_ = static_cast<char*>(p);
+            bytes_used_ -= bytes;
+        }
+    }
+
+    // Grow the most recent allocation p (old_bytes long) to new_bytes in
+    // place; false if p is not the most recent one or the block is full
+    bool extend(void* p, size_t old_bytes, size_t new_bytes) {
+        if (static_cast<char*>(p) + old_bytes != ptr_ || new_bytes - old_bytes > static_cast<size_t>(limit_ - ptr_)) {
+            return false;
+        }
+        ptr_ += new_bytes - old_bytes;
+        bytes_used_ += new_bytes - old_bytes;
+        return true;
+    }
+
+    // Make all memory available again, keeping the blocks for later
+    // allocations. Nothing allocated before may be used afterwards.
+    void reset() {
+        while (head_) {
+            Block* next = head_->next;
+            head_->next = free_;
+            free_ = head_;
+            head_ = next;
+        }
+        ptr_ = nullptr;
+        limit_ = nullptr;
+        bytes_used_ = 0;
+    }
+
+    // Bytes handed out to callers (excluding alignment padding and block slack)
+    size_t bytes_used() const { return bytes_used_; }
+    // Bytes reserved from the heap in blocks, and the number of blocks
+    size_t bytes_reserved() const { return bytes_reserved_; }
+    size_t blocks() const { return blocks_; }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+    static constexpr size_t kMinBlockSize = 4096;
+    static constexpr size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+    void grow(size_t min_bytes) {
+        // Reuse a block kept by reset() if one is large enough
+        for (Block** link = &free_; *link; link = &(*link)->next) {
+            if ((*link)->size >= min_bytes + sizeof(Block)) {
+                Block* b = *link;
+                *link = b->next;
+                use(b);
+                return;
+            }
+        }
+        size_t size = next_block_size_;
+        while (size < min_bytes + sizeof(Block)) size *= 2;
+        if (next_block_size_ < kMaxBlockSize) next_block_size_ *= 2;
+        Block* b = static_cast<Block*>(::operator new(size));
+        b->size = size;
+        bytes_reserved_ += size;
+        ++blocks_;
+        use(b);
+    }
+
+    void use(Block* b) {
+        b->next = head_;
+        head_ = b;
+        ptr_ = reinterpret_cast<char*>(b) + sizeof(Block);
+        limit_ = reinterpret_cast<char*>(b) + b->size;
+    }
+
+    static void free_blocks(Block* b) {
+        while (b) {
+            Block* next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
+
+    Block* head_ = nullptr;
+    Block* free_ = nullptr;  // blocks kept by reset()
+    char* ptr_ = nullptr;
+    char* limit_ = nullptr;
+    size_t next_block_size_;
+    size_t bytes_used_ = 0;
+    size_t bytes_reserved_ = 0;
+    size_t blocks_ = 0;
+};
+
+// Allocator for containers inside Table/Array. Null arena = global heap, so
+// documents built without an arena behave exactly like std::allocator.
+// Copies of a container fall back to the heap so they never outlive the arena.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(Arena* arena) noexcept : arena_(arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (arena_) return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (arena_) arena_->deallocate(p, n * sizeof(T));
+        else ::operator delete(p);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+    Arena* arena() const noexcept { return arena_; }
+
+private:
+    Arena* arena_ = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena() != b.arena();
+}
+
+// Allocator for std::allocate_shared: puts the object and its control block in
+// the arena and keeps the arena alive for as long as the object is referenced.
+template<typename T>
+class SharedArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit SharedArenaAllocator(std::shared_ptr<Arena> arena) noexcept : arena_(std::move(arena)) {}
+    template<typename U>
+    SharedArenaAllocator(const SharedArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    const std::shared_ptr<Arena>& arena() const noexcept { return arena_; }
+
+private:
+    std::shared_ptr<Arena> arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const SharedArenaAllocator<T>& a, const SharedArenaAllocator<U>& b) noexcept {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const SharedArenaAllocator<T>& a, const SharedArenaAllocator<U>& b) noexcept {
+    return a.arena() != b.arena();
+}
+
+} // namespace fasttoml
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "fasttoml/toml_parser.hpp"
+#include "fasttoml/toml_writer.hpp"
+
+namespace fasttoml {
+
+// Typed binding: TomlParser::parse_into writes a document straight into C++
+// structs, without building a Table. A struct is made bindable by
+// specializing Binding with the keys of its members:
+//
+//   struct Server {
+//       std::string host;
+//       int port = 8080;
+//       std::vector<std::string> tags;
+//   };
+//
+//   template<> struct fasttoml::Binding<Server> {
+//       static void describe(fasttoml::Fields<Server>& f) {
+//           f.required("host", &Server::host);
+//           f.optional("port", &Server::port);  // keeps 8080 if absent
+//           f.optional("tags", &Server::tags);
+//       }
+//   };
+//
+//   Server server;
+//   if (!parser.parse_into(text, server)) report(parser.get_error());
+//
+// Members may be bool, integers (range-checked), float/double (integers
+// convert), std::string (local dates and times convert to their text),
+// DateTime, DateTimeOffset, LocalDate, LocalTime, LocalDateTime, bound structs (tables),
+// and std::vector (arrays, arrays of tables) or std::optional of these.
+// Types are checked as values are stored and required keys once the document
+// is complete, all in the parse; unknown keys and duplicate keys are errors.
+template<typename T>
+struct Binding;
+
+template<typename S>
+class Fields;
+
+struct BindOptions {
+    // Skip keys (and tables) that the bound structs do not describe instead
+    // of reporting them
+    bool allow_unknown_keys = false;
+};
+
+namespace detail {
+
+// Type-erased description of a bindable type, one static instance per type
+class BoundType {
+public:
+    enum class Kind { Scalar, Struct, Array, Optional, Ignored };
+
+    explicit BoundType(Kind kind) : kind(kind) {}
+    virtual ~BoundType() = default;
+
+    // TOML type expected, for error messages
+    virtual const char* name() const = 0;
+
+    const Kind kind;
+};
+
+// TOML type of a value, for error messages ("integer", "string", ...)
+const char* toml_type_name(const TomlValue& value);
+
+class BoundScalar : public BoundType {
+public:
+    BoundScalar() : BoundType(Kind::Scalar) {}
+    // Store value in the object at obj; false with error if it does not fit
+    virtual bool assign(void* obj, const TomlValue& value, std::string& error) const = 0;
+};
+
+// std::vector of elements
+class BoundArray : public BoundType {
+public:
+    BoundArray() : BoundType(Kind::Array) {}
+    const char* name() const override { return "array"; }
+    virtual const BoundType& element() const = 0;
+    virtual void clear(void* obj) const = 0;
+    // Append a default-constructed element and return it
+    virtual void* append(void* obj) const = 0;
+    virtual size_t size(const void* obj) const = 0;
+};
+
+// std::optional of a value
+class BoundOptional : public BoundType {
+public:
+    BoundOptional() : BoundType(Kind::Optional) {}
+    const char* name() const override { return value_type().name(); }
+    virtual const BoundType& value_type() const = 0;
+    // (Re)construct the value and return it
+    virtual void* emplace(void* obj) const = 0;
+    // The value of an engaged optional
+    virtual void* value(void* obj) const = 0;
+};
+
+class MemberAccess {
+public:
+    virtual ~MemberAccess() = default;
+    virtual void* get(void* obj) const = 0;
+};
+
+// Struct described by Binding<T>::describe
+class BoundStruct : public BoundType {
+public:
+    static constexpr uint32_t kNoField = UINT32_MAX;
+
+    struct Field {
+        std::string key;
+        bool required;
+        const BoundType& (*type)();  // resolved on use, so structs can refer to themselves
+        std::unique_ptr<const MemberAccess> member;
+    };
+
+    BoundStruct() : BoundType(Kind::Struct) {}
+    const char* name() const override { return "table"; }
+
+    const std::vector<Field>& fields() const { return fields_; }
+
+    // Index of the field for key, or kNoField
+    uint32_t find(std::string_view key) const {
+        auto it = index_.find(key);
+        return it == index_.end() ? kNoField : it->second;
+    }
+
+protected:
+    void add(Field&& field) {
+        index_.insert_or_assign(field.key, static_cast<uint32_t>(fields_.size()));
+        fields_.push_back(std::move(field));
+    }
+
+private:
+    template<typename S> friend class fasttoml::Fields;
+
+    std::vector<Field> fields_;
+    TableMap<uint32_t> index_;
+};
+
+template<typename T>
+struct is_vector : std::false_type {};
+template<typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template<typename T>
+struct is_optional : std::false_type {};
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_bound_scalar = std::is_arithmetic_v<T> || std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, DateTime> || std::is_same_v<T, DateTimeOffset> ||
+                                 std::is_same_v<T, LocalDate> || std::is_same_v<T, LocalTime> ||
+                                 std::is_same_v<T, LocalDateTime>;
+
+template<typename T>
+constexpr bool is_bound_struct = std::is_class_v<T> && !is_vector<T>::value && !is_optional<T>::value &&
+                                 !is_bound_scalar<T>;
+
+template<typename T>
+const BoundType& bound_type();
+
+template<typename T>
+class ScalarOf final : public BoundScalar {
+public:
+    const char* name() const override {
+        if constexpr (std::is_same_v<T, bool>) {
+            return "boolean";
+        } else if constexpr (std::is_integral_v<T>) {
+            return "integer";
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return "float";
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return "string";
+        } else if constexpr (std::is_same_v<T, LocalDate>) {
+            return "local date";
+        } else if constexpr (std::is_same_v<T, LocalTime>) {
+            return "local time";
+        } else if constexpr (std::is_same_v<T, LocalDateTime>) {
+            return "local datetime";
+        } else {
+            return "datetime";
+        }
+    }
+
+    bool assign(void* obj, const TomlValue& value, std::string& error) const override {
+        T& out = *static_cast<T*>(obj);
+        if constexpr (std::is_same_v<T, bool>) {
+            if (const auto* b = std::get_if<Boolean>(&value)) {
+                out = *b;
+                return true;
+            }
+        } else if constexpr (std::is_integral_v<T>) {
+            if (const auto* i = std::get_if<Integer>(&value)) {
+                if (!in_range(*i)) {
+                    error = "integer " + std::to_string(*i) + " out of range";
+                    return false;
+                }
+                out = static_cast<T>(*i);
+                return true;
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            if (const auto* f = std::get_if<Float>(&value)) {
+                out = static_cast<T>(*f);
+                return true;
+            }
+            if (const auto* i = std::get_if<Integer>(&value)) {
+                out = static_cast<T>(*i);
+                return true;
+            }
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            if (const auto* str = std::get_if<String>(&value)) {
+                out = *str;
+                return true;
+            }
+            if (const auto* view = std::get_if<StringView>(&value)) {
+                out.assign(view->data(), view->size());
+                return true;
+            }
+            if (assign_local<LocalDate>(out, value) || assign_local<LocalTime>(out, value) ||
+                assign_local<LocalDateTime>(out, value)) {
+                return true;
+            }
+        } else if constexpr (std::is_same_v<T, LocalDate> || std::is_same_v<T, LocalTime> ||
+                             std::is_same_v<T, LocalDateTime>) {
+            if (const auto* local = std::get_if<T>(&value)) {
+                out = *local;
+                return true;
+            }
+        } else if constexpr (std::is_same_v<T, DateTime>) {
+            if (const auto* dt = std::get_if<DateTime>(&value)) {
+                out = *dt;
+                return true;
+            }
+            if (const auto* dt = std::get_if<DateTimeOffset>(&value)) {
+                out = dt->utc;
+                return true;
+            }
+        } else {
+            if (const auto* dt = std::get_if<DateTimeOffset>(&value)) {
+                out = *dt;
+                return true;
+            }
+            if (const auto* dt = std::get_if<DateTime>(&value)) {
+                out = DateTimeOffset{*dt, 0};
+                return true;
+            }
+        }
+        error = std::string("expected ") + name() + ", found " + toml_type_name(value);
+        return false;
+    }
+
+private:
+    template<typename Local>
+    static bool assign_local(std::string& out, const TomlValue& value) {
+        const auto* local = std::get_if<Local>(&value);
+        if (!local) return false;
+        char buf[writer::kLocalSize];
+        out.assign(buf, writer::format_local(buf, *local));
+        return true;
+    }
+
+    static bool in_range(Integer i) {
+        if constexpr (std::is_unsigned_v<T>) {
+            return i >= 0 && static_cast<uint64_t>(i) <= std::numeric_limits<T>::max();
+        } else {
+            return i >= std::numeric_limits<T>::min() && i <= std::numeric_limits<T>::max();
+        }
+    }
+};
+
+template<typename V>
+class ArrayOf final : public BoundArray {
+    static_assert(!std::is_same_v<typename V::value_type, bool>, "std::vector<bool> has no element references");
+
+public:
+    const BoundType& element() const override { return bound_type<typename V::value_type>(); }
+    void clear(void* obj) const override { static_cast<V*>(obj)->clear(); }
+    void* append(void* obj) const override { return &static_cast<V*>(obj)->emplace_back(); }
+    size_t size(const void* obj) const override { return static_cast<const V*>(obj)->size(); }
+};
+
+template<typename O>
+class OptionalOf final : public BoundOptional {
+public:
+    const BoundType& value_type() const override { return bound_type<typename O::value_type>(); }
+    void* emplace(void* obj) const override { return &static_cast<O*>(obj)->emplace(); }
+    void* value(void* obj) const override { return &**static_cast<O*>(obj); }
+};
+
+template<typename S, typename T>
+class MemberOf final : public MemberAccess {
+public:
+    explicit MemberOf(T S::*member) : member_(member) {}
+    void* get(void* obj) const override { return &(static_cast<S*>(obj)->*member_); }
+
+private:
+    T S::*member_;
+};
+
+template<typename S>
+class StructOf final : public BoundStruct {
+public:
+    StructOf() {
+        Fields<S> fields(*this);
+        Binding<S>::describe(fields);
+    }
+};
+
+template<typename T>
+const BoundType& bound_type() {
+    if constexpr (is_vector<T>::value) {
+        static const ArrayOf<T> type;
+        return type;
+    } else if constexpr (is_optional<T>::value) {
+        static const OptionalOf<T> type;
+        return type;
+    } else if constexpr (is_bound_scalar<T>) {
+        static const ScalarOf<T> type;
+        return type;
+    } else {
+        static_assert(is_bound_struct<T>, "type cannot be bound to TOML");
+        static const StructOf<T> type;
+        return type;
+    }
+}
+
+// Builder that stores values into bound structs as they are parsed (see
+// "Document builders"). The target of each value is resolved before it is
+// parsed, in select(), or is the next element of the innermost open array.
+class BindBuilder {
+public:
+    static constexpr uint32_t kNoField = BoundStruct::kNoField;
+    static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+    // Object being written: a struct (instance is its index), an array, or a
+    // value inside a struct field (instance/field) or array (index)
+    struct Ref {
+        void* obj = nullptr;
+        const BoundType* type = nullptr;
+        uint32_t instance = 0;
+        uint32_t field = kNoField;
+        uint32_t index = kNoIndex;
+        explicit operator bool() const { return type != nullptr; }
+    };
+    using TableRef = Ref;
+    using ArrayRef = Ref;
+
+    // Scalars are held until set()/append() knows their target; containers
+    // are written in place
+    struct Value {
+        TomlValue scalar;
+        bool container = false;
+    };
+
+    BindBuilder(void* root, const BoundStruct& type, const BindOptions& options);
+
+    TableRef root() { return Ref{root_, root_type_, 0}; }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array);
+    TableRef add_table(TableRef parent, const std::string& key);
+    ArrayRef add_array(TableRef parent, const std::string& key);
+    TableRef append_table(ArrayRef array);
+    size_t array_size(ArrayRef array) const;
+    TableRef last_table(ArrayRef array);
+    Value new_table(TableRef& out);
+    Value new_array(ArrayRef& out);
+    void append(ArrayRef array, Value&& value);
+    void set(TableRef t, const std::string& key, Value&& value);
+    Value scalar(TomlValue&& value) { return Value{std::move(value), false}; }
+    bool select(TableRef t, const std::vector<std::string>& path);
+
+    // After the parse: false with error if a required key is missing
+    bool finish(std::string& error) const;
+
+private:
+    // A struct being filled; state holds one entry per field: 0 = not set,
+    // 1 = set, or (tables, arrays of tables) 1 + the instance of the table
+    // or last element
+    struct Instance {
+        void* obj;
+        const BoundStruct* type;
+        uint32_t state;   // first entry in state_
+        uint32_t parent;  // instance and field (or element index) it is stored in
+        uint32_t field;
+        uint32_t index;
+    };
+
+    bool ignored(const Ref& r) const { return r.type->kind == BoundType::Kind::Ignored; }
+    uint32_t& state(uint32_t instance, uint32_t field) { return state_[instances_[instance].state + field]; }
+    const BoundStruct::Field& field_of(const Ref& t, uint32_t field) const {
+        return instances_[t.instance].type->fields()[field];
+    }
+    // Field of struct t for key; kNoField (allow_unknown_keys) or throws if unknown
+    uint32_t field_index(const Ref& t, const std::string& key) const;
+    Ref field_ref(const Ref& t, uint32_t field) const;
+    Ref element_of(const Ref& array);
+    // Construct optionals on the way to the value itself
+    static Ref unwrap(Ref r);
+    // Type below optionals, without constructing them
+    static const BoundType& peel(const BoundType& type);
+    // Start filling the struct at target
+    Ref open_struct(Ref target);
+    void assign(Ref target, const TomlValue& value);
+    // "Key 'port'" or "Element 2 of 'ports'", for errors
+    std::string context(const Ref& target) const;
+    std::string path_of(uint32_t instance) const;
+    [[noreturn]] void mismatch(const Ref& target, const char* found) const;
+    Ref take_target();
+    Ref ignored_ref() const;
+
+    void* root_;
+    const BoundStruct* root_type_;
+    BindOptions options_;
+    std::vector<Instance> instances_;
+    std::vector<uint32_t> state_;
+    // Field the parser is about to parse a value for (set by select())
+    Ref pending_;
+    // Inline tables and arrays whose values are being parsed
+    std::vector<Ref> open_;
+};
+
+} // namespace detail
+
+// Passed to Binding<S>::describe to declare the members of S
+template<typename S>
+class Fields {
+public:
+    // Key that must be present (std::optional members never are required)
+    template<typename T>
+    void required(std::string key, T S::*member) {
+        add(std::move(key), member, !detail::is_optional<T>::value);
+    }
+
+    // Key that may be absent; the member then keeps its value
+    template<typename T>
+    void optional(std::string key, T S::*member) {
+        add(std::move(key), member, false);
+    }
+
+private:
+    friend class detail::StructOf<S>;
+
+    explicit Fields(detail::BoundStruct& type) : type_(type) {}
+
+    template<typename T>
+    void add(std::string key, T S::*member, bool required) {
+        type_.add(detail::BoundStruct::Field{std::move(key), required, &detail::bound_type<T>,
+                                             std::make_unique<detail::MemberOf<S, T>>(member)});
+    }
+
+    detail::BoundStruct& type_;
+};
+
+template<typename T>
+bool TomlParser::parse_into(std::string_view input, T& out, const BindOptions& options) {
+    static_assert(detail::is_bound_struct<T>, "parse_into needs a struct described by fasttoml::Binding");
+    return parse_bound(input, &out, static_cast<const detail::BoundStruct&>(detail::bound_type<T>()), options);
+}
+
+template<typename T>
+bool TomlParser::parse_into(std::string_view input, T& out) {
+    return parse_into(input, out, BindOptions());
+}
+
+} // namespace fasttoml
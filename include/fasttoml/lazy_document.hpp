@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+
+// Document parsed on demand, created by TomlParser::parse_lazy. One structural
+// pass validates the input, resolves table headers, arrays of tables and
+// dotted keys, and records the input text of every value without parsing it;
+// a value is parsed only when asked for. Structural errors are reported by
+// parse_lazy, errors inside a value only when that value is parsed.
+class LazyDocument {
+public:
+    struct Entry {
+        enum class Kind { Value, Table, TableArray };
+        std::string_view key;   // stored in the document
+        Kind kind;
+        std::string_view text;  // Value: the unparsed value
+        uint32_t index;         // Table: table(index); TableArray: table_array(index)
+    };
+
+    struct Table {
+        std::vector<Entry> entries;  // document order
+        // key -> position in entries; only built for tables too large to scan
+        std::unordered_map<std::string_view, uint32_t> index;
+
+        const Entry* find(std::string_view key) const {
+            if (index.empty()) {
+                for (const Entry& e : entries) {
+                    if (e.key == key) return &e;
+                }
+                return nullptr;
+            }
+            auto it = index.find(key);
+            return it == index.end() ? nullptr : &entries[it->second];
+        }
+    };
+
+    const Table& root() const { return tables_.front(); }
+    const Table& table(uint32_t i) const { return tables_[i]; }
+    // Tables of an array of tables, in document order
+    const std::vector<uint32_t>& table_array(uint32_t i) const { return arrays_[i]; }
+
+    // Parse a Kind::Value entry with the given builder (see "Document builders").
+    // Returns false and sets error (and result, if given, with the position
+    // from the start of the input) if the value text is malformed.
+    template<typename Builder>
+    bool parse_value(const Entry& entry, Builder& builder, typename Builder::Value& out, std::string& error,
+                     ParseResult* result = nullptr) const {
+        TomlParser parser(options_);
+        if (parser.parse_value_text(entry.text, builder, out)) return true;
+        error = parser.has_error() ? parser.get_error() : "unknown error";
+        if (result) *result = in_input(parser.result(), entry.text);
+        return false;
+    }
+
+    // Parse a Kind::Value entry into the C++ value representation
+    bool value(const Entry& entry, TomlValue& out, std::string& error) const;
+
+    // The document text, which all entries point into
+    std::string_view input() const { return input_; }
+
+private:
+    friend class TomlParser;
+    class Builder;
+
+    LazyDocument(std::string_view input, std::shared_ptr<const void> owner, const ParseOptions& options);
+    // result of parsing text (a view into input_) with its position moved
+    // from the start of text to the start of input_
+    ParseResult in_input(ParseResult result, std::string_view text) const;
+
+    std::shared_ptr<const void> owner_;
+    std::string_view input_;
+    ParseOptions options_;
+    // Key bytes of all entries
+    Arena keys_{4096};
+    // Deques keep Table/array addresses stable while the skeleton is built
+    std::deque<Table> tables_;
+    std::deque<std::vector<uint32_t>> arrays_;
+};
+
+} // namespace fasttoml
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace fasttoml {
+
+// Read-only memory mapping of a whole file (POSIX mmap / Win32 file mapping),
+// so a file can be parsed in place without reading it into a string.
+// The mapping must outlive any StringView values parsed from it.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map path (UTF-8). On failure returns false and sets ec (errno on POSIX,
+    // GetLastError() on Windows, both in std::system_category()).
+    bool open(const std::string& path, std::error_code& ec);
+
+    std::string_view data() const { return std::string_view(data_, size_); }
+    size_t size() const { return size_; }
+
+private:
+    void close();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#else
+    // Contents of a non-regular file (pipe, device) that cannot be mapped
+    std::string buffer_;
+#endif
+};
+
+} // namespace fasttoml
@@ -0,0 +1,477 @@
+#pragma once
+
+// Builder-generic part of TomlParser: document structure, table headers,
+// dotted keys, arrays and inline tables. Included from toml_parser.hpp.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fasttoml {
+
+namespace detail {
+
+// Whether Builder has the optional deferred() hook (see "Document builders")
+template<typename Builder, typename = void>
+struct defers_values : std::false_type {};
+
+template<typename Builder>
+struct defers_values<Builder, std::void_t<decltype(std::declval<Builder&>().deferred(std::string_view()))>>
+    : std::true_type {};
+
+// Whether Builder has the optional select() hook (see "Document builders")
+template<typename Builder, typename = void>
+struct selects_values : std::false_type {};
+
+template<typename Builder>
+struct selects_values<Builder, std::void_t<decltype(std::declval<Builder&>().select(
+    std::declval<typename Builder::TableRef>(), std::declval<const std::vector<std::string>&>()))>>
+    : std::true_type {};
+
+// Whether Builder has the optional header() hook (see "Document builders")
+template<typename Builder, typename = void>
+struct observes_headers : std::false_type {};
+
+template<typename Builder>
+struct observes_headers<Builder, std::void_t<decltype(std::declval<Builder&>().header(
+    std::declval<const std::vector<std::string>&>(), false))>> : std::true_type {};
+
+// Whether Builder has the optional stats() hook (see "Document builders")
+template<typename Builder, typename = void>
+struct collects_stats : std::false_type {};
+
+template<typename Builder>
+struct collects_stats<Builder, std::void_t<decltype(std::declval<Builder&>().stats())>> : std::true_type {};
+
+// Whether Builder has the optional reserve() hook (see "Document builders")
+template<typename Builder, typename = void>
+struct reserves_arrays : std::false_type {};
+
+template<typename Builder>
+struct reserves_arrays<Builder, std::void_t<decltype(std::declval<Builder&>().reserve(
+    std::declval<typename Builder::ArrayRef>(), size_t()))>> : std::true_type {};
+
+// Monotonic clock for ParseStats, in nanoseconds
+inline uint64_t stats_clock() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace detail
+
+template<typename Builder>
+bool TomlParser::parse_with(std::string_view input, Builder& builder) {
+    [[maybe_unused]] uint64_t start = 0;
+    if constexpr (detail::collects_stats<Builder>::value) {
+        builder.stats() = ParseStats();
+        builder.stats().bytes = input.size();
+        stats_table_depth_ = stats_key_depth_ = stats_value_depth_ = 0;
+        start = detail::stats_clock();
+    }
+    bool ok = begin_parse(input);
+    if constexpr (detail::collects_stats<Builder>::value) {
+        builder.stats().validate_ns = detail::stats_clock() - start;
+    }
+    if (ok) {
+        try {
+            parse_document(builder);
+        } catch (const std::exception& e) {
+            set_error(ParseErrorCode::Builder, "{}", e.what());
+        }
+        ok = !has_error();
+    }
+    if constexpr (detail::collects_stats<Builder>::value) {
+        builder.stats().total_ns = detail::stats_clock() - start;
+    }
+    return ok;
+}
+
+template<typename Builder>
+void TomlParser::parse_document(Builder& b) {
+    typename Builder::TableRef current_table = b.root();
+    skip_whitespace();
+    while (!eof()) {
+        skip_whitespace();
+        if (eof()) break;
+        
+        if (peek() == '#') {
+            skip_comment();
+            continue;
+        }
+        
+        statement_ = current_;
+        if (peek() == '[') {
+            bool is_array_of_tables = false;
+            std::vector<std::string>& path = key_path(0);
+            if (!parse_table_header(path, is_array_of_tables)) return;
+            if constexpr (detail::observes_headers<Builder>::value) {
+                b.header(path, is_array_of_tables);
+            }
+            [[maybe_unused]] uint64_t start = 0;
+            if constexpr (detail::collects_stats<Builder>::value) {
+                ParseStats& stats = b.stats();
+                ++(is_array_of_tables ? stats.array_tables : stats.tables);
+                stats_table_depth_ = path.size();
+                stats.max_depth = std::max(stats.max_depth, path.size());
+                start = detail::stats_clock();
+            }
+            
+            if (is_array_of_tables) {
+                current_table = get_or_create_array_append_table(b, path);
+                if (!current_table) return;
+            } else {
+                current_table = get_or_create_table_at_path(b, path);
+                if (!current_table) return;
+            }
+            if constexpr (detail::collects_stats<Builder>::value) {
+                b.stats().tables_ns += detail::stats_clock() - start;
+            }
+            continue;
+        }
+        
+        // Parse key-value pair (supports dotted keys: a.b.c = value)
+        parse_key_value_pair(b, current_table);
+        if (has_error()) return;
+        // A key/value pair (with an optional comment) must end its line
+        if (!eof() && peek() != '\n' && !(peek() == '\r' && end_ - current_ >= 2 && current_[1] == '\n')) {
+            set_error(ParseErrorCode::Syntax, "Expected newline after value, found '{}'",
+                      std::string_view(current_, 1));
+            return;
+        }
+    }
+}
+
+template<typename Builder>
+void TomlParser::parse_key_value_pair(Builder& b, typename Builder::TableRef table) {
+    std::vector<std::string>& path = key_path(0);
+    parse_dotted_key(path);
+    if (path.empty() || has_error()) return;
+    skip_whitespace_no_nl();
+    expect_char('=');
+    if (has_error()) return;
+    skip_whitespace_no_nl();
+    if (!selected(b, table, path)) {
+        skip_whitespace_no_nl();
+        skip_comment();
+        return;
+    }
+    if constexpr (detail::collects_stats<Builder>::value) {
+        ++b.stats().keys;
+        stats_key_depth_ = path.size();
+    }
+    auto value = parse_entry_value(b);
+    if (has_error()) return;
+    skip_whitespace_no_nl();
+    skip_comment();
+    if constexpr (detail::collects_stats<Builder>::value) {
+        const uint64_t start = detail::stats_clock();
+        set_value_at_path(b, table, path, std::move(value));
+        b.stats().tables_ns += detail::stats_clock() - start;
+    } else {
+        set_value_at_path(b, table, path, std::move(value));
+    }
+}
+
+template<typename Builder>
+bool TomlParser::selected(Builder& b, typename Builder::TableRef table, const std::vector<std::string>& path) {
+    if constexpr (detail::selects_values<Builder>::value) {
+        if (!b.select(table, path)) {
+            skip_value();
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Builder>
+typename Builder::Value TomlParser::parse_entry_value(Builder& b) {
+    if constexpr (detail::defers_values<Builder>::value) {
+        return b.deferred(skip_value());
+    } else {
+        return parse_value(b);
+    }
+}
+
+template<typename Builder>
+bool TomlParser::parse_value_text(std::string_view text, Builder& b, typename Builder::Value& out) {
+    set_input(text);
+    try {
+        out = parse_value(b);
+    } catch (const std::exception& e) {
+        set_error(ParseErrorCode::Builder, "{}", e.what());
+        return false;
+    }
+    skip_whitespace_no_nl();
+    if (!has_error() && !eof()) {
+        set_error(ParseErrorCode::Syntax, "Unexpected text after value: {}",
+                  std::string_view(current_, static_cast<size_t>(end_ - current_)));
+    }
+    return !has_error();
+}
+
+template<typename Builder>
+typename Builder::TableRef TomlParser::get_or_create_table_at_path(Builder& b, const std::vector<std::string>& path) {
+    typename Builder::TableRef t = b.root();
+    uint32_t node = HeaderTrie::kRoot;
+    for (size_t i = 0; i < path.size(); ++i) {
+        const std::string& key = path[i];
+        node = header_paths_.find(node, key);
+        typename Builder::TableRef child{};
+        typename Builder::ArrayRef arr{};
+        switch (b.find(t, key, child, arr)) {
+            case NodeKind::Table:
+                t = child;
+                break;
+            case NodeKind::Array: {
+                // [arr.subtab] only when arr is array-of-tables (from [[arr]]). Static array (a = [...]) cannot be extended.
+                if (!header_paths_.is_array_of_tables(node)) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict,
+                                 "Cannot extend static array with table header");
+                    return {};
+                }
+                if (b.array_size(arr) == 0) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict, "Array of tables is empty");
+                    return {};
+                }
+                t = b.last_table(arr);
+                if (!t) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-table", key);
+                    return {};
+                }
+                break;
+            }
+            case NodeKind::Other:
+                set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-table", key);
+                return {};
+            case NodeKind::Missing:
+                t = b.add_table(t, key);
+                break;
+        }
+    }
+    return t;
+}
+
+template<typename Builder>
+typename Builder::TableRef TomlParser::get_or_create_array_append_table(Builder& b, const std::vector<std::string>& path) {
+    if (path.empty()) {
+        set_error(ParseErrorCode::Syntax, "Empty array of tables path");
+        return {};
+    }
+    typename Builder::TableRef t = b.root();
+    uint32_t node = HeaderTrie::kRoot;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const std::string& key = path[i];
+        node = header_paths_.insert(node, key);
+        typename Builder::TableRef child{};
+        typename Builder::ArrayRef arr{};
+        switch (b.find(t, key, child, arr)) {
+            case NodeKind::Table:
+                t = child;
+                break;
+            case NodeKind::Array: {
+                if (!header_paths_.is_array_of_tables(node)) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-table", key);
+                    return {};
+                }
+                if (b.array_size(arr) == 0) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict, "Array of tables is empty");
+                    return {};
+                }
+                t = b.last_table(arr);
+                if (!t) {
+                    set_error_at(statement_, ParseErrorCode::KeyConflict,
+                                 "Key '{}' already defined as non-array-of-tables", key);
+                    return {};
+                }
+                break;
+            }
+            case NodeKind::Other:
+                set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-table", key);
+                return {};
+            case NodeKind::Missing:
+                t = b.add_table(t, key);
+                break;
+        }
+    }
+    const std::string& last_key = path.back();
+    typename Builder::TableRef child{};
+    typename Builder::ArrayRef arr{};
+    NodeKind kind = b.find(t, last_key, child, arr);
+    node = header_paths_.insert(node, last_key);
+    if (kind == NodeKind::Missing) {
+        header_paths_.mark_array_of_tables(node);
+        return b.append_table(b.add_array(t, last_key));
+    }
+    if (kind != NodeKind::Array) {
+        set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-array", last_key);
+        return {};
+    }
+    // [[key]] only allowed if key was created by a previous [[key]] (array-of-tables), not by key = [] (static array).
+    // Such an array only ever receives tables, so checking the last element keeps repeated headers O(1).
+    if (!header_paths_.is_array_of_tables(node) || (b.array_size(arr) != 0 && !b.last_table(arr))) {
+        set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-array-of-tables",
+                     last_key);
+        return {};
+    }
+    return b.append_table(arr);
+}
+
+template<typename Builder>
+void TomlParser::set_value_at_path(Builder& b, typename Builder::TableRef table, const std::vector<std::string>& path,
+                                   typename Builder::Value&& value) {
+    if (path.empty()) return;
+    typename Builder::TableRef t = table;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const std::string& key = path[i];
+        typename Builder::TableRef child{};
+        typename Builder::ArrayRef arr{};
+        switch (b.find(t, key, child, arr)) {
+            case NodeKind::Table:
+                t = child;
+                break;
+            case NodeKind::Missing:
+                t = b.add_table(t, key);
+                break;
+            default:
+                set_error_at(statement_, ParseErrorCode::KeyConflict, "Key '{}' already defined as non-table", key);
+                return;
+        }
+    }
+    b.set(t, path.back(), std::move(value));
+}
+
+template<typename Builder>
+typename Builder::Value TomlParser::parse_value(Builder& b) {
+    skip_whitespace_no_nl();
+    char c = peek();
+    if constexpr (detail::collects_stats<Builder>::value) {
+        ParseStats& stats = b.stats();
+        stats.max_depth = std::max(stats.max_depth, stats_table_depth_ + stats_key_depth_ + stats_value_depth_);
+        if (c == '[') {
+            ++stats.arrays;
+            ++stats_value_depth_;
+            auto result = parse_array(b);
+            --stats_value_depth_;
+            return result;
+        }
+        if (c == '{') {
+            ++stats.inline_tables;
+            return parse_inline_table(b);
+        }
+        return b.scalar(parse_scalar_profiled(stats));
+    }
+    if (c == '[') {
+        return parse_array(b);
+    }
+    if (c == '{') {
+        return parse_inline_table(b);
+    }
+    return b.scalar(parse_scalar());
+}
+
+template<typename Builder>
+typename Builder::Value TomlParser::parse_inline_table(Builder& b) {
+    expect_char('{');
+    skip_whitespace_no_nl();
+    typename Builder::TableRef table{};
+    auto result = b.new_table(table);
+    if (peek() == '}') {
+        advance();
+        return result;
+    }
+    // Values of inline tables can hold inline tables, each level with its own path
+    std::vector<std::string>& path = key_path(++inline_depth_);
+    while (!eof()) {
+        parse_dotted_key(path);
+        if (path.empty() || has_error()) break;
+        skip_whitespace_no_nl();
+        expect_char('=');
+        if (has_error()) break;
+        skip_whitespace_no_nl();
+        if (selected(b, table, path)) {
+            if constexpr (detail::collects_stats<Builder>::value) {
+                // Keys of an inline table nest its values one level per key
+                stats_value_depth_ += path.size();
+                auto value = parse_value(b);
+                stats_value_depth_ -= path.size();
+                if (has_error()) break;
+                const uint64_t start = detail::stats_clock();
+                set_value_at_path(b, table, path, std::move(value));
+                b.stats().tables_ns += detail::stats_clock() - start;
+            } else {
+                auto value = parse_value(b);
+                if (has_error()) break;
+                set_value_at_path(b, table, path, std::move(value));
+            }
+        }
+        skip_whitespace_no_nl();
+        if (peek() == '}') break;
+        expect_char(',');
+        if (has_error()) break;
+        skip_whitespace_no_nl();
+    }
+    --inline_depth_;
+    expect_char('}');
+    return result;
+}
+
+template<typename Builder>
+typename Builder::Value TomlParser::parse_array(Builder& b) {
+    expect_char('[');
+    skip_whitespace();
+    skip_comment();
+    
+    typename Builder::ArrayRef array{};
+    auto result = b.new_array(array);
+    
+    if (peek() == ']') {
+        advance();
+        return result;
+    }
+
+    size_t expected = 0;
+    if constexpr (detail::reserves_arrays<Builder>::value) expected = count_array_elements();
+    
+    while (!eof()) {
+        for (;;) {
+            skip_whitespace();
+            if (peek() == ']') goto end_array_loop;
+            if (peek() == '#') { skip_comment(); continue; }
+            break;
+        }
+        
+        auto value = parse_value(b);
+        if (has_error()) return result;
+        b.append(array, std::move(value));
+        if constexpr (detail::reserves_arrays<Builder>::value) {
+            if (expected > 1) {
+                b.reserve(array, expected);
+                expected = 0;
+            }
+        }
+        
+        skip_whitespace();
+        skip_comment();
+        skip_whitespace();
+        if (peek() == ',') {
+            advance();
+            skip_whitespace();
+            skip_comment();
+        } else if (peek() != ']') {
+            set_error(ParseErrorCode::Syntax, "Expected ',' or ']' in array");
+            break;
+        }
+    }
+end_array_loop:
+    expect_char(']');
+    return result;
+}
+
+} // namespace fasttoml
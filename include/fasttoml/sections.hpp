@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+namespace detail {
+
+// Tables a section's key/value lines created implicitly (the a in a.b = 1),
+// by parent and key. They are kept alive so that a table replaced later in
+// the section is never mistaken for a new one at the same address.
+using ImplicitTables = std::unordered_map<const Table*, TableMap<TablePtr>>;
+
+// One top-level section of a document (TomlParser::index_sections): the text
+// before the first header, or a header and the lines up to the next one
+struct Section {
+    Section(const char* b, const char* e, bool header) : begin(b), end(e), has_header(header) {}
+
+    const char* begin;
+    const char* end;
+    bool has_header;
+    // Filled in by TomlParser::parse_section
+    std::vector<std::string> path;
+    bool array_of_tables = false;
+    TablePtr body;
+    ImplicitTables implicit;
+};
+
+} // namespace detail
+} // namespace fasttoml
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+
+// Key paths to keep when parsing, for TomlParser::parse_selected. A path is a
+// dotted TOML key ("database.pool.size", 'deps."serde-json".version'); "[*]"
+// after a key ("servers[*].host") marks that it holds an array and the rest of
+// the path applies to each of its tables. Arrays are looked through either
+// way, so "servers.host" selects the same values. A path selects the whole
+// subtree below its last key; a table, array or value on the way is kept too
+// if the path cannot continue into it.
+class Selection {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kRoot = 0;
+
+    Selection() : nodes_(1) {}
+
+    // Add a path; returns false and sets error if it is not a valid key path
+    bool add(std::string_view path, std::string& error);
+
+    // Node for key below node: the node itself if it selects its whole
+    // subtree, kNone if node is kNone or key is not selected
+    uint32_t child(uint32_t node, const std::string& key) const {
+        if (node == kNone) return kNone;
+        const Node& n = nodes_[node];
+        if (n.all) return node;
+        auto it = n.children.find(key);
+        return it == n.children.end() ? kNone : it->second;
+    }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, uint32_t> children;
+        bool all = false;
+    };
+    std::vector<Node> nodes_;
+};
+
+// Builder adapter that forwards only the selected part of a document to Inner
+// (any builder, see "Document builders"). Tables outside the selection are
+// handed to the parser as placeholders that build nothing, and values outside
+// it are skipped by the parser (select() hook) without being parsed. The
+// document's syntax (strings, brackets, headers, line structure) is still
+// checked everywhere, but malformed scalars and key conflicts outside the
+// selection are not reported.
+template<typename Inner>
+class SelectBuilder {
+public:
+    using Value = typename Inner::Value;
+
+    struct TableRef {
+        typename Inner::TableRef ref{};
+        uint32_t node = Selection::kNone;  // kNone: placeholder outside the selection
+        bool valid = false;
+        explicit operator bool() const { return valid; }
+    };
+
+    struct ArrayRef {
+        typename Inner::ArrayRef ref{};
+        uint32_t node = Selection::kNone;
+    };
+
+    SelectBuilder(Inner& inner, const Selection& selection) : inner_(inner), selection_(selection) {}
+
+    TableRef root() { return TableRef{inner_.root(), Selection::kRoot, true}; }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+        const uint32_t node = selection_.child(t.node, key);
+        // Keys outside the selection are never built
+        if (node == Selection::kNone) return NodeKind::Missing;
+        typename Inner::TableRef inner_table{};
+        typename Inner::ArrayRef inner_array{};
+        const NodeKind kind = inner_.find(t.ref, key, inner_table, inner_array);
+        table = TableRef{inner_table, node, kind == NodeKind::Table};
+        array = ArrayRef{inner_array, node};
+        return kind;
+    }
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        const uint32_t node = selection_.child(parent.node, key);
+        if (node == Selection::kNone) return placeholder();
+        return TableRef{inner_.add_table(parent.ref, key), node, true};
+    }
+
+    ArrayRef add_array(TableRef parent, const std::string& key) {
+        const uint32_t node = selection_.child(parent.node, key);
+        if (node == Selection::kNone) return ArrayRef{};
+        return ArrayRef{inner_.add_array(parent.ref, key), node};
+    }
+
+    // Elements of a selected array share its selection node
+    TableRef append_table(ArrayRef array) {
+        if (array.node == Selection::kNone) return placeholder();
+        return TableRef{inner_.append_table(array.ref), array.node, true};
+    }
+
+    // find() never returns a placeholder array, so the parser only asks about real ones
+    size_t array_size(ArrayRef array) const {
+        return array.node == Selection::kNone ? 0 : inner_.array_size(array.ref);
+    }
+
+    TableRef last_table(ArrayRef array) const {
+        if (array.node == Selection::kNone) return placeholder();
+        typename Inner::TableRef last = inner_.last_table(array.ref);
+        return TableRef{last, array.node, static_cast<bool>(last)};
+    }
+
+    // Inline tables and arrays take the node of the value being parsed
+    Value new_table(TableRef& out) {
+        typename Inner::TableRef ref{};
+        Value value = inner_.new_table(ref);
+        out = TableRef{ref, pending_, true};
+        return value;
+    }
+
+    Value new_array(ArrayRef& out) {
+        typename Inner::ArrayRef ref{};
+        Value value = inner_.new_array(ref);
+        out = ArrayRef{ref, pending_};
+        return value;
+    }
+
+    void append(ArrayRef array, Value&& value) {
+        inner_.append(array.ref, std::move(value));
+        // The next element is below the array again
+        pending_ = array.node;
+    }
+
+    void set(TableRef t, const std::string& key, Value&& value) { inner_.set(t.ref, key, std::move(value)); }
+
+    Value scalar(TomlValue&& value) { return inner_.scalar(std::move(value)); }
+
+    bool select(TableRef t, const std::vector<std::string>& path) {
+        uint32_t node = t.node;
+        for (const std::string& key : path) {
+            node = selection_.child(node, key);
+            if (node == Selection::kNone) return false;
+        }
+        pending_ = node;
+        return true;
+    }
+
+private:
+    static TableRef placeholder() { return TableRef{{}, Selection::kNone, true}; }
+
+    Inner& inner_;
+    const Selection& selection_;
+    // Selection node of the value the parser is about to build
+    uint32_t pending_ = Selection::kNone;
+};
+
+} // namespace fasttoml
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+
+// Binary snapshot of a parsed document, to load a config again without
+// parsing it. Values are 16-byte records, and tables and arrays are blocks
+// of them at 8-byte aligned offsets, so a snapshot (e.g. a MappedFile) is
+// read in place: find() and at() follow offsets and only touch the pages
+// they need. Numbers are in the byte order of the machine that wrote the
+// snapshot; other machines' Snapshot::open rejects it. Offsets are checked
+// when they are followed, so a damaged snapshot throws std::out_of_range
+// instead of reading outside its data; Snapshot::verify also catches damage
+// that the checks cannot (e.g. a changed number or string). Packed arrays
+// are read as Integer and Float arrays in place, so data should be 8-byte
+// aligned (a MappedFile is).
+
+// The text a snapshot was made from, recorded in its header
+struct SnapshotSource {
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;  // as the caller measures it; not interpreted
+    uint64_t hash = 0;     // snapshot_hash of the text
+};
+
+// 64-bit hash of text (not cryptographic), 8 bytes per step
+uint64_t snapshot_hash(std::string_view text);
+
+// Serialize root; throws std::length_error past 4 GiB
+std::string write_snapshot(const Table& root, const SnapshotSource& source);
+
+class SnapshotTable;
+class SnapshotArray;
+
+// One value of a snapshot
+class SnapshotValue {
+public:
+    enum class Type : uint8_t { Integer, Float, Boolean, String, DateTime, DateTimeOffset, Table, Array,
+                              LocalDate, LocalTime, LocalDateTime };
+
+    Type type() const { return type_; }
+    // Accessors for the value's type (type() says which applies)
+    Integer as_integer() const;
+    Float as_float() const;
+    Boolean as_boolean() const;
+    std::string_view as_string() const;  // points into the snapshot
+    DateTime as_datetime() const;
+    DateTimeOffset as_datetime_offset() const;
+    LocalDate as_local_date() const;
+    LocalTime as_local_time() const;
+    LocalDateTime as_local_datetime() const;
+    SnapshotTable as_table() const;
+    SnapshotArray as_array() const;
+
+    // Copy into a TomlValue; strings become StringViews into the snapshot
+    TomlValue to_value() const;
+
+private:
+    friend class Snapshot;
+    friend class SnapshotTable;
+    friend class SnapshotArray;
+
+    SnapshotValue(std::string_view data, size_t origin, Type type, uint32_t a, uint64_t b)
+        : data_(data), origin_(origin), type_(type), a_(a), b_(b) {}
+    // Decode the record at offset
+    static SnapshotValue record(std::string_view data, size_t offset);
+
+    std::string_view data_;
+    size_t origin_;  // where the value is stored; blocks it refers to come after it
+    Type type_;
+    uint32_t a_;
+    uint64_t b_;
+};
+
+// A table of a snapshot, entries in document order
+class SnapshotTable {
+public:
+    size_t size() const { return size_; }
+    std::string_view key(size_t i) const;
+    SnapshotValue value(size_t i) const;
+    // Entry i of key, or size() if absent (binary search on larger tables)
+    size_t find(std::string_view key) const;
+
+    // Copy into a Table (see SnapshotValue::to_value)
+    TablePtr to_table() const;
+
+private:
+    friend class SnapshotValue;
+    friend class Snapshot;
+    SnapshotTable(std::string_view data, size_t offset);
+
+    std::string_view data_;
+    size_t offset_;
+    size_t size_;
+};
+
+// An array of a snapshot; all-integer and all-float arrays stay packed
+class SnapshotArray {
+public:
+    size_t size() const { return size_; }
+    Array::Storage storage() const { return storage_; }
+    SnapshotValue at(size_t i) const;
+    // Elements of a packed array (storage() Integers or Floats)
+    const Integer* integers() const;
+    const Float* floats() const;
+
+    ArrayPtr to_array() const;
+
+private:
+    friend class SnapshotValue;
+    SnapshotArray(std::string_view data, size_t offset, Array::Storage storage);
+
+    std::string_view data_;
+    size_t offset_;
+    size_t size_;
+    Array::Storage storage_;
+};
+
+// A snapshot held in memory, e.g. a MappedFile's data
+class Snapshot {
+public:
+    // False if data is not a snapshot this build can read (magic, version,
+    // byte order, size). data must outlive the snapshot and its values.
+    bool open(std::string_view data);
+
+    // Whether the snapshot matches the hash in its header, which covers
+    // everything after it: header fields, root record and body (reads all of it)
+    bool verify() const;
+
+    const SnapshotSource& source() const { return source_; }
+    SnapshotTable root() const;
+
+private:
+    std::string_view data_;
+    SnapshotSource source_;
+};
+
+} // namespace fasttoml
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+
+// Event produced by StreamParser. A Table or ArrayTable header starts a
+// section that lasts until the next header. Each Key (a dotted key is one
+// path) is followed by exactly one value: a Scalar, or BeginArray /
+// BeginInlineTable, the elements or keys inside it, and the matching End.
+struct Event {
+    enum class Type { Table, ArrayTable, Key, Scalar, BeginArray, BeginInlineTable, End };
+    Type type;
+    std::vector<std::string> path;  // Table, ArrayTable, Key
+    TomlValue value;                // Scalar
+};
+
+// Incremental parser for documents that arrive in chunks. Input is buffered
+// only until the statement it belongs to is complete (a key/value pair,
+// header or comment line, including multiline strings and arrays), then
+// parsed into events and dropped, so memory is bounded by the largest single
+// statement rather than by the document. Syntax and values are checked as
+// with TomlParser; nothing is kept across statements, so redefined keys and
+// tables are not detected. Strings are always copied (ParseOptions::string_views
+// is ignored).
+class StreamParser {
+public:
+    explicit StreamParser(const ParseOptions& options = ParseOptions());
+
+    // Append input; events of the statements it completes are queued.
+    // Returns false on error; the parser then rejects further input.
+    bool feed(const char* data, size_t size);
+    bool feed(std::string_view data) { return feed(data.data(), data.size()); }
+
+    // End of input: parse the remaining statement. Returns false on error.
+    bool finish();
+
+    // Pop the next queued event; false if there is none (yet)
+    bool next(Event& event);
+
+    std::string get_error() const { return error_message_; }
+    bool has_error() const { return !error_message_.empty(); }
+    // Code and position of the error, from the start of all input fed (the
+    // code is None for input fed after finish())
+    const ParseResult& result() const { return result_; }
+    bool finished() const { return finished_; }
+    // Input not parsed yet: the statement being read, or the one that failed
+    std::string_view buffered() const { return buffer_; }
+    // Bytes of input parsed and dropped so far
+    size_t consumed() const { return consumed_; }
+
+private:
+    class Builder;
+
+    // Where the scanner is: outside strings, or inside a comment or string
+    enum class Mode { Value, Comment, Basic, Literal, MultilineBasic, MultilineLiteral };
+
+    // Advance the scanner over buffered input, updating complete_
+    void scan();
+    // Parse buffer_[0, end) and drop it from the buffer
+    bool parse_buffered(size_t end);
+
+    TomlParser parser_;
+    // Input not parsed yet
+    std::string buffer_;
+    size_t scan_ = 0;      // scanner position in buffer_
+    size_t complete_ = 0;  // buffer_[0, complete_) holds only complete statements
+    int depth_ = 0;        // open arrays and inline tables at scan_
+    Mode mode_ = Mode::Value;
+    bool finished_ = false;
+    size_t consumed_ = 0;
+    size_t consumed_lines_ = 0;  // newlines in the consumed input
+    std::deque<Event> events_;
+    std::string error_message_;
+    ParseResult result_;
+};
+
+} // namespace fasttoml
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include "fasttoml/arena.hpp"
+
+namespace fasttoml {
+
+// Insertion-ordered string-keyed map for TOML tables: entries are stored
+// contiguously as (key, value) pairs in the order they were first inserted.
+// Small tables (most of them) are searched linearly; above kLinearMax entries
+// an open-addressing index of entry positions and hashes is built next to
+// them. In an arena the entry buffer grows in place while it is the arena's
+// latest allocation, as it is while a table of scalars is being parsed.
+// Unlike std::unordered_map, inserting may move existing entries, so
+// references and iterators are invalidated by insertion and erasure.
+template<typename T>
+class TableMap {
+public:
+    using key_type = std::string;
+    using mapped_type = T;
+    using value_type = std::pair<std::string, T>;  // keys must not be modified in place
+    using allocator_type = ArenaAllocator<value_type>;
+    using size_type = size_t;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    static constexpr size_t kLinearMax = 16;
+
+    TableMap() = default;
+    // Entry and index storage come from the allocator's arena (nullptr = heap)
+    explicit TableMap(const allocator_type& alloc) : alloc_(alloc) {}
+
+    // Copies live on the heap, like copies of other arena containers
+    TableMap(const TableMap& other) {
+        reserve(other.size_);
+        for (const value_type& entry : other) try_emplace(entry.first, entry.second);
+    }
+
+    TableMap(TableMap&& other) noexcept
+        : alloc_(other.alloc_), data_(other.data_), size_(other.size_), capacity_(other.capacity_),
+          slots_(other.slots_), slot_count_(other.slot_count_) {
+        other.data_ = nullptr;
+        other.slots_ = nullptr;
+        other.size_ = other.capacity_ = other.slot_count_ = 0;
+    }
+
+    TableMap& operator=(const TableMap& other) {
+        if (this != &other) {
+            TableMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    TableMap& operator=(TableMap&& other) noexcept {
+        TableMap moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    ~TableMap() { release(); }
+
+    void swap(TableMap& other) noexcept {
+        std::swap(alloc_, other.alloc_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(slots_, other.slots_);
+        std::swap(slot_count_, other.slot_count_);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    iterator find(std::string_view key) { return data_ + position(key); }
+    const_iterator find(std::string_view key) const { return data_ + position(key); }
+
+    size_t count(std::string_view key) const { return position(key) == size_ ? 0 : 1; }
+    bool contains(std::string_view key) const { return count(key) != 0; }
+
+    T& at(std::string_view key) {
+        const size_t i = position(key);
+        if (i == size_) throw std::out_of_range("TableMap::at: key not found");
+        return data_[i].second;
+    }
+
+    const T& at(std::string_view key) const {
+        const size_t i = position(key);
+        if (i == size_) throw std::out_of_range("TableMap::at: key not found");
+        return data_[i].second;
+    }
+
+    T& operator[](const std::string& key) { return try_emplace(key).first->second; }
+    T& operator[](std::string&& key) { return try_emplace(std::move(key)).first->second; }
+
+    // Insert key with value built from args unless key is present
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        // Keys of small tables are never hashed
+        const size_t hash = slots_ ? hash_of(key) : 0;
+        const size_t i = slots_ ? position(key, hash) : scan(key);
+        if (i != size_) return {data_ + i, false};
+        if (size_ == capacity_) grow(capacity_ ? 2 * capacity_ : kInitialCapacity);
+        ::new (static_cast<void*>(data_ + size_)) value_type(
+            std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        ++size_;
+        index_last(hash);
+        return {data_ + size_ - 1, true};
+    }
+
+    template<typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+        auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        if (!result.second) result.first->second = std::forward<V>(value);
+        return result;
+    }
+
+    // Remove key, shifting later entries down; returns the number removed
+    size_t erase(std::string_view key) {
+        const size_t i = position(key);
+        if (i == size_) return 0;
+        std::move(data_ + i + 1, data_ + size_, data_ + i);
+        data_[--size_].~value_type();
+        rebuild_index(0, i);
+        return 1;
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity_) grow(n);
+        if (n > kLinearMax && slot_count_ < slot_count(n)) rebuild_index(n);
+    }
+
+    void clear() {
+        std::destroy(data_, data_ + size_);
+        size_ = 0;
+        release_index();
+    }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+private:
+    static constexpr size_t kInitialCapacity = 4;
+
+    // Index slot: entry position + 1 (0 = empty) and the low bits of its hash
+    struct Slot {
+        uint32_t entry;
+        uint32_t hash;
+    };
+    using SlotAllocator = ArenaAllocator<Slot>;
+
+    static size_t hash_of(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+    // Power of two with room for n entries at load factor <= 1/2
+    static size_t slot_count(size_t n) {
+        size_t count = 64;
+        while (count < 2 * n) count *= 2;
+        return count;
+    }
+
+    void grow(size_t capacity) {
+        Arena* arena = alloc_.arena();
+        if (arena && data_ && arena->extend(data_, capacity_ * sizeof(value_type), capacity * sizeof(value_type))) {
+            capacity_ = capacity;
+            return;
+        }
+        value_type* data = alloc_.allocate(capacity);
+        for (size_t i = 0; i < size_; ++i) {
+            ::new (static_cast<void*>(data + i)) value_type(std::move(data_[i]));
+            data_[i].~value_type();
+        }
+        if (data_) alloc_.deallocate(data_, capacity_);
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void release() {
+        std::destroy(data_, data_ + size_);
+        if (data_) alloc_.deallocate(data_, capacity_);
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+        release_index();
+    }
+
+    void release_index() {
+        if (slots_) SlotAllocator(alloc_).deallocate(slots_, slot_count_);
+        slots_ = nullptr;
+        slot_count_ = 0;
+    }
+
+    size_t position(std::string_view key) const {
+        return slots_ ? position(key, hash_of(key)) : scan(key);
+    }
+
+    // Position of key through the index, or size() if absent
+    size_t position(std::string_view key, size_t hash) const {
+        const size_t mask = slot_count_ - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots_[i];
+            if (slot.entry == 0) return size_;
+            if (slot.hash == static_cast<uint32_t>(hash) && data_[slot.entry - 1].first == key) {
+                return slot.entry - 1;
+            }
+        }
+    }
+
+    size_t scan(std::string_view key) const {
+        for (size_t i = 0; i < size_; ++i) {
+            if (std::string_view(data_[i].first) == key) return i;
+        }
+        return size_;
+    }
+
+    // Index the entry just appended (hash is its key's if the index exists),
+    // building the index once the table outgrows linear search
+    void index_last(size_t hash) {
+        if (!slots_) {
+            if (size_ > kLinearMax) rebuild_index(size_);
+            return;
+        }
+        // A larger index is rebuilt from the old one, which lacks the new entry
+        if (2 * size_ > slot_count_) rebuild_index(size_);
+        insert_slot(size_ - 1, hash);
+    }
+
+    // Index for capacity entries. The hashes kept in the old index are reused
+    // (slot counts stay below 2^32, so its low bits place a key as well as the
+    // full hash), so a growing table hashes each key once; removed is the
+    // position of an entry just erased, whose successors have moved down.
+    void rebuild_index(size_t capacity = 0, size_t removed = SIZE_MAX) {
+        if (capacity < size_) capacity = size_;
+        Slot* old = slots_;
+        const size_t old_count = slot_count_;
+        slots_ = nullptr;
+        slot_count_ = 0;
+        if (capacity > kLinearMax) {
+            slot_count_ = slot_count(capacity);
+            slots_ = SlotAllocator(alloc_).allocate(slot_count_);
+            std::fill(slots_, slots_ + slot_count_, Slot{0, 0});
+            if (old) {
+                for (size_t j = 0; j < old_count; ++j) {
+                    if (old[j].entry == 0 || old[j].entry - 1 == removed) continue;
+                    const size_t entry = old[j].entry - 1;
+                    insert_slot(entry > removed ? entry - 1 : entry, old[j].hash);
+                }
+            } else {
+                for (size_t i = 0; i < size_; ++i) insert_slot(i, hash_of(data_[i].first));
+            }
+        }
+        if (old) SlotAllocator(alloc_).deallocate(old, old_count);
+    }
+
+    void insert_slot(size_t entry, size_t hash) {
+        const size_t mask = slot_count_ - 1;
+        size_t i = hash & mask;
+        while (slots_[i].entry != 0) i = (i + 1) & mask;
+        slots_[i] = Slot{static_cast<uint32_t>(entry + 1), static_cast<uint32_t>(hash)};
+    }
+
+    allocator_type alloc_;
+    value_type* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    Slot* slots_ = nullptr;  // nullptr while searched linearly
+    size_t slot_count_ = 0;
+};
+
+} // namespace fasttoml
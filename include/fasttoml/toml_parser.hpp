@@ -1,6 +1,8 @@
 #pragma once
 
+#include <deque>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 #include <unordered_map>
@@ -8,7 +10,8 @@
 #include <optional>
 #include <cstdint>
 #include <chrono>
-#include <set>
+#include "fasttoml/arena.hpp"
+#include "fasttoml/table_map.hpp"
 
 namespace fasttoml {
 
@@ -22,12 +25,41 @@ using Integer = int64_t;
 using Float = double;
 using Boolean = bool;
 using String = std::string;
+// Non-owning string pointing into the parser input (ParseOptions::string_views)
+using StringView = std::string_view;
 using DateTime = std::chrono::system_clock::time_point;
 // Datetime with timezone offset (for correct RFC 3339 output in tagged JSON)
 struct DateTimeOffset {
     DateTime utc;
     int offset_minutes;
 };
+// Local (offset-less) date, time of day and datetime, as written
+struct LocalDate {
+    int year;   // 0-9999
+    int month;  // 1-12
+    int day;    // 1-31, valid for the month
+};
+struct LocalTime {
+    int hour;        // 0-23
+    int minute;      // 0-59
+    int second;      // 0-60
+    int nanosecond;  // first 9 digits of the fraction; later ones are dropped
+    int precision;   // digits of the fraction written (0-9)
+};
+struct LocalDateTime {
+    LocalDate date;
+    LocalTime time;
+};
+inline bool operator==(const LocalDate& a, const LocalDate& b) {
+    return a.year == b.year && a.month == b.month && a.day == b.day;
+}
+inline bool operator==(const LocalTime& a, const LocalTime& b) {
+    return a.hour == b.hour && a.minute == b.minute && a.second == b.second && a.nanosecond == b.nanosecond &&
+           a.precision == b.precision;
+}
+inline bool operator==(const LocalDateTime& a, const LocalDateTime& b) {
+    return a.date == b.date && a.time == b.time;
+}
 using TablePtr = std::shared_ptr<Table>;
 using ArrayPtr = std::shared_ptr<Array>;
 
@@ -40,13 +72,22 @@ using TomlValue = std::variant<
     DateTime,
     DateTimeOffset,
     TablePtr,
-    ArrayPtr
+    ArrayPtr,
+    StringView,
+    LocalDate,
+    LocalTime,
+    LocalDateTime
 >;
 
-// TOML Table (key-value pairs)
+// TOML Table (key-value pairs, in document order)
 class Table {
 public:
-    std::unordered_map<std::string, TomlValue> values;
+    using Map = TableMap<TomlValue>;
+    Map values;
+
+    Table() = default;
+    // Map nodes and buckets come from arena (nullptr = heap)
+    explicit Table(Arena* arena) : values(Map::allocator_type(arena)) {}
     
     template<typename T>
     std::optional<T> get(const std::string& key) const {
@@ -62,7 +103,18 @@ public:
     }
     
     void set(const std::string& key, const TomlValue& value) {
-        values[key] = value;
+        values.insert_or_assign(key, value);
+    }
+
+    void set(const std::string& key, TomlValue&& value) {
+        values.insert_or_assign(key, std::move(value));
+    }
+
+    // Build the value of key in place from args unless key is present;
+    // returns whether it was inserted
+    template<typename... Args>
+    bool emplace(const std::string& key, Args&&... args) {
+        return values.try_emplace(key, std::forward<Args>(args)...).second;
     }
     
     bool has(const std::string& key) const {
@@ -70,18 +122,130 @@ public:
     }
 };
 
-// TOML Array
+// TOML Array. Arrays whose elements are all integers, or all floats, are
+// stored packed: one contiguous Integer or Float buffer (8 bytes per element
+// instead of sizeof(TomlValue)) and values() stays empty. Appending an
+// element of another type moves the numbers to values(). Read elements
+// through at()/for_each(), or values()/integers()/floats() by storage().
 class Array {
 public:
-    std::vector<TomlValue> elements;
+    enum class Storage { Values, Integers, Floats };
+
+    using Values = std::vector<TomlValue, ArenaAllocator<TomlValue>>;
+
+    Array() = default;
+    // Element storage comes from arena (nullptr = heap)
+    explicit Array(Arena* arena)
+        : values_(ArenaAllocator<TomlValue>(arena)), integers_(ArenaAllocator<Integer>(arena)),
+          floats_(ArenaAllocator<Float>(arena)) {}
     
     void append(const TomlValue& value) {
-        elements.push_back(value);
+        if (!append_packed(value)) values_.push_back(value);
+    }
+
+    void append(TomlValue&& value) {
+        if (!append_packed(value)) values_.push_back(std::move(value));
+    }
+
+    // Room for n elements in the storage the array has now (call it after
+    // the first element, once that storage is known)
+    void reserve(size_t n) {
+        switch (storage_) {
+            case Storage::Integers: integers_.reserve(n); break;
+            case Storage::Floats: floats_.reserve(n); break;
+            default: values_.reserve(n);
+        }
     }
     
     size_t size() const {
-        return elements.size();
+        switch (storage_) {
+            case Storage::Integers: return integers_.size();
+            case Storage::Floats: return floats_.size();
+            default: return values_.size();
+        }
+    }
+
+    bool empty() const { return size() == 0; }
+
+    Storage storage() const { return storage_; }
+    // Elements of a Storage::Values array; empty while the array is packed
+    const Values& values() const { return values_; }
+    // Elements to edit in place; packed numbers are moved there first
+    Values& mutable_values() {
+        unpack();
+        return values_;
+    }
+    // Packed elements (Storage::Integers / Storage::Floats)
+    const std::vector<Integer, ArenaAllocator<Integer>>& integers() const { return integers_; }
+    const std::vector<Float, ArenaAllocator<Float>>& floats() const { return floats_; }
+
+    // Element i, whatever the storage
+    TomlValue at(size_t i) const {
+        switch (storage_) {
+            case Storage::Integers: return integers_[i];
+            case Storage::Floats: return floats_[i];
+            default: return values_[i];
+        }
+    }
+
+    // Call f(const TomlValue&) for each element in order
+    template<typename F>
+    void for_each(F&& f) const {
+        switch (storage_) {
+            case Storage::Integers:
+                for (Integer v : integers_) f(TomlValue(v));
+                break;
+            case Storage::Floats:
+                for (Float v : floats_) f(TomlValue(v));
+                break;
+            default:
+                for (const TomlValue& v : values_) f(v);
+        }
+    }
+
+    // Move packed numbers to values()
+    void unpack() {
+        if (storage_ == Storage::Values) return;
+        values_.reserve(size() + 1);
+        for_each([this](const TomlValue& v) { values_.push_back(v); });
+        integers_.clear();
+        integers_.shrink_to_fit();
+        floats_.clear();
+        floats_.shrink_to_fit();
+        storage_ = Storage::Values;
+    }
+
+private:
+    // Store value packed if the array is (or, while empty, can become) packed
+    // of its type; false if it must go to values_
+    bool append_packed(const TomlValue& value) {
+        if (storage_ == Storage::Values) {
+            if (!values_.empty()) return false;
+            if (std::holds_alternative<Integer>(value)) {
+                storage_ = Storage::Integers;
+            } else if (std::holds_alternative<Float>(value)) {
+                storage_ = Storage::Floats;
+            } else {
+                return false;
+            }
+        }
+        if (storage_ == Storage::Integers) {
+            if (const auto* i = std::get_if<Integer>(&value)) {
+                integers_.push_back(*i);
+                return true;
+            }
+        } else if (const auto* f = std::get_if<Float>(&value)) {
+            floats_.push_back(*f);
+            return true;
+        }
+        unpack();
+        return false;
     }
+
+    Values values_;
+    Storage storage_ = Storage::Values;
+    std::vector<Integer, ArenaAllocator<Integer>> integers_;
+    std::vector<Float, ArenaAllocator<Float>> floats_;
 };
 
 // SIMD-optimized utility functions
@@ -95,62 +259,557 @@ namespace simd_utils {
     // Find next character using SIMD
     const char* find_char_simd(const char* ptr, const char* end, char c);
     
+    // Find next byte inside a string body that needs attention: the quote
+    // character, a backslash (basic strings only) or a control byte other than
+    // tab (U+0000-U+001F, U+007F). Returns end if the rest is a clean run.
+    const char* find_string_special(const char* ptr, const char* end, char quote, bool basic);
+
+    // Find next byte that must be escaped when writing a basic string: '"',
+    // backslash or any control byte (U+0000-U+001F incl. tab, U+007F).
+    const char* find_escape_char(const char* ptr, const char* end);
+    
+    // Find next byte that can end a run of value text while skipping a value:
+    // quote, bracket, brace, '#', ',', tab, LF or CR.
+    const char* find_value_delim(const char* ptr, const char* end);
+
+    // Find next byte that can change the structure around it for the
+    // section index: quote, bracket, brace, '#' or LF.
+    const char* find_structural(const char* ptr, const char* end);
+    
     // Check if string is whitespace
     bool is_whitespace(char c);
+    
+    // Whole-input validation: strict UTF-8 plus the TOML rule that control
+    // characters other than tab, LF and CR-in-CRLF are not permitted.
+    enum class InputError { None, ControlChar, InvalidUtf8 };
+    InputError validate_input(const char* ptr, const char* end, const char** error_pos);
+
+    // Instruction set of the kernels above, chosen once when the library is
+    // loaded: "avx2" or "sse2" on x86-64, "neon" on ARM, "scalar" elsewhere
+    const char* isa();
 }
 
+// Parser options
+struct ParseOptions {
+    // Allocate all tables, arrays and their map/vector storage from a single
+    // per-parse arena that is freed in one shot when the last reference to the
+    // document is dropped. Faster and smaller for large documents; the tree must
+    // not be mutated from several threads at once. A parser reused for several
+    // documents recycles the arena's blocks once its previous document is gone.
+    bool use_arena = false;
+    // Return strings that need no unescaping as StringView pointing into the
+    // input buffer instead of copying them into String. The buffer passed to
+    // parse() must outlive the document.
+    bool string_views = false;
+    // Threads used by parse() for documents of at least parallel_min_size
+    // bytes (0 = one per CPU, 1 = the calling thread only). The document is
+    // split at its top-level [table] and [[array]] headers, the sections are
+    // parsed concurrently and added to the tree in document order; the result
+    // is the same as on one thread. Documents that cannot be split, and ones
+    // with errors (so the error reported is the same), are parsed on the
+    // calling thread.
+    unsigned threads = 1;
+    size_t parallel_min_size = 1024 * 1024;
+};
+
+// Why a parse stopped (see ParseResult)
+enum class ParseErrorCode : uint8_t {
+    None,
+    InvalidUtf8,
+    ControlCharacter,    // U+0000-U+001F (except tab, LF, CR in CRLF) or U+007F
+    Syntax,              // missing or unexpected character, key or value
+    UnterminatedString,
+    InvalidEscape,       // malformed escape sequence in a basic string
+    InvalidNumber,
+    NumberOutOfRange,
+    InvalidDateTime,
+    KeyConflict,         // table or key redefined with another type
+    InvalidSelectPath,   // parse_selected path that is not a dotted key
+    InvalidEdit,         // reparse edit that does not fit the old and new input
+    Builder,             // rejected by the builder (message only), e.g. parse_into
+};
+
+// Outcome of a parse: ok, or the first error and where it was found. offset
+// is in bytes from the start of the input; line and column start at 1 (column
+// in bytes) and are 0 for errors without a position (InvalidSelectPath).
+struct ParseResult {
+    ParseErrorCode code = ParseErrorCode::None;
+    size_t offset = 0;
+    size_t line = 0;
+    size_t column = 0;
+
+    bool ok() const { return code == ParseErrorCode::None; }
+    explicit operator bool() const { return ok(); }
+};
+
+// Profile of one parse (TomlParser::parse(input, stats), or a builder's
+// stats() hook): what the document holds and where the time went. Counting
+// and timing cost a clock read per value, so a profiled parse is slower than
+// parse(); parses without the hook are compiled without any of it.
+struct ParseStats {
+    size_t bytes = 0;  // input scanned
+    // Values by type, including array elements and values in inline tables;
+    // datetimes include local dates and times
+    size_t integers = 0;
+    size_t floats = 0;
+    size_t booleans = 0;
+    size_t strings = 0;
+    size_t datetimes = 0;
+    size_t arrays = 0;
+    size_t inline_tables = 0;
+    size_t tables = 0;        // [table] headers
+    size_t array_tables = 0;  // [[array]] headers
+    size_t keys = 0;          // key/value lines
+    // Deepest value, counting header keys, dotted keys and enclosing arrays
+    // and inline tables (a = 1 is 1, [x.y] z = [[1]] is 5)
+    size_t max_depth = 0;
+    // Document memory with use_arena: bytes handed out to its nodes, and the
+    // blocks (and their bytes) taken from the heap; 0 without an arena
+    size_t arena_bytes = 0;
+    size_t arena_blocks = 0;
+    size_t arena_reserved = 0;
+    // Nanoseconds spent in UTF-8/control character validation, in string,
+    // number and datetime values (scanning and converting them), resolving
+    // [table] headers and key paths in the tree, and in the whole parse;
+    // convert_ns is the conversion to Python objects (set by the module)
+    uint64_t validate_ns = 0;
+    uint64_t strings_ns = 0;
+    uint64_t numbers_ns = 0;
+    uint64_t datetimes_ns = 0;
+    uint64_t tables_ns = 0;
+    uint64_t total_ns = 0;
+    uint64_t convert_ns = 0;
+};
+
+// An edit of a document's text for TomlParser::reparse: length bytes at
+// offset were replaced by replacement bytes at the same offset
+struct TextEdit {
+    size_t offset = 0;
+    size_t length = 0;
+    size_t replacement = 0;
+};
+
+// A value that differs between two documents (see diff and reparse), by path
+// from the root: keys, and indexes into arrays
+struct KeyChange {
+    enum class Kind { Added, Removed, Changed };
+    using PathElement = std::variant<std::string, size_t>;
+
+    Kind kind;
+    std::vector<PathElement> path;
+};
+
+// What a key already holds, as seen by the structural parser
+enum class NodeKind { Missing, Table, Array, Other };
+
+// Document builders
+//
+// TomlParser does not construct the document itself; it drives a builder that
+// receives tables, arrays and scalars as they are parsed. TreeBuilder below
+// produces the fasttoml::Table tree; the Python binding uses a builder that
+// creates dict/list objects directly. A builder provides:
+//
+//   using Value;                 // owned value (scalar, table or array)
+//   using TableRef, ArrayRef;    // nullable handles to containers being built
+//   TableRef root();
+//   NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array);
+//   TableRef add_table(TableRef parent, const std::string& key);
+//   ArrayRef add_array(TableRef parent, const std::string& key);
+//   TableRef append_table(ArrayRef array);
+//   size_t array_size(ArrayRef array);
+//   TableRef last_table(ArrayRef array);       // null if last element is not a table
+//   Value new_table(TableRef& out);            // detached, for inline tables
+//   Value new_array(ArrayRef& out);            // detached, for array values
+//   void append(ArrayRef array, Value&& value);
+//   void set(TableRef t, const std::string& key, Value&& value);
+//   Value scalar(TomlValue&& value);           // never a TablePtr or ArrayPtr
+//
+// Optionally, a builder may also provide
+//
+//   Value deferred(std::string_view text);
+//
+// in which case the value of each key/value line is not parsed but skipped,
+// and its input text is passed here instead (LazyDocument). Only root, find,
+// add_table, add_array, append_table, array_size, last_table and set are then
+// used. A builder may also provide
+//
+//   bool select(TableRef t, const std::vector<std::string>& path);
+//
+// which is asked before the value of each key (path is relative to t, at top
+// level and in inline tables); if it returns false the value is skipped
+// without being parsed and set() is not called for it (SelectBuilder). And
+//
+//   void header(const std::vector<std::string>& path, bool array_of_tables);
+//
+// is called for each [table] or [[array]] header before it is resolved
+// (StreamParser). And
+//
+//   ParseStats& stats();
+//
+// makes the parse count values and time its phases into the returned stats,
+// which are reset when the parse starts (TomlParser::parse(input, stats)).
+// And
+//
+//   void reserve(ArrayRef array, size_t n);
+//
+// is called after the first element of an array whose element count the
+// parser could see ahead (arrays of scalars), so storage is allocated once
+// (TreeBuilder; without it an arena keeps every outgrown buffer).
+//
+// A builder rejects a document by throwing a std::exception; the parse then
+// fails with ParseErrorCode::Builder and the exception's message.
+
+// Builder that produces the fasttoml::Table tree returned by TomlParser::parse
+class TreeBuilder {
+public:
+    using Value = TomlValue;
+    using TableRef = Table*;
+    using ArrayRef = Array*;
+
+    // Nodes are allocated from arena when given (see ParseOptions::use_arena)
+    explicit TreeBuilder(std::shared_ptr<Arena> arena = nullptr)
+        : arena_(std::move(arena)), root_(make_table()) {}
+    // Continue a document whose root was built elsewhere
+    TreeBuilder(std::shared_ptr<Arena> arena, TablePtr root) : arena_(std::move(arena)), root_(std::move(root)) {}
+
+    const TablePtr& document() const { return root_; }
+
+    TableRef root() { return root_.get(); }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+        auto it = t->values.find(key);
+        if (it == t->values.end()) return NodeKind::Missing;
+        if (auto* tp = std::get_if<TablePtr>(&it->second)) {
+            table = tp->get();
+            return NodeKind::Table;
+        }
+        if (auto* ap = std::get_if<ArrayPtr>(&it->second)) {
+            array = ap->get();
+            return NodeKind::Array;
+        }
+        return NodeKind::Other;
+    }
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        TablePtr t = make_table();
+        Table* raw = t.get();
+        parent->values.insert_or_assign(key, std::move(t));
+        return raw;
+    }
+
+    ArrayRef add_array(TableRef parent, const std::string& key) {
+        ArrayPtr a = make_array();
+        Array* raw = a.get();
+        parent->values.insert_or_assign(key, std::move(a));
+        return raw;
+    }
+
+    TableRef append_table(ArrayRef array) {
+        TablePtr t = make_table();
+        Table* raw = t.get();
+        array->append(std::move(t));
+        return raw;
+    }
+
+    size_t array_size(ArrayRef array) const { return array->size(); }
+
+    TableRef last_table(ArrayRef array) const {
+        if (array->values().empty()) return nullptr;
+        auto* tp = std::get_if<TablePtr>(&array->values().back());
+        return tp ? tp->get() : nullptr;
+    }
+
+    Value new_table(TableRef& out) {
+        TablePtr t = make_table();
+        out = t.get();
+        return t;
+    }
+
+    Value new_array(ArrayRef& out) {
+        ArrayPtr a = make_array();
+        out = a.get();
+        return a;
+    }
+
+    void append(ArrayRef array, Value&& value) { array->append(std::move(value)); }
+
+    void set(TableRef t, const std::string& key, Value&& value) { t->values.insert_or_assign(key, std::move(value)); }
+
+    void reserve(ArrayRef array, size_t n) { array->reserve(n); }
+
+    Value scalar(TomlValue&& value) { return std::move(value); }
+
+private:
+    TablePtr make_table() {
+        if (arena_) {
+            return std::allocate_shared<Table>(SharedArenaAllocator<Table>(arena_), arena_.get());
+        }
+        return std::make_shared<Table>();
+    }
+
+    ArrayPtr make_array() {
+        if (arena_) {
+            return std::allocate_shared<Array>(SharedArenaAllocator<Array>(arena_), arena_.get());
+        }
+        return std::make_shared<Array>();
+    }
+
+    std::shared_ptr<Arena> arena_;
+    TablePtr root_;
+};
+
+class LazyDocument;
+class Selection;
+struct BindOptions;
+namespace detail {
+class BoundStruct;
+struct Section;
+class MergeBuilder;
+}
+
+// Header paths declared with [[x]], interned one key per node so a header is
+// checked component by component while it is resolved (no path copies).
+// Only [[x]] paths and their prefixes are stored.
+class HeaderTrie {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kRoot = 0;
+
+    HeaderTrie() : nodes_(1) {}
+
+    // Empty the trie; node storage is kept for the next parse
+    void clear() {
+        for (size_t i = 0; i < used_; ++i) {
+            nodes_[i].children.clear();
+            nodes_[i].array_of_tables = false;
+        }
+        used_ = 1;
+    }
+
+    // Child of node for key; kNone if absent or node is kNone
+    uint32_t find(uint32_t node, const std::string& key) const {
+        if (node == kNone) return kNone;
+        const auto& children = nodes_[node].children;
+        auto it = children.find(key);
+        return it == children.end() ? kNone : it->second;
+    }
+
+    // Child of node for key, created if absent
+    uint32_t insert(uint32_t node, const std::string& key) {
+        auto inserted = nodes_[node].children.emplace(key, static_cast<uint32_t>(used_));
+        if (!inserted.second) return inserted.first->second;
+        if (used_ == nodes_.size()) nodes_.emplace_back();
+        return static_cast<uint32_t>(used_++);
+    }
+
+    bool is_array_of_tables(uint32_t node) const { return node != kNone && nodes_[node].array_of_tables; }
+    void mark_array_of_tables(uint32_t node) { nodes_[node].array_of_tables = true; }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, uint32_t> children;
+        bool array_of_tables = false;
+    };
+    std::vector<Node> nodes_;
+    size_t used_ = 1;  // nodes_[used_, size) are cleared spares
+};
+
+// Values that differ between before and after. Tables are compared key by
+// key and arrays of the same size element by element; any other difference
+// is reported once, as Changed, at the value that differs.
+std::vector<KeyChange> diff(const Table& before, const Table& after);
+
 // TOML Parser
 class TomlParser {
 public:
     TomlParser();
+    explicit TomlParser(const ParseOptions& options);
     ~TomlParser();
     
-    // Parse TOML string
-    std::shared_ptr<Table> parse(const std::string& input);
+    // Parse TOML text (any contiguous buffer: std::string, mapped file, bytes)
+    std::shared_ptr<Table> parse(std::string_view input);
+    // Same, on the calling thread, profiling the parse into stats (see ParseStats)
+    std::shared_ptr<Table> parse(std::string_view input, ParseStats& stats);
+
+    // Parse TOML string into a custom builder (see "Document builders" above).
+    // Returns false on error; the builder may then hold a partial document.
+    template<typename Builder>
+    bool parse_with(std::string_view input, Builder& builder);
+
+    // Index the document structure without parsing values (see LazyDocument).
+    // input must stay valid while the document is alive; owner, if given, is
+    // kept alive by the document for that purpose. Returns nullptr on error.
+    std::shared_ptr<LazyDocument> parse_lazy(std::string_view input, std::shared_ptr<const void> owner = nullptr);
+
+    // Parse only the parts of the document named by selection (see Selection);
+    // everything else is skipped without being built. Returns nullptr on error.
+    std::shared_ptr<Table> parse_selected(std::string_view input, const Selection& selection);
+    // Same, with paths given as strings; a malformed path is reported as an error
+    std::shared_ptr<Table> parse_selected(std::string_view input, const std::vector<std::string>& paths);
+
+    // Update document, parsed from old_input with these options, for input:
+    // old_input with edit applied (the bytes around the edit are the same).
+    // Only the top-level sections the edit touches are parsed again and put
+    // in place of the old ones; an edit that adds, removes or changes a table
+    // header, reaches keys that other sections' headers also reach, or a
+    // parser with string_views, parses input in full instead. changes, if
+    // given, receives diff(old document, new document). Returns false on
+    // error, leaving document unchanged.
+    bool reparse(TablePtr& document, std::string_view old_input, std::string_view input, const TextEdit& edit,
+                 std::vector<KeyChange>* changes = nullptr);
     
-    // Get parse error if any
-    std::string get_error() const { return error_message_; }
-    bool has_error() const { return !error_message_.empty(); }
+    // Parse straight into a struct described by Binding<T> (fasttoml/binding.hpp),
+    // checking types and required keys on the way. Members the document does
+    // not set keep their values. Returns false on error; out may then be
+    // partly written.
+    template<typename T>
+    bool parse_into(std::string_view input, T& out, const BindOptions& options);
+    template<typename T>
+    bool parse_into(std::string_view input, T& out);
+    
+    // Outcome of the last parse. Errors stop the parse where they are found
+    // and are recorded as a code and position; the message is only formatted
+    // by get_error().
+    const ParseResult& result() const { return result_; }
+    // Message of the last parse's error, empty if it succeeded
+    std::string get_error() const;
+    bool has_error() const { return !result_.ok(); }
+
+    // Drop the state of the previous parse (error, [[x]] paths) but keep its
+    // memory: scratch buffers stay allocated and the arena (use_arena) is
+    // rewound for the next document unless a document still uses it, in which
+    // case that document keeps it. Every parse starts this way, so a parser
+    // reused for many documents stops allocating for itself; memory is freed
+    // when the parser is destroyed.
+    void reset();
 
 private:
-    std::string error_message_;
+    friend class LazyDocument;
+    friend class Selection;
+
+    ParseOptions options_;
+    ParseResult result_;
+    // Message of the error: a static pattern whose "{}" are replaced by the
+    // arguments (copied, so they outlive the input) when it is formatted
+    const char* error_format_ = nullptr;
+    std::string error_args_[2];
+    // Start of the text being parsed and of the current header or key/value
+    // line, for error positions (key conflicts are reported at the statement)
+    const char* begin_;
+    const char* statement_;
     const char* current_;
     const char* end_;
-    std::shared_ptr<Table> root_table_;
-    std::shared_ptr<Table> current_table_;
     // Paths that were defined as array-of-tables [[x]], so [x.y] is allowed
-    std::set<std::vector<std::string>> array_of_tables_paths_;
+    HeaderTrie header_paths_;
+    // Scratch paths for dotted keys, one per inline table nesting level, kept
+    // across lines and parses (a deque, so deeper levels never move outer ones)
+    std::deque<std::vector<std::string>> key_paths_;
+    size_t inline_depth_ = 0;
+    // With a stats() builder: depth of the current table header and of the
+    // key being parsed, and arrays and inline tables around the current value
+    size_t stats_table_depth_ = 0;
+    size_t stats_key_depth_ = 0;
+    size_t stats_value_depth_ = 0;
+    // Arena of the last document built with use_arena, recycled by reset()
+    std::shared_ptr<Arena> arena_;
+
+    // parse_into for a type-erased struct
+    bool parse_bound(std::string_view input, void* out, const detail::BoundStruct& type, const BindOptions& options);
+
+    // parse() on several threads (ParseOptions::threads); nullptr if the
+    // document was not split or has an error, parse() then runs on one thread
+    std::shared_ptr<Table> parse_parallel(std::string_view input, unsigned threads);
+    // Stage 1: split the input at its top-level table headers (one vectorized
+    // scan that follows strings, comments and bracket nesting). With stop_at
+    // (sorted), the scan ends at the first header found at one of those
+    // positions, which then ends the last section.
+    bool index_sections(std::vector<detail::Section>& sections, const std::vector<const char*>* stop_at = nullptr);
+    // Stage 2, on a worker's parser: parse one section into a detached table
+    bool parse_section(detail::Section& section, const std::shared_ptr<Arena>& arena);
+    // Stage 3, in document order: resolve the section's header and merge it
+    bool merge_section(detail::MergeBuilder& builder, detail::Section& section);
+    // reparse() without the full parse: false if the edit cannot be applied
+    // to document section by section, which is then left unchanged
+    bool reparse_sections(Table& document, std::string_view old_input, std::string_view input, const TextEdit& edit,
+                          std::vector<KeyChange>* changes);
+
+    // Reset state and validate input; false (with error set) if input is rejected
+    bool begin_parse(std::string_view input);
+    // Arena for a new document: the recycled one, or a new one with this block size
+    std::shared_ptr<Arena> acquire_arena(size_t block_size);
+    void recycle_arena();
 
     // Path helpers for [table] and dotted keys
-    std::vector<std::string> parse_dotted_key();
-    std::shared_ptr<Table> get_or_create_table_at_path(const std::vector<std::string>& path);
-    std::shared_ptr<Table> get_or_create_array_append_table(const std::vector<std::string>& path);
-    void set_value_at_path(std::shared_ptr<Table> table, const std::vector<std::string>& path, const TomlValue& value);
+    std::vector<std::string>& key_path(size_t depth);
+    // Parse a dotted key into path, reusing its strings
+    void parse_dotted_key(std::vector<std::string>& path);
+    // Parse a [table] or [[array]] header (at its '[') and the rest of its line
+    bool parse_table_header(std::vector<std::string>& path, bool& array_of_tables);
+    template<typename Builder>
+    typename Builder::TableRef get_or_create_table_at_path(Builder& b, const std::vector<std::string>& path);
+    template<typename Builder>
+    typename Builder::TableRef get_or_create_array_append_table(Builder& b, const std::vector<std::string>& path);
+    template<typename Builder>
+    void set_value_at_path(Builder& b, typename Builder::TableRef table, const std::vector<std::string>& path,
+                           typename Builder::Value&& value);
     
     // Parse methods
-    void parse_document();
-    std::shared_ptr<Table> parse_table();
-    void parse_key_value_pair(std::shared_ptr<Table> table);
-    std::string parse_key();
-    TomlValue parse_value();
+    template<typename Builder>
+    void parse_document(Builder& b);
+    template<typename Builder>
+    void parse_key_value_pair(Builder& b, typename Builder::TableRef table);
+    // Whether the value of path is wanted; if not (select() hook), skips it
+    template<typename Builder>
+    bool selected(Builder& b, typename Builder::TableRef table, const std::vector<std::string>& path);
+    // Parse a select path (dotted key, optional "[*]" after each key) into keys
+    bool parse_select_path(std::string_view text, std::vector<std::string>& keys);
+    void parse_key(std::string& key);
+    template<typename Builder>
+    typename Builder::Value parse_value(Builder& b);
+    // Value of a key/value line: parsed, or skipped for builders with deferred()
+    template<typename Builder>
+    typename Builder::Value parse_entry_value(Builder& b);
+    // Parse text holding exactly one value; text is a span of an input that
+    // begin_parse already validated
+    template<typename Builder>
+    bool parse_value_text(std::string_view text, Builder& b, typename Builder::Value& out);
+    // Skip one value without decoding it; returns its text, trailing blanks excluded
+    std::string_view skip_value();
+    // Skip a basic, literal or multiline string token; false (error set) if unclosed
+    bool skip_string();
+    // Elements of the array whose first element is at current_, counted
+    // ahead for arrays of scalars; 0 if it cannot tell without parsing
+    size_t count_array_elements() const;
+    // Any value other than an array or inline table
+    TomlValue parse_scalar();
+    // parse_scalar() for builders with stats(): counts and times the value
+    TomlValue parse_scalar_profiled(ParseStats& stats);
     String parse_string();
     String parse_basic_string();
     String parse_literal_string();
     String parse_multiline_basic_string();
     String parse_multiline_literal_string();
-    Integer parse_integer();
-    Float parse_float();
+    // String value in parse_scalar: zero-copy view (or single copy) when the
+    // body has no escapes, otherwise falls back to the String parsers above
+    TomlValue parse_string_value();
+    TomlValue make_string_value(const char* begin, const char* end);
+    // Integer or float (incl. 0x/0o/0b, +-inf, +-nan) parsed in place from the input
+    TomlValue parse_number();
     Boolean parse_boolean();
     DateTime parse_datetime();
     
     // Array parsing
-    ArrayPtr parse_array();
+    template<typename Builder>
+    typename Builder::Value parse_array(Builder& b);
     
     // Inline table: { key = value, ... }
-    TablePtr parse_inline_table();
+    template<typename Builder>
+    typename Builder::Value parse_inline_table(Builder& b);
     
     // Date/time: only consumes input if parsing succeeds
     std::optional<TomlValue> try_parse_datetime();
+    // HH:MM:SS[.fraction] at p, with 8 bytes available (see try_parse_datetime)
+    const char* parse_time_fields(const char* p, bool time_only, LocalTime& time);
     
     // Utility methods
     void skip_whitespace();
@@ -161,7 +820,14 @@ private:
     char peek();
     char advance();
     bool eof();
-    void set_error(const std::string& message);
+    // Record the first error, at the current position or at; format is a
+    // string literal (see error_format_)
+    void set_error(ParseErrorCode code, const char* format, std::string_view arg = {}, std::string_view arg2 = {});
+    void set_error_at(const char* at, ParseErrorCode code, const char* format, std::string_view arg = {},
+                      std::string_view arg2 = {});
+    void clear_error() { result_ = ParseResult(); }
+    // Start parsing text (a whole input or a span of one)
+    void set_input(std::string_view text);
     
     // String parsing helpers
     std::string parse_escape_sequence();
@@ -169,3 +835,5 @@ private:
 };
 
 } // namespace fasttoml
+
+#include "fasttoml/parser_impl.hpp"
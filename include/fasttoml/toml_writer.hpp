@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "fasttoml/toml_parser.hpp"
+
+namespace fasttoml {
+
+// Serialize a document with the same layout as fasttoml.dumps(): keys sorted,
+// plain values first, then [tables], then [[arrays of tables]]; lines joined
+// with '\n', no trailing newline. Throws std::invalid_argument for a non-empty
+// array of tables nested inside a value (it has no inline form).
+std::string to_toml(const Table& table);
+
+// Building blocks of the emitter, shared with the Python binding
+namespace writer {
+    // Key made only of A-Za-z0-9_- (no quoting needed)
+    bool is_bare_key(std::string_view key);
+    // Bare key, or basic string if it needs quoting
+    void append_key(std::string& out, std::string_view key);
+    // "..." with \\ \" \n \r \t and \uXXXX for other control characters
+    void append_basic_string(std::string& out, std::string_view s);
+    // Same text as Python's repr(float); inf, -inf, nan as TOML spells them
+    void append_float(std::string& out, double value);
+    // YYYY-MM-DDTHH:MM:SS[.ffffff], trailing zeros of the fraction removed
+    void append_datetime(std::string& out, int year, int month, int day, int hour, int minute, int second,
+                         int microsecond);
+    // "Z" for a zero offset, otherwise +HH:MM / -HH:MM (seconds dropped)
+    void append_offset(std::string& out, int offset_seconds);
+    // YYYY-MM-DD, HH:MM:SS[.fraction] (as many digits as were parsed) and
+    // both joined by 'T', written to out (kLocalSize bytes); returns the length
+    constexpr size_t kLocalSize = 32;
+    size_t format_local(char* out, const LocalDate& date);
+    size_t format_local(char* out, const LocalTime& time);
+    size_t format_local(char* out, const LocalDateTime& datetime);
+
+    // Strings holding a TOML date, time or local datetime (as returned by the
+    // parser) are written back as literals rather than quoted strings
+    enum class StringForm { Basic, Date, Time, LocalDateTime };
+
+    // Text: size() and at(i) (a character, code point for Python str) plus
+    // is_digit(i). Mirrors the checks of the reference Python emitter.
+    template<typename Text>
+    StringForm classify_string(const Text& s) {
+        const size_t n = s.size();
+        auto digits = [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) {
+                if (!s.is_digit(i)) return false;
+            }
+            return true;
+        };
+        const bool date = n == 10 && s.at(4) == '-' && s.at(7) == '-' && digits(0, 4) && digits(5, 7) &&
+                          digits(8, 10);
+        if (date) return StringForm::Date;
+        bool time = n >= 8 && s.at(2) == ':' && s.at(5) == ':' && digits(0, 2) && digits(3, 5) && digits(6, 8);
+        if (time && n > 8) {
+            // .fraction: digits and dots, at least one digit
+            bool any_digit = false;
+            time = s.at(8) == '.';
+            for (size_t i = 9; time && i < n; ++i) {
+                if (s.is_digit(i)) any_digit = true;
+                else if (s.at(i) != '.') time = false;
+            }
+            time = time && any_digit;
+        }
+        bool local = n >= 19 && s.at(4) == '-' && s.at(7) == '-' &&
+                     (s.at(10) == 'T' || s.at(10) == 't' || s.at(10) == ' ') && s.at(13) == ':' &&
+                     s.at(16) == ':' && digits(0, 4) && digits(5, 7) && digits(8, 10) && digits(11, 13) &&
+                     digits(14, 16) && digits(17, 19);
+        if (local && n > 19) {
+            local = s.at(19) == '.';
+            for (size_t i = 20; local && i < n; ++i) {
+                if (!s.is_digit(i) && s.at(i) != '.') local = false;
+            }
+        }
+        if (local) return StringForm::LocalDateTime;
+        if (time) return StringForm::Time;
+        return StringForm::Basic;
+    }
+}
+
+} // namespace fasttoml
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Throughput of fasttoml.load_path (parse + conversion to dicts) on the inputs
+written by `fasttoml_bench --write-inputs DIR`, to compare with the C++ parse
+alone (`fasttoml_bench --arena` uses the same parse options as the module).
+
+Usage: python scripts/bench_python.py DIR [--min-time SECONDS]
+"""
+import argparse
+import sys
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+import fasttoml
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("inputs", type=Path)
+    parser.add_argument("--min-time", type=float, default=0.5)
+    args = parser.parse_args()
+    files = sorted(args.inputs.glob("*.toml"))
+    if not files:
+        print(f"no .toml files in {args.inputs}", file=sys.stderr)
+        return 2
+    print(f"{'input':<24} {'MB/s':>10}")
+    for path in files:
+        size = path.stat().st_size
+        best, total, runs = float("inf"), 0.0, 0
+        while runs < 3 or total < args.min_time:
+            start = time.perf_counter()
+            fasttoml.load_path(path)
+            elapsed = time.perf_counter() - start
+            best, total, runs = min(best, elapsed), total + elapsed, runs + 1
+        print(f"{path.stem:<24} {size / best / 1e6:>10.1f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,7 +1,6 @@
 import os
 import re
 import sys
-import platform
 import subprocess
 
 from pybind11.setup_helpers import Pybind11Extension, build_ext
@@ -34,32 +33,18 @@ def get_pybind11_include():
     import pybind11
     return pybind11.get_include()
 
-# SIMD flags
-def get_simd_flags():
-    flags = []
-    if platform.machine().lower() in ['x86_64', 'amd64', 'i386', 'i686']:
-        # AVX2 and SSE4.2 support
-        if sys.platform != 'win32':
-            flags.extend(['-mavx2', '-msse4.2'])
-        else:
-            flags.extend(['/arch:AVX2'])
-    return flags
-
 # Compiler-specific flags
 def get_compile_args():
     extra_args = []
     
-    # SIMD flags
-    extra_args.extend(get_simd_flags())
+    # No SIMD flags: the AVX2 kernels are picked at import time by CPUID, so
+    # wheels built here run on any x86-64 CPU
     
     # C++17 standard
     if sys.platform == 'win32':
         extra_args.extend(['/std:c++17', '/O2', '/EHsc'])
     else:
         extra_args.extend(['-std=c++17', '-O3'])
-        # -march=native on macOS can yield 'apple-m3' which older Xcode/clang don't support
-        if sys.platform != 'darwin':
-            extra_args.append('-march=native')
     
     return extra_args
 
@@ -75,6 +60,15 @@ ext_modules = [
         "fasttoml._native",
         [
             "src/toml_parser.cpp",
+            "src/mapped_file.cpp",
+            "src/toml_writer.cpp",
+            "src/lazy_document.cpp",
+            "src/selection.cpp",
+            "src/stream_parser.cpp",
+            "src/binding.cpp",
+            "src/parallel_parser.cpp",
+            "src/incremental.cpp",
+            "src/snapshot.cpp",
             "src/python_bindings.cpp",
         ],
         include_dirs=[
@@ -0,0 +1,300 @@
+#include "fasttoml/binding.hpp"
+#include <stdexcept>
+
+namespace fasttoml {
+namespace detail {
+
+const char* toml_type_name(const TomlValue& value) {
+    if (std::holds_alternative<Integer>(value)) return "integer";
+    if (std::holds_alternative<Float>(value)) return "float";
+    if (std::holds_alternative<Boolean>(value)) return "boolean";
+    if (std::holds_alternative<String>(value) || std::holds_alternative<StringView>(value)) return "string";
+    if (std::holds_alternative<TablePtr>(value)) return "table";
+    if (std::holds_alternative<ArrayPtr>(value)) return "array";
+    if (std::holds_alternative<LocalDate>(value)) return "local date";
+    if (std::holds_alternative<LocalTime>(value)) return "local time";
+    if (std::holds_alternative<LocalDateTime>(value)) return "local datetime";
+    return "datetime";
+}
+
+namespace {
+
+// Target of keys skipped with allow_unknown_keys
+class IgnoredType final : public BoundType {
+public:
+    IgnoredType() : BoundType(Kind::Ignored) {}
+    const char* name() const override { return "ignored"; }
+};
+
+const IgnoredType kIgnored;
+
+} // namespace
+
+BindBuilder::BindBuilder(void* root, const BoundStruct& type, const BindOptions& options)
+    : root_(root), root_type_(&type), options_(options) {
+    instances_.push_back(Instance{root, &type, 0, 0, kNoField, kNoIndex});
+    state_.resize(type.fields().size());
+}
+
+NodeKind BindBuilder::find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+    if (ignored(t)) return NodeKind::Missing;
+    const uint32_t f = field_index(t, key);
+    if (f == kNoField) return NodeKind::Missing;
+    const uint32_t st = state(t.instance, f);
+    if (st == 0) return NodeKind::Missing;
+    const BoundType& type = peel(field_of(t, f).type());
+    if (type.kind == BoundType::Kind::Struct) {
+        table = Ref{instances_[st - 1].obj, &type, st - 1};
+        return NodeKind::Table;
+    }
+    if (type.kind == BoundType::Kind::Array) {
+        Ref r = field_ref(t, f);
+        while (r.type->kind == BoundType::Kind::Optional) {
+            const auto& optional = static_cast<const BoundOptional&>(*r.type);
+            r.obj = optional.value(r.obj);
+            r.type = &optional.value_type();
+        }
+        array = r;
+        return NodeKind::Array;
+    }
+    return NodeKind::Other;
+}
+
+BindBuilder::TableRef BindBuilder::add_table(TableRef parent, const std::string& key) {
+    if (ignored(parent)) return parent;
+    const uint32_t f = field_index(parent, key);
+    if (f == kNoField) return ignored_ref();
+    return open_struct(field_ref(parent, f));
+}
+
+BindBuilder::ArrayRef BindBuilder::add_array(TableRef parent, const std::string& key) {
+    if (ignored(parent)) return parent;
+    const uint32_t f = field_index(parent, key);
+    if (f == kNoField) return ignored_ref();
+    Ref r = unwrap(field_ref(parent, f));
+    if (r.type->kind != BoundType::Kind::Array ||
+        peel(static_cast<const BoundArray&>(*r.type).element()).kind != BoundType::Kind::Struct) {
+        throw std::runtime_error(context(r) + ": expected " + r.type->name() + ", found array of tables");
+    }
+    static_cast<const BoundArray&>(*r.type).clear(r.obj);
+    state(parent.instance, f) = 1;
+    return r;
+}
+
+BindBuilder::TableRef BindBuilder::append_table(ArrayRef array) {
+    if (ignored(array)) return array;
+    return open_struct(element_of(array));
+}
+
+size_t BindBuilder::array_size(ArrayRef array) const {
+    if (ignored(array)) return 0;
+    return static_cast<const BoundArray&>(*array.type).size(array.obj);
+}
+
+BindBuilder::TableRef BindBuilder::last_table(ArrayRef array) {
+    if (ignored(array)) return array;
+    const uint32_t st = array.field == kNoField ? 0 : state(array.instance, array.field);
+    if (st <= 1) return Ref{};
+    // Nothing was appended after the last element, so its address is current
+    const Instance& last = instances_[st - 1];
+    return Ref{last.obj, last.type, st - 1};
+}
+
+BindBuilder::Value BindBuilder::new_table(TableRef& out) {
+    out = open_struct(take_target());
+    open_.push_back(out);
+    return Value{{}, true};
+}
+
+BindBuilder::Value BindBuilder::new_array(ArrayRef& out) {
+    Ref target = unwrap(take_target());
+    if (target.type->kind != BoundType::Kind::Array) mismatch(target, "array");
+    static_cast<const BoundArray&>(*target.type).clear(target.obj);
+    if (target.index == kNoIndex) {
+        state(target.instance, target.field) = 1;
+    } else {
+        // Elements of a nested array are not tracked per field
+        target.field = kNoField;
+    }
+    target.index = kNoIndex;
+    out = target;
+    open_.push_back(out);
+    return Value{{}, true};
+}
+
+void BindBuilder::append(ArrayRef array, Value&& value) {
+    if (value.container) {
+        open_.pop_back();
+        return;
+    }
+    assign(element_of(array), value.scalar);
+}
+
+void BindBuilder::set(TableRef, const std::string&, Value&& value) {
+    if (value.container) {
+        open_.pop_back();
+        return;
+    }
+    Ref target = pending_;
+    pending_ = Ref{};
+    assign(target, value.scalar);
+}
+
+bool BindBuilder::select(TableRef t, const std::vector<std::string>& path) {
+    if (ignored(t)) return false;
+    Ref current = t;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const uint32_t f = field_index(current, path[i]);
+        if (f == kNoField) return false;
+        const uint32_t st = state(current.instance, f);
+        if (st == 0) {
+            current = open_struct(field_ref(current, f));
+        } else if (peel(field_of(current, f).type()).kind == BoundType::Kind::Struct) {
+            current = Ref{instances_[st - 1].obj, instances_[st - 1].type, st - 1};
+        } else {
+            throw std::runtime_error("Key '" + path[i] + "' already defined as non-table");
+        }
+    }
+    const uint32_t f = field_index(current, path.back());
+    if (f == kNoField) return false;
+    pending_ = field_ref(current, f);
+    if (state(current.instance, f) != 0) {
+        const std::string key = context(pending_);
+        pending_ = Ref{};
+        throw std::runtime_error("Duplicate k" + key.substr(1));
+    }
+    return true;
+}
+
+bool BindBuilder::finish(std::string& error) const {
+    for (uint32_t i = 0; i < instances_.size(); ++i) {
+        const Instance& instance = instances_[i];
+        const auto& fields = instance.type->fields();
+        for (uint32_t f = 0; f < fields.size(); ++f) {
+            if (fields[f].required && state_[instance.state + f] == 0) {
+                std::string path = path_of(i);
+                if (!path.empty()) path += '.';
+                error = "Missing required key '" + path + fields[f].key + "'";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t BindBuilder::field_index(const Ref& t, const std::string& key) const {
+    const uint32_t f = instances_[t.instance].type->find(key);
+    if (f == kNoField && !options_.allow_unknown_keys) {
+        std::string path = path_of(t.instance);
+        if (!path.empty()) path += '.';
+        throw std::runtime_error("Unknown key '" + path + key + "'");
+    }
+    return f;
+}
+
+BindBuilder::Ref BindBuilder::field_ref(const Ref& t, uint32_t field) const {
+    const BoundStruct::Field& f = field_of(t, field);
+    return Ref{f.member->get(t.obj), &f.type(), t.instance, field, kNoIndex};
+}
+
+BindBuilder::Ref BindBuilder::element_of(const Ref& array) {
+    const auto& type = static_cast<const BoundArray&>(*array.type);
+    void* element = type.append(array.obj);
+    return Ref{element, &type.element(), array.instance, array.field, static_cast<uint32_t>(type.size(array.obj) - 1)};
+}
+
+BindBuilder::Ref BindBuilder::unwrap(Ref r) {
+    while (r.type->kind == BoundType::Kind::Optional) {
+        const auto& optional = static_cast<const BoundOptional&>(*r.type);
+        r.obj = optional.emplace(r.obj);
+        r.type = &optional.value_type();
+    }
+    return r;
+}
+
+const BoundType& BindBuilder::peel(const BoundType& type) {
+    const BoundType* t = &type;
+    while (t->kind == BoundType::Kind::Optional) t = &static_cast<const BoundOptional&>(*t).value_type();
+    return *t;
+}
+
+BindBuilder::Ref BindBuilder::open_struct(Ref target) {
+    if (ignored(target)) return target;
+    target = unwrap(target);
+    if (target.type->kind != BoundType::Kind::Struct) mismatch(target, "table");
+    const auto& type = static_cast<const BoundStruct&>(*target.type);
+    const uint32_t instance = static_cast<uint32_t>(instances_.size());
+    instances_.push_back(Instance{target.obj, &type, static_cast<uint32_t>(state_.size()), target.instance,
+                                  target.field, target.index});
+    state_.resize(state_.size() + type.fields().size());
+    // A table, or the last table of an array of tables
+    if (target.field != kNoField) state(target.instance, target.field) = instance + 1;
+    return Ref{target.obj, &type, instance};
+}
+
+void BindBuilder::assign(Ref target, const TomlValue& value) {
+    target = unwrap(target);
+    if (target.type->kind != BoundType::Kind::Scalar) mismatch(target, toml_type_name(value));
+    std::string error;
+    if (!static_cast<const BoundScalar&>(*target.type).assign(target.obj, value, error)) {
+        throw std::runtime_error(context(target) + ": " + error);
+    }
+    if (target.index == kNoIndex) state(target.instance, target.field) = 1;
+}
+
+std::string BindBuilder::context(const Ref& target) const {
+    std::string path = path_of(target.instance);
+    if (target.field != kNoField) {
+        if (!path.empty()) path += '.';
+        path += instances_[target.instance].type->fields()[target.field].key;
+    }
+    if (target.index == kNoIndex) return "Key '" + path + "'";
+    if (target.field == kNoField) return "Element " + std::to_string(target.index) + " of a nested array";
+    return "Element " + std::to_string(target.index) + " of '" + path + "'";
+}
+
+std::string BindBuilder::path_of(uint32_t instance) const {
+    std::string path;
+    while (instance != 0) {
+        const Instance& i = instances_[instance];
+        std::string part;
+        if (i.field != kNoField) part = instances_[i.parent].type->fields()[i.field].key;
+        if (i.index != kNoIndex) part += "[" + std::to_string(i.index) + "]";
+        path = path.empty() ? part : part + "." + path;
+        instance = i.parent;
+    }
+    return path;
+}
+
+void BindBuilder::mismatch(const Ref& target, const char* found) const {
+    throw std::runtime_error(context(target) + ": expected " + target.type->name() + ", found " + found);
+}
+
+BindBuilder::Ref BindBuilder::take_target() {
+    if (pending_) {
+        Ref target = pending_;
+        pending_ = Ref{};
+        return target;
+    }
+    // A value inside an array is its next element
+    if (!open_.empty() && open_.back().type->kind == BoundType::Kind::Array) return element_of(open_.back());
+    throw std::logic_error("BindBuilder: value without a target");
+}
+
+BindBuilder::Ref BindBuilder::ignored_ref() const { return Ref{nullptr, &kIgnored}; }
+
+} // namespace detail
+
+bool TomlParser::parse_bound(std::string_view input, void* out, const detail::BoundStruct& type,
+                             const BindOptions& options) {
+    detail::BindBuilder builder(out, type, options);
+    if (!parse_with(input, builder)) return false;
+    std::string error;
+    if (!builder.finish(error)) {
+        set_error(ParseErrorCode::Builder, "{}", error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace fasttoml
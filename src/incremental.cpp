@@ -0,0 +1,403 @@
+#include "fasttoml/toml_parser.hpp"
+#include "fasttoml/sections.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace fasttoml {
+namespace {
+
+using Path = std::vector<KeyChange::PathElement>;
+
+bool same_value(const TomlValue& a, const TomlValue& b);
+
+// Same entries in the same order
+bool same_table(const Table& a, const Table& b) {
+    if (a.values.size() != b.values.size()) return false;
+    auto other = b.values.begin();
+    for (const auto& entry : a.values) {
+        if (entry.first != other->first || !same_value(entry.second, other->second)) return false;
+        ++other;
+    }
+    return true;
+}
+
+bool same_array(const Array& a, const Array& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!same_value(a.at(i), b.at(i))) return false;
+    }
+    return true;
+}
+
+bool as_text(const TomlValue& value, std::string_view& text) {
+    if (const auto* s = std::get_if<String>(&value)) {
+        text = *s;
+        return true;
+    }
+    if (const auto* s = std::get_if<StringView>(&value)) {
+        text = *s;
+        return true;
+    }
+    return false;
+}
+
+// A String and a StringView with the same text are the same; floats compare
+// bit for bit, so nan is the same as nan and -0.0 differs from 0.0
+bool same_value(const TomlValue& a, const TomlValue& b) {
+    std::string_view text_a, text_b;
+    if (as_text(a, text_a) && as_text(b, text_b)) return text_a == text_b;
+    if (a.index() != b.index()) return false;
+    if (const auto* i = std::get_if<Integer>(&a)) return *i == std::get<Integer>(b);
+    if (const auto* f = std::get_if<Float>(&a)) return std::memcmp(f, &std::get<Float>(b), sizeof(Float)) == 0;
+    if (const auto* v = std::get_if<Boolean>(&a)) return *v == std::get<Boolean>(b);
+    if (const auto* d = std::get_if<DateTime>(&a)) return *d == std::get<DateTime>(b);
+    if (const auto* d = std::get_if<DateTimeOffset>(&a)) {
+        const DateTimeOffset& other = std::get<DateTimeOffset>(b);
+        return d->utc == other.utc && d->offset_minutes == other.offset_minutes;
+    }
+    if (const auto* d = std::get_if<LocalDate>(&a)) return *d == std::get<LocalDate>(b);
+    if (const auto* t = std::get_if<LocalTime>(&a)) return *t == std::get<LocalTime>(b);
+    if (const auto* d = std::get_if<LocalDateTime>(&a)) return *d == std::get<LocalDateTime>(b);
+    if (const auto* t = std::get_if<TablePtr>(&a)) return same_table(**t, *std::get<TablePtr>(b));
+    return same_array(*std::get<ArrayPtr>(a), *std::get<ArrayPtr>(b));
+}
+
+void diff_tables(const Table& before, const Table& after, Path& path, std::vector<KeyChange>& changes);
+
+void diff_values(const TomlValue& before, const TomlValue& after, Path& path, std::vector<KeyChange>& changes) {
+    const auto* table_before = std::get_if<TablePtr>(&before);
+    const auto* table_after = std::get_if<TablePtr>(&after);
+    if (table_before && table_after) {
+        diff_tables(**table_before, **table_after, path, changes);
+        return;
+    }
+    const auto* array_before = std::get_if<ArrayPtr>(&before);
+    const auto* array_after = std::get_if<ArrayPtr>(&after);
+    if (array_before && array_after && (*array_before)->size() == (*array_after)->size()) {
+        for (size_t i = 0; i < (*array_before)->size(); ++i) {
+            path.emplace_back(i);
+            diff_values((*array_before)->at(i), (*array_after)->at(i), path, changes);
+            path.pop_back();
+        }
+        return;
+    }
+    if (!same_value(before, after)) changes.push_back({KeyChange::Kind::Changed, path});
+}
+
+void diff_tables(const Table& before, const Table& after, Path& path, std::vector<KeyChange>& changes) {
+    for (const auto& entry : before.values) {
+        path.emplace_back(entry.first);
+        auto it = after.values.find(entry.first);
+        if (it == after.values.end()) {
+            changes.push_back({KeyChange::Kind::Removed, path});
+        } else {
+            diff_values(entry.second, it->second, path, changes);
+        }
+        path.pop_back();
+    }
+    for (const auto& entry : after.values) {
+        if (before.values.find(entry.first) != before.values.end()) continue;
+        path.emplace_back(entry.first);
+        changes.push_back({KeyChange::Kind::Added, path});
+        path.pop_back();
+    }
+}
+
+// Resolves a document's headers again against the tree they built, without
+// changing it: each [[x]] steps to the array's next existing table. Records
+// which section's header went through each key first, and the path (keys and
+// array indexes) of the table the current header resolves to.
+class ReplayBuilder {
+public:
+    using Value = TomlValue;
+    using TableRef = Table*;
+    using ArrayRef = Array*;
+
+    static constexpr size_t kNone = SIZE_MAX;
+
+    explicit ReplayBuilder(Table& root) : root_(&root) {}
+
+    void start(size_t section) {
+        section_ = section;
+        path_.clear();
+        trail_.clear();
+    }
+
+    const Path& path() const { return path_; }
+    // Table of each key of the current header
+    const std::vector<Table*>& trail() const { return trail_; }
+
+    // First section whose header went through key of t, or kNone
+    size_t touched_by(const Table* t, std::string_view key) const {
+        auto keys = touched_.find(t);
+        if (keys == touched_.end()) return kNone;
+        auto it = keys->second.find(key);
+        return it == keys->second.end() ? kNone : it->second;
+    }
+
+    TableRef root() { return root_; }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+        touched_[t].try_emplace(key, section_);
+        path_.emplace_back(key);
+        trail_.push_back(t);
+        auto it = t->values.find(key);
+        if (it == t->values.end()) return NodeKind::Missing;
+        if (auto* tp = std::get_if<TablePtr>(&it->second)) {
+            table = tp->get();
+            return NodeKind::Table;
+        }
+        if (auto* ap = std::get_if<ArrayPtr>(&it->second)) {
+            array = ap->get();
+            // Before its first [[x]] the array was missing, and add_array() is
+            // asked for it
+            if (array_size(array) == 0) {
+                created_ = array;
+                return NodeKind::Missing;
+            }
+            return NodeKind::Array;
+        }
+        return NodeKind::Other;
+    }
+
+    // The document has every table its headers name
+    TableRef add_table(TableRef, const std::string&) { throw std::logic_error("Header not in document"); }
+
+    ArrayRef add_array(TableRef, const std::string&) {
+        if (!created_) throw std::logic_error("Header not in document");
+        return std::exchange(created_, nullptr);
+    }
+
+    TableRef append_table(ArrayRef array) {
+        // The index last_table() added while the header was checked
+        if (std::holds_alternative<size_t>(path_.back())) path_.pop_back();
+        size_t& next = appended_[array];
+        TableRef t = table_at(array, next);
+        path_.emplace_back(next++);
+        return t;
+    }
+
+    size_t array_size(ArrayRef array) const {
+        auto it = appended_.find(array);
+        return it == appended_.end() ? 0 : it->second;
+    }
+
+    TableRef last_table(ArrayRef array) {
+        const size_t i = array_size(array) - 1;
+        path_.emplace_back(i);
+        return table_at(array, i);
+    }
+
+private:
+    static TableRef table_at(ArrayRef array, size_t i) {
+        if (i >= array->values().size()) throw std::logic_error("Header not in document");
+        auto* tp = std::get_if<TablePtr>(&array->values()[i]);
+        return tp ? tp->get() : nullptr;
+    }
+
+    TableRef root_;
+    size_t section_ = 0;
+    Path path_;
+    std::vector<Table*> trail_;
+    ArrayRef created_ = nullptr;
+    std::unordered_map<const Table*, TableMap<size_t>> touched_;
+    std::unordered_map<const Array*, size_t> appended_;
+};
+
+// Replace count entries of table from pos on by the entries of body, keeping
+// the entries around them where they are
+void splice(Table& table, size_t pos, size_t count, Table& body) {
+    Table::Map values(table.values.get_allocator());
+    values.reserve(table.values.size() - count + body.values.size());
+    auto* entries = table.values.begin();
+    for (size_t i = 0; i < pos; ++i) values.try_emplace(std::move(entries[i].first), std::move(entries[i].second));
+    for (auto& entry : body.values) values.try_emplace(std::move(entry.first), std::move(entry.second));
+    for (size_t i = pos + count; i < table.values.size(); ++i) {
+        values.try_emplace(std::move(entries[i].first), std::move(entries[i].second));
+    }
+    table.values = std::move(values);
+}
+
+size_t offset_in(const char* p, std::string_view text) { return static_cast<size_t>(p - text.data()); }
+
+} // namespace
+
+std::vector<KeyChange> diff(const Table& before, const Table& after) {
+    std::vector<KeyChange> changes;
+    Path path;
+    diff_tables(before, after, path, changes);
+    return changes;
+}
+
+bool TomlParser::reparse(TablePtr& document, std::string_view old_input, std::string_view input,
+                         const TextEdit& edit, std::vector<KeyChange>* changes) {
+    if (changes) changes->clear();
+    if (edit.offset > old_input.size() || edit.length > old_input.size() - edit.offset ||
+        edit.offset > input.size() || edit.replacement > input.size() - edit.offset ||
+        old_input.size() - edit.length != input.size() - edit.replacement) {
+        clear_error();
+        set_error_at(nullptr, ParseErrorCode::InvalidEdit, "Edit does not fit the old and new input");
+        return false;
+    }
+    // Views into old_input would outlive it in the sections that are kept
+    if (!options_.string_views && reparse_sections(*document, old_input, input, edit, changes)) return true;
+    TablePtr updated = parse(input);
+    if (!updated) return false;
+    if (changes) *changes = diff(*document, *updated);
+    document = std::move(updated);
+    return true;
+}
+
+bool TomlParser::reparse_sections(Table& document, std::string_view old_input, std::string_view input,
+                                  const TextEdit& edit, std::vector<KeyChange>* changes) {
+    std::vector<detail::Section> after;
+    set_input(input);
+    if (!index_sections(after)) return false;
+
+    // Sections that end before the edit are the same in old_input, as the
+    // scan only read text before it to find them. The ones after it are found
+    // by indexing old_input from the edit on until it reaches one of them.
+    size_t first = 0;
+    while (first < after.size() && offset_in(after[first].end, input) < edit.offset) ++first;
+    const size_t edit_end = edit.offset + edit.replacement;
+    size_t new_last = first;
+    while (new_last < after.size() && offset_in(after[new_last].begin, input) < edit_end) ++new_last;
+    std::vector<const char*> stop_at;
+    stop_at.reserve(after.size() - new_last);
+    for (size_t i = new_last; i < after.size(); ++i) {
+        stop_at.push_back(old_input.data() + offset_in(after[i].begin, input) - edit.replacement + edit.length);
+    }
+    std::vector<detail::Section> before;
+    const size_t old_begin = offset_in(after[first].begin, input);
+    set_input(old_input.substr(old_begin));
+    if (!index_sections(before, &stop_at)) return false;
+    // A scan that starts at a header begins with an empty section before it
+    if (first > 0) before.erase(before.begin());
+    auto stop = std::lower_bound(stop_at.begin(), stop_at.end(), before.back().end);
+    new_last += static_cast<size_t>(stop - stop_at.begin());
+    const size_t count = before.size();
+    if (new_last - first != count) return false;
+
+    // Parse the sections the edit touched, old and new, and check that their
+    // headers did not change
+    const char* error_pos = nullptr;
+    if (simd_utils::validate_input(after[first].begin, after[new_last - 1].end, &error_pos) !=
+        simd_utils::InputError::None) {
+        return false;
+    }
+    const size_t size = static_cast<size_t>(after[new_last - 1].end - after[first].begin);
+    std::shared_ptr<Arena> arena = options_.use_arena ? std::make_shared<Arena>(size) : nullptr;
+    for (size_t i = first; i < new_last; ++i) {
+        detail::Section& o = before[i - first];
+        detail::Section& n = after[i];
+        if (!parse_section(o, nullptr) || !parse_section(n, arena)) return false;
+        if (o.has_header != n.has_header || o.array_of_tables != n.array_of_tables || o.path != n.path) return false;
+    }
+
+    // Find the tables the touched sections' bodies went into by resolving
+    // every header of the document again
+    header_paths_.clear();
+    ReplayBuilder replay(document);
+    std::vector<Table*> targets(after.size(), &document);
+    std::vector<Path> paths(count);
+    std::vector<std::vector<Table*>> trails(count);
+    try {
+        for (size_t i = 1; i < after.size(); ++i) {
+            detail::Section& section = after[i];
+            const bool touched = i >= first && i < new_last;
+            set_input(std::string_view(section.begin, static_cast<size_t>(section.end - section.begin)));
+            statement_ = section.begin;
+            replay.start(i);
+            std::vector<std::string>& path = touched ? section.path : key_path(0);
+            bool array_of_tables = section.array_of_tables;
+            if (!touched && !parse_table_header(path, array_of_tables)) return false;
+            targets[i] = array_of_tables ? get_or_create_array_append_table(replay, path)
+                                         : get_or_create_table_at_path(replay, path);
+            if (!targets[i]) return false;
+            if (touched) {
+                paths[i - first] = replay.path();
+                trails[i - first] = replay.trail();
+            }
+        }
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    // A body can be put in place of the old one only if no other section put
+    // keys into the same table or its values there
+    std::unordered_map<const Table*, size_t> sections_per_target;
+    for (size_t i = first; i < new_last; ++i) sections_per_target.emplace(targets[i], 0);
+    for (Table* target : targets) {
+        auto it = sections_per_target.find(target);
+        if (it != sections_per_target.end() && ++it->second > 1) return false;
+    }
+    // nor with dotted keys from a table on the way there, which only input
+    // the parser accepts against the spec does
+    std::unordered_map<const Table*, std::vector<const std::string*>> on_the_way;
+    for (size_t i = first; i < new_last; ++i) {
+        const std::vector<Table*>& trail = trails[i - first];
+        for (size_t j = 0; j < trail.size(); ++j) on_the_way[trail[j]].push_back(&after[i].path[j]);
+    }
+    for (size_t i = 0; i < after.size(); ++i) {
+        auto it = i >= first && i < new_last ? on_the_way.end() : on_the_way.find(targets[i]);
+        if (it == on_the_way.end()) continue;
+        if (!parse_section(after[i], nullptr)) return false;
+        for (const std::string* key : it->second) {
+            if (after[i].body->values.find(*key) != after[i].body->values.end()) return false;
+        }
+        after[i].body.reset();
+    }
+    std::vector<size_t> positions(count);
+    for (size_t i = first; i < new_last; ++i) {
+        const Table& target = *targets[i];
+        const Table& old_body = *before[i - first].body;
+        const Table& new_body = *after[i].body;
+        for (const auto& entry : old_body.values) {
+            if (replay.touched_by(&target, entry.first) != ReplayBuilder::kNone) return false;
+        }
+        for (const auto& entry : new_body.values) {
+            if (replay.touched_by(&target, entry.first) != ReplayBuilder::kNone) return false;
+            if (old_body.values.find(entry.first) == old_body.values.end() &&
+                target.values.find(entry.first) != target.values.end()) {
+                return false;
+            }
+        }
+        const auto* entries = target.values.begin();
+        size_t pos = target.values.size();
+        if (old_body.values.empty()) {
+            // Only the tables of headers are there: the body goes before the
+            // first one a later section's header created
+            for (size_t j = 0; j < target.values.size(); ++j) {
+                const size_t by = replay.touched_by(&target, entries[j].first);
+                if (by == ReplayBuilder::kNone) return false;
+                if (by > i) {
+                    pos = j;
+                    break;
+                }
+            }
+        } else {
+            pos = static_cast<size_t>(target.values.find(old_body.values.begin()->first) - entries);
+            if (pos + old_body.values.size() > target.values.size()) return false;
+            const auto* old_entry = old_body.values.begin();
+            for (size_t j = pos; j < pos + old_body.values.size(); ++j, ++old_entry) {
+                if (entries[j].first != old_entry->first || !same_value(entries[j].second, old_entry->second)) {
+                    return false;
+                }
+            }
+        }
+        positions[i - first] = pos;
+    }
+
+    for (size_t i = first; i < new_last; ++i) {
+        Table& old_body = *before[i - first].body;
+        if (changes) diff_tables(old_body, *after[i].body, paths[i - first], *changes);
+        splice(*targets[i], positions[i - first], old_body.values.size(), *after[i].body);
+    }
+    clear_error();
+    return true;
+}
+
+} // namespace fasttoml
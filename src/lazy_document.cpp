@@ -0,0 +1,129 @@
+#include "fasttoml/lazy_document.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace fasttoml {
+
+// Skeleton builder: tables and arrays of tables become Table/array nodes,
+// every other value is kept as its input text (deferred)
+class LazyDocument::Builder {
+public:
+    using Value = std::string_view;
+    using TableRef = LazyDocument::Table*;
+    using ArrayRef = std::vector<uint32_t>*;
+
+    explicit Builder(LazyDocument& doc) : doc_(doc) {}
+
+    TableRef root() { return &doc_.tables_.front(); }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+        const Entry* found = t->find(key);
+        if (!found) return NodeKind::Missing;
+        const Entry& e = *found;
+        switch (e.kind) {
+            case Entry::Kind::Table:
+                table = &doc_.tables_[e.index];
+                return NodeKind::Table;
+            case Entry::Kind::TableArray:
+                array = &doc_.arrays_[e.index];
+                return NodeKind::Array;
+            default:
+                return NodeKind::Other;
+        }
+    }
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        const uint32_t i = new_table();
+        put(parent, key, Entry::Kind::Table).index = i;
+        return &doc_.tables_[i];
+    }
+
+    ArrayRef add_array(TableRef parent, const std::string& key) {
+        const uint32_t i = static_cast<uint32_t>(doc_.arrays_.size());
+        doc_.arrays_.emplace_back();
+        put(parent, key, Entry::Kind::TableArray).index = i;
+        return &doc_.arrays_[i];
+    }
+
+    TableRef append_table(ArrayRef array) {
+        const uint32_t i = new_table();
+        array->push_back(i);
+        return &doc_.tables_[i];
+    }
+
+    size_t array_size(ArrayRef array) const { return array->size(); }
+
+    // Arrays of the skeleton only ever hold tables
+    TableRef last_table(ArrayRef array) const { return &doc_.tables_[array->back()]; }
+
+    void set(TableRef t, const std::string& key, Value&& text) {
+        put(t, key, Entry::Kind::Value).text = text;
+    }
+
+    Value deferred(std::string_view text) { return text; }
+
+private:
+    uint32_t new_table() {
+        doc_.tables_.emplace_back();
+        return static_cast<uint32_t>(doc_.tables_.size() - 1);
+    }
+
+    // Tables with more entries than this get a hash index
+    static constexpr size_t kScanMax = 16;
+
+    // Entry for key, appended if new (a repeated key keeps its position)
+    Entry& put(TableRef t, const std::string& key, Entry::Kind kind) {
+        Entry* e = const_cast<Entry*>(t->find(key));
+        if (!e) {
+            char* stored = static_cast<char*>(doc_.keys_.allocate(key.size(), 1));
+            std::memcpy(stored, key.data(), key.size());
+            const uint32_t pos = static_cast<uint32_t>(t->entries.size());
+            t->entries.push_back(Entry{std::string_view(stored, key.size()), kind, {}, 0});
+            e = &t->entries.back();
+            if (!t->index.empty()) {
+                t->index.emplace(e->key, pos);
+            } else if (t->entries.size() > kScanMax) {
+                for (uint32_t i = 0; i < t->entries.size(); ++i) t->index.emplace(t->entries[i].key, i);
+            }
+            return *e;
+        }
+        *e = Entry{e->key, kind, {}, 0};
+        return *e;
+    }
+
+    LazyDocument& doc_;
+};
+
+LazyDocument::LazyDocument(std::string_view input, std::shared_ptr<const void> owner, const ParseOptions& options)
+    : owner_(std::move(owner)), input_(input), options_(options) {
+    tables_.emplace_back();
+}
+
+ParseResult LazyDocument::in_input(ParseResult result, std::string_view text) const {
+    const char* begin = input_.data();
+    const char* start = text.data();
+    if (result.line == 0 || start < begin || start > begin + input_.size()) return result;
+    // An error on the value's first line is further right by where it starts
+    if (result.line == 1) {
+        const char* line = start;
+        while (line > begin && line[-1] != '\n') --line;
+        result.column += static_cast<size_t>(start - line);
+    }
+    result.line += static_cast<size_t>(std::count(begin, start, '\n'));
+    result.offset += static_cast<size_t>(start - begin);
+    return result;
+}
+
+bool LazyDocument::value(const Entry& entry, TomlValue& out, std::string& error) const {
+    TreeBuilder builder;
+    return parse_value(entry, builder, out, error);
+}
+
+std::shared_ptr<LazyDocument> TomlParser::parse_lazy(std::string_view input, std::shared_ptr<const void> owner) {
+    std::shared_ptr<LazyDocument> doc(new LazyDocument(input, std::move(owner), options_));
+    LazyDocument::Builder builder(*doc);
+    if (!parse_with(input, builder)) return nullptr;
+    return doc;
+}
+
+} // namespace fasttoml
@@ -0,0 +1,143 @@
+#include "fasttoml/mapped_file.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fasttoml {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path, std::error_code& ec) {
+    close();
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (wlen <= 0) {
+        ec.assign(static_cast<int>(GetLastError()), std::system_category());
+        return false;
+    }
+    std::wstring wpath(static_cast<size_t>(wlen), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wlen);
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        ec.assign(static_cast<int>(GetLastError()), std::system_category());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        ec.assign(static_cast<int>(GetLastError()), std::system_category());
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        // Empty files cannot be mapped; an empty view parses as an empty document
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        ec.assign(static_cast<int>(GetLastError()), std::system_category());
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        ec.assign(static_cast<int>(GetLastError()), std::system_category());
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, std::error_code& ec) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ec.assign(errno, std::system_category());
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ec.assign(errno, std::system_category());
+        ::close(fd);
+        return false;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        ec.assign(EISDIR, std::system_category());
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        // Pipes and character devices cannot be mapped: read them into a buffer
+        char chunk[65536];
+        for (;;) {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n == 0) break;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ec.assign(errno, std::system_category());
+                ::close(fd);
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+        }
+        ::close(fd);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+    if (st.st_size == 0) {
+        // Empty files cannot be mapped; an empty view parses as an empty document
+        ::close(fd);
+        return true;
+    }
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        ec.assign(errno, std::system_category());
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+    data_ = static_cast<const char*>(p);
+    size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ && data_ != buffer_.data()) munmap(const_cast<char*>(data_), size_);
+    buffer_.clear();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+} // namespace fasttoml
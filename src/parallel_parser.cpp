@@ -0,0 +1,283 @@
+#include "fasttoml/toml_parser.hpp"
+#include "fasttoml/sections.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace fasttoml {
+namespace detail {
+
+// Builds a section into a detached table. add_table is only reached through
+// dotted keys, as a header inside a section means the split went wrong.
+class SectionBuilder : public TreeBuilder {
+public:
+    SectionBuilder(std::shared_ptr<Arena> arena, ImplicitTables& implicit)
+        : TreeBuilder(std::move(arena)), implicit_(implicit) {}
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        TableRef t = TreeBuilder::add_table(parent, key);
+        implicit_[parent].try_emplace(key, std::get<TablePtr>(parent->values.find(key)->second));
+        return t;
+    }
+
+    void header(const std::vector<std::string>&, bool) {
+        throw std::logic_error("Table header inside a section");
+    }
+
+private:
+    ImplicitTables& implicit_;
+};
+
+// Builds the document from its sections on the calling thread. The table a
+// header creates is empty, so the section's body takes its place (adopt())
+// instead of being merged into it.
+class MergeBuilder : public TreeBuilder {
+public:
+    MergeBuilder(std::shared_ptr<Arena> arena, TablePtr root) : TreeBuilder(std::move(arena), std::move(root)) {}
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        created_ = TreeBuilder::add_table(parent, key);
+        slot_ = &parent->values.find(key)->second;
+        return created_;
+    }
+
+    TableRef append_table(ArrayRef array) {
+        created_ = TreeBuilder::append_table(array);
+        slot_ = &array->mutable_values().back();
+        return created_;
+    }
+
+    // Put body in place of table if the last header resolved created it
+    bool adopt(TableRef table, TablePtr& body) {
+        const bool created = table == created_;
+        if (created) *slot_ = std::move(body);
+        created_ = nullptr;
+        return created;
+    }
+
+private:
+    TableRef created_ = nullptr;
+    TomlValue* slot_ = nullptr;
+};
+
+namespace {
+
+// Move the entries of body into target as if body's lines had been parsed
+// into target: new keys are appended, a key body set directly replaces the
+// old value, and the keys of a table body created implicitly go into the
+// table target already has. False if target's value there is not a table.
+bool merge_tables(Table& target, Table& body, const ImplicitTables& implicit) {
+    auto created = implicit.find(&body);
+    for (auto& entry : body.values) {
+        // body is dropped afterwards, so its keys can be moved
+        auto inserted = target.values.try_emplace(std::move(entry.first), std::move(entry.second));
+        if (inserted.second) continue;
+        TomlValue& old = inserted.first->second;
+        const TablePtr* first = nullptr;
+        if (created != implicit.end()) {
+            auto it = created->second.find(inserted.first->first);
+            if (it != created->second.end()) first = &it->second;
+        }
+        if (!first) {
+            old = std::move(entry.second);
+            continue;
+        }
+        // The section's first line for this key went through it with a dotted key
+        auto* table = std::get_if<TablePtr>(&old);
+        if (!table) return false;
+        auto* current = std::get_if<TablePtr>(&entry.second);
+        if (current && *current == *first) {
+            if (!merge_tables(**table, **current, implicit)) return false;
+        } else {
+            old = std::move(entry.second);
+        }
+    }
+    return true;
+}
+
+// Chunks of consecutive sections handed to the threads; several per thread so
+// that sections of uneven size even out, but not so small that scheduling shows
+constexpr size_t kChunksPerThread = 4;
+constexpr size_t kMinChunkSize = 64 * 1024;
+
+} // namespace
+} // namespace detail
+
+bool TomlParser::index_sections(std::vector<detail::Section>& sections, const std::vector<const char*>* stop_at) {
+    sections.emplace_back(current_, end_, false);
+    // Bracket nesting (arrays, inline tables, headers); a '[' starts a header
+    // only at the start of a line outside of them, as for the parser
+    int depth = 0;
+    bool line_start = true;
+    const char* p = current_;
+    while (p < end_) {
+        if (line_start) {
+            line_start = false;
+            p = simd_utils::skip_whitespace_no_nl(p, end_);
+            if (p < end_ && *p == '[' && depth == 0) {
+                sections.back().end = p;
+                if (stop_at && std::binary_search(stop_at->begin(), stop_at->end(), p)) return true;
+                sections.emplace_back(p, end_, true);
+            }
+        }
+        p = simd_utils::find_structural(p, end_);
+        if (p == end_) break;
+        switch (*p) {
+            case '"':
+            case '\'':
+                current_ = p;
+                if (!skip_string()) return false;
+                p = current_;
+                break;
+            case '#': {
+                const void* nl = std::memchr(p, '\n', static_cast<size_t>(end_ - p));
+                p = nl ? static_cast<const char*>(nl) : end_;
+                break;
+            }
+            case '[':
+            case '{':
+                ++depth;
+                ++p;
+                break;
+            case ']':
+            case '}':
+                // Stray closers are errors the section's parse will report
+                if (depth > 0) --depth;
+                ++p;
+                break;
+            default:  // '\n'
+                line_start = true;
+                ++p;
+        }
+    }
+    return true;
+}
+
+bool TomlParser::parse_section(detail::Section& section, const std::shared_ptr<Arena>& arena) {
+    set_input(std::string_view(section.begin, static_cast<size_t>(section.end - section.begin)));
+    header_paths_.clear();
+    inline_depth_ = 0;
+    detail::SectionBuilder builder(arena, section.implicit);
+    try {
+        if (section.has_header && !parse_table_header(section.path, section.array_of_tables)) return false;
+        parse_document(builder);
+    } catch (const std::exception&) {
+        return false;
+    }
+    section.body = builder.document();
+    return !has_error();
+}
+
+bool TomlParser::merge_section(detail::MergeBuilder& builder, detail::Section& section) {
+    Table* target = builder.root();
+    if (section.has_header) {
+        statement_ = section.begin;
+        target = section.array_of_tables ? get_or_create_array_append_table(builder, section.path)
+                                         : get_or_create_table_at_path(builder, section.path);
+        if (!target) return false;
+    }
+    const bool ok = builder.adopt(target, section.body) ||
+                    detail::merge_tables(*target, *section.body, section.implicit);
+    section.body.reset();
+    section.implicit.clear();
+    return ok;
+}
+
+std::shared_ptr<Table> TomlParser::parse_parallel(std::string_view input, unsigned threads) {
+    if (!begin_parse(input)) return nullptr;
+    std::vector<detail::Section> sections;
+    if (!index_sections(sections)) return nullptr;
+
+    // Chunk c holds sections [chunk_ends[c - 1], chunk_ends[c])
+    const size_t target = std::max(input.size() / (threads * detail::kChunksPerThread), detail::kMinChunkSize);
+    std::vector<size_t> chunk_ends;
+    size_t bytes = 0;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        bytes += static_cast<size_t>(sections[i].end - sections[i].begin);
+        if (bytes >= target || i + 1 == sections.size()) {
+            chunk_ends.push_back(i + 1);
+            bytes = 0;
+        }
+    }
+    const size_t n = chunk_ends.size();
+    if (n < 2) return nullptr;
+    if (threads > n) threads = static_cast<unsigned>(n);
+
+    std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[n]());
+    std::unique_ptr<bool[]> failed(new bool[n]());
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    // Parse the next chunk with parser, in an arena of its own so that no two
+    // threads allocate from one; false when no chunk is left
+    auto take = [&](TomlParser& parser) {
+        const size_t c = next.fetch_add(1);
+        if (c >= n) return false;
+        const size_t first = c ? chunk_ends[c - 1] : 0;
+        const size_t size = static_cast<size_t>(sections[chunk_ends[c] - 1].end - sections[first].begin);
+        std::shared_ptr<Arena> arena = options_.use_arena ? std::make_shared<Arena>(size) : nullptr;
+        bool ok = true;
+        for (size_t i = first; ok && i < chunk_ends[c]; ++i) ok = parser.parse_section(sections[i], arena);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed[c] = !ok;
+            done[c] = true;
+        }
+        ready.notify_all();
+        return true;
+    };
+
+    std::vector<std::thread> pool;
+    auto join_all = [&]() {
+        next = n;
+        for (auto& t : pool) t.join();
+        pool.clear();
+    };
+    try {
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back([&]() {
+                TomlParser parser(options_);
+                while (take(parser)) {}
+            });
+        }
+        // This thread parses chunks too while it waits, and adds each finished
+        // chunk to the document in order; the root section becomes its root
+        TomlParser parser(options_);
+        std::shared_ptr<Arena> arena = options_.use_arena ? acquire_arena(Arena::kDefaultBlockSize) : nullptr;
+        std::optional<detail::MergeBuilder> builder;
+        for (size_t c = 0; c < n; ++c) {
+            while (!done[c] && take(parser)) {}
+            if (!done[c]) {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return done[c].load(); });
+            }
+            if (failed[c]) {
+                join_all();
+                return nullptr;
+            }
+            for (size_t i = c ? chunk_ends[c - 1] : 1; i < chunk_ends[c]; ++i) {
+                if (!builder) {
+                    builder.emplace(arena, std::move(sections[0].body));
+                    sections[0].implicit.clear();
+                }
+                if (!merge_section(*builder, sections[i])) {
+                    join_all();
+                    return nullptr;
+                }
+            }
+        }
+        join_all();
+        return builder->document();
+    } catch (...) {
+        join_all();
+        throw;
+    }
+}
+
+} // namespace fasttoml
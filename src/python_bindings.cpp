@@ -1,30 +1,184 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/chrono.h>
+#include <datetime.h>
 #include "fasttoml/toml_parser.hpp"
+#include "fasttoml/lazy_document.hpp"
+#include "fasttoml/mapped_file.hpp"
+#include "fasttoml/selection.hpp"
+#include "fasttoml/snapshot.hpp"
+#include "fasttoml/stream_parser.hpp"
+#include "fasttoml/toml_writer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 namespace py = pybind11;
 using namespace fasttoml;
 
+// Civil date from days since 1970-01-01 (proleptic Gregorian, H. Hinnant's algorithm)
+static void civil_from_days(int64_t z, int& y, int& m, int& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    y = static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+}
+
+// datetime C API state, set up once in module init. Timezone objects are
+// interned per distinct offset and intentionally never released (at most
+// 2 * 24 * 60 of them), so they stay valid through interpreter shutdown.
+struct DateTimeCache {
+    std::unordered_map<int, PyObject*> timezones;
+
+    PyObject* timezone(int offset_minutes) {
+        if (offset_minutes == 0) return PyDateTime_TimeZone_UTC;
+        auto it = timezones.find(offset_minutes);
+        if (it != timezones.end()) return it->second;
+        py::object delta = py::reinterpret_steal<py::object>(PyDelta_FromDSU(0, offset_minutes * 60, 0));
+        if (!delta) throw py::error_already_set();
+        PyObject* tz = PyTimeZone_FromOffset(delta.ptr());
+        if (!tz) throw py::error_already_set();
+        timezones.emplace(offset_minutes, tz);
+        return tz;
+    }
+};
+
+static DateTimeCache* datetime_cache = nullptr;
+
+// Aware datetime for a UTC instant shown at the given offset; microsecond
+// precision, fields computed directly instead of going through a float timestamp
+static py::object make_datetime(DateTime utc, int offset_minutes) {
+    namespace sc = std::chrono;
+    int64_t us = sc::duration_cast<sc::microseconds>(utc.time_since_epoch()).count() +
+                 int64_t(offset_minutes) * 60 * 1000000;
+    int64_t secs = us >= 0 ? us / 1000000 : -((-us + 999999) / 1000000);
+    int micro = static_cast<int>(us - secs * 1000000);
+    int64_t days = secs >= 0 ? secs / 86400 : -((-secs + 86399) / 86400);
+    int sod = static_cast<int>(secs - days * 86400);
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    PyObject* dt = PyDateTimeAPI->DateTime_FromDateAndTime(
+        year, month, day, sod / 3600, (sod / 60) % 60, sod % 60, micro,
+        datetime_cache->timezone(offset_minutes), PyDateTimeAPI->DateTimeType);
+    if (!dt) throw py::error_already_set();
+    return py::reinterpret_steal<py::object>(dt);
+}
+
+// Python str objects for keys, one per distinct key text of a parse (or of a
+// Parser's or batch's documents): repeated keys, such as the few keys of every
+// [[package]] entry, share one object, whose hash is then computed once for
+// all the dicts it goes into. The first kMaxKeys distinct keys are kept.
+class KeyCache {
+public:
+    static constexpr size_t kMaxKeys = 64 * 1024;
+
+    py::object get(std::string_view key) {
+        auto it = keys_.find(key);
+        if (it != keys_.end()) return it->second;
+        py::str k(key.data(), key.size());
+        if (keys_.size() < kMaxKeys) keys_.try_emplace(key, k);
+        return std::move(k);
+    }
+
+    // Drop the keys once more than keep are cached (between documents)
+    void trim(size_t keep) {
+        if (keys_.size() > keep) keys_.clear();
+    }
+
+private:
+    TableMap<py::object> keys_;
+};
+
 // Forward declaration
-py::object toml_value_to_python(const TomlValue& value);
+py::object toml_value_to_python(const TomlValue& value, KeyCache& keys, bool numeric_buffers = false);
 
 // Convert C++ Table to Python dict
-py::dict table_to_dict(const Table& table) {
+py::dict table_to_dict(const Table& table, KeyCache& keys, bool numeric_buffers = false) {
     py::dict result;
     
     for (const auto& [key, value] : table.values) {
-        result[py::str(key)] = toml_value_to_python(value);
+        py::object v = toml_value_to_python(value, keys, numeric_buffers);
+        if (PyDict_SetItem(result.ptr(), keys.get(key).ptr(), v.ptr()) < 0) throw py::error_already_set();
     }
     
     return result;
 }
 
+// array.array type, imported on first use and kept for the process lifetime
+static PyObject* array_type() {
+    static PyObject* type = nullptr;
+    if (!type) {
+        py::object module = py::reinterpret_steal<py::object>(PyImport_ImportModule("array"));
+        if (!module) throw py::error_already_set();
+        type = PyObject_GetAttrString(module.ptr(), "array");
+        if (!type) throw py::error_already_set();
+    }
+    return type;
+}
+
+// array.array of typecode holding a copy of n items of size bytes at data
+static py::object make_number_array(const char* typecode, const void* data, size_t n, size_t size) {
+    py::object result = py::reinterpret_steal<py::object>(PyObject_CallFunction(array_type(), "s", typecode));
+    if (!result) throw py::error_already_set();
+    if (n == 0) return result;
+    py::object view = py::reinterpret_steal<py::object>(
+        PyMemoryView_FromMemory(static_cast<char*>(const_cast<void*>(data)), static_cast<Py_ssize_t>(n * size), PyBUF_READ));
+    if (!view) throw py::error_already_set();
+    py::object none = py::reinterpret_steal<py::object>(PyObject_CallMethod(result.ptr(), "frombytes", "O", view.ptr()));
+    if (!none) throw py::error_already_set();
+    return result;
+}
+
+// Convert C++ Array to Python list; packed numbers are converted in one loop,
+// or copied into an array.array ('q' or 'd') with numeric_buffers
+py::object array_to_python(const Array& array, KeyCache& keys, bool numeric_buffers) {
+    if (array.storage() == Array::Storage::Values) {
+        py::list result;
+        for (const auto& elem : array.values()) result.append(toml_value_to_python(elem, keys, numeric_buffers));
+        return result;
+    }
+    if (numeric_buffers) {
+        if (array.storage() == Array::Storage::Integers) {
+            return make_number_array("q", array.integers().data(), array.size(), sizeof(Integer));
+        }
+        return make_number_array("d", array.floats().data(), array.size(), sizeof(Float));
+    }
+    const size_t n = array.size();
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(n));
+    if (!list) throw py::error_already_set();
+    py::list result = py::reinterpret_steal<py::list>(list);
+    const bool integers = array.storage() == Array::Storage::Integers;
+    for (size_t i = 0; i < n; ++i) {
+        PyObject* item = integers ? PyLong_FromLongLong(array.integers()[i]) : PyFloat_FromDouble(array.floats()[i]);
+        if (!item) throw py::error_already_set();
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return result;
+}
+
 // Convert C++ TomlValue to Python object
-py::object toml_value_to_python(const TomlValue& value) {
-    return std::visit([](auto&& arg) -> py::object {
+py::object toml_value_to_python(const TomlValue& value, KeyCache& keys, bool numeric_buffers) {
+    return std::visit([&keys, numeric_buffers](auto&& arg) -> py::object {
         using T = std::decay_t<decltype(arg)>;
         
         if constexpr (std::is_same_v<T, Integer>) {
@@ -35,52 +189,1332 @@ py::object toml_value_to_python(const TomlValue& value) {
             return py::cast(arg);
         } else if constexpr (std::is_same_v<T, String>) {
             return py::cast(arg);
+        } else if constexpr (std::is_same_v<T, StringView>) {
+            return py::str(arg.data(), arg.size());
         } else if constexpr (std::is_same_v<T, DateTime>) {
             // Return datetime in UTC (Z)
-            namespace sc = std::chrono;
-            auto epoch = sc::system_clock::from_time_t(0);
-            double secs = sc::duration_cast<sc::duration<double>>(arg - epoch).count();
-            py::module_ datetime = py::module_::import("datetime");
-            py::object utc = datetime.attr("timezone").attr("utc");
-            return datetime.attr("datetime").attr("fromtimestamp")(py::cast(secs), utc);
+            return make_datetime(arg, 0);
         } else if constexpr (std::is_same_v<T, DateTimeOffset>) {
             // Return datetime with original offset for correct RFC 3339 output
-            namespace sc = std::chrono;
-            auto epoch = sc::system_clock::from_time_t(0);
-            double secs = sc::duration_cast<sc::duration<double>>(arg.utc - epoch).count();
-            py::module_ datetime = py::module_::import("datetime");
-            py::object tz = datetime.attr("timezone")(datetime.attr("timedelta")(py::arg("minutes") = arg.offset_minutes));
-            return datetime.attr("datetime").attr("fromtimestamp")(py::cast(secs), tz);
+            return make_datetime(arg.utc, arg.offset_minutes);
+        } else if constexpr (std::is_same_v<T, LocalDate> || std::is_same_v<T, LocalTime> ||
+                             std::is_same_v<T, LocalDateTime>) {
+            // Local values stay RFC 3339 strings (see README)
+            char buf[writer::kLocalSize];
+            return py::str(buf, writer::format_local(buf, arg));
         } else if constexpr (std::is_same_v<T, TablePtr>) {
-            return table_to_dict(*arg);
+            return table_to_dict(*arg, keys, numeric_buffers);
         } else if constexpr (std::is_same_v<T, ArrayPtr>) {
-            py::list result;
-            for (const auto& elem : arg->elements) {
-                result.append(toml_value_to_python(elem));
-            }
-            return result;
+            return array_to_python(*arg, keys, numeric_buffers);
         }
     }, value);
 }
 
-// Python loads function
-py::dict loads(const std::string& toml_string) {
-    TomlParser parser;
-    auto table = parser.parse(toml_string);
+// Builds the Python dict/list tree while parsing, so no C++ document is
+// ever materialized. Container handles are borrowed: each dict/list is owned
+// by its parent (or by root_) before the parser sees its handle. Keys come
+// from keys, so each distinct key is one str object.
+class PyBuilder {
+public:
+    using Value = py::object;
+    using TableRef = PyObject*;
+    using ArrayRef = PyObject*;
+
+    explicit PyBuilder(KeyCache& keys) : keys_(keys) {}
+
+    py::dict document() const { return root_; }
+
+    TableRef root() { return root_.ptr(); }
+
+    NodeKind find(TableRef t, const std::string& key, TableRef& table, ArrayRef& array) {
+        py::object k = keys_.get(key);
+        PyObject* v = PyDict_GetItemWithError(t, k.ptr());
+        if (!v) {
+            if (PyErr_Occurred()) throw py::error_already_set();
+            return NodeKind::Missing;
+        }
+        if (PyDict_CheckExact(v)) {
+            table = v;
+            return NodeKind::Table;
+        }
+        if (PyList_CheckExact(v)) {
+            array = v;
+            return NodeKind::Array;
+        }
+        return NodeKind::Other;
+    }
+
+    TableRef add_table(TableRef parent, const std::string& key) {
+        py::dict d;
+        set_item(parent, key, d);
+        return d.ptr();
+    }
+
+    ArrayRef add_array(TableRef parent, const std::string& key) {
+        py::list l;
+        set_item(parent, key, l);
+        return l.ptr();
+    }
+
+    TableRef append_table(ArrayRef array) {
+        py::dict d;
+        append_item(array, d);
+        return d.ptr();
+    }
+
+    size_t array_size(ArrayRef array) const { return static_cast<size_t>(PyList_GET_SIZE(array)); }
+
+    TableRef last_table(ArrayRef array) const {
+        PyObject* last = PyList_GET_ITEM(array, PyList_GET_SIZE(array) - 1);
+        return PyDict_CheckExact(last) ? last : nullptr;
+    }
+
+    Value new_table(TableRef& out) {
+        py::dict d;
+        out = d.ptr();
+        return std::move(d);
+    }
+
+    Value new_array(ArrayRef& out) {
+        py::list l;
+        out = l.ptr();
+        return std::move(l);
+    }
+
+    void append(ArrayRef array, Value&& value) { append_item(array, value); }
+
+    void set(TableRef t, const std::string& key, Value&& value) { set_item(t, key, value); }
+
+    Value scalar(TomlValue&& value) { return toml_value_to_python(value, keys_); }
+
+private:
+    void set_item(PyObject* dict, const std::string& key, const py::handle& value) {
+        py::object k = keys_.get(key);
+        if (PyDict_SetItem(dict, k.ptr(), value.ptr()) < 0) throw py::error_already_set();
+    }
+
+    static void append_item(PyObject* list, const py::handle& value) {
+        if (PyList_Append(list, value.ptr()) < 0) throw py::error_already_set();
+    }
+
+    KeyCache& keys_;
+    py::dict root_;
+};
+
+// fasttoml.TOMLDecodeError (a ValueError) and its attribute names, created in module init
+static PyObject* decode_error_type = nullptr;
+static PyObject* decode_error_attrs[4];  // msg, pos, lineno, colno
+
+// Characters of UTF-8 text [p, end)
+static size_t utf8_chars(const char* p, const char* end) {
+    return static_cast<size_t>(std::count_if(p, end, [](char c) { return (c & 0xC0) != 0x80; }));
+}
+
+// Raise TOMLDecodeError for a failed parse of input, with the position in the
+// message and as pos/lineno/colno attributes (None without a position). For
+// str input (text) pos and colno count characters, otherwise bytes. input may
+// be the rest of a stream whose first skipped_bytes (skipped_chars) were
+// dropped at a line start; result then counts from the start of the stream.
+[[noreturn]] static void throw_decode_error(const std::string& prefix, const std::string& message,
+                                            const ParseResult& result, std::string_view input, bool text,
+                                            size_t skipped_bytes = 0, size_t skipped_chars = 0) {
+    const bool located = result.line != 0;
+    size_t pos = result.offset;
+    size_t colno = result.column;
+    if (text && located && result.offset >= skipped_bytes && result.offset - skipped_bytes <= input.size()) {
+        const char* at = input.data() + (result.offset - skipped_bytes);
+        pos = skipped_chars + utf8_chars(input.data(), at);
+        colno = 1 + utf8_chars(at - (result.column - 1), at);
+    }
+    std::string what = prefix + message;
+    if (located) what += " (line " + std::to_string(result.line) + ", column " + std::to_string(colno) + ")";
+    py::object error = py::reinterpret_steal<py::object>(PyObject_CallOneArg(decode_error_type, py::str(what).ptr()));
+    if (!error) throw py::error_already_set();
+    auto number = [located](size_t value) {
+        return py::reinterpret_steal<py::object>(located ? PyLong_FromSize_t(value) : Py_NewRef(Py_None));
+    };
+    const py::object values[4] = {py::str(message), number(pos), number(result.line), number(colno)};
+    for (int i = 0; i < 4; ++i) {
+        if (!values[i] || PyObject_SetAttr(error.ptr(), decode_error_attrs[i], values[i].ptr()) < 0) {
+            throw py::error_already_set();
+        }
+    }
+    PyErr_SetObject(decode_error_type, error.ptr());
+    throw py::error_already_set();
+}
+
+[[noreturn]] static void throw_parse_error(const TomlParser& parser, std::string_view input, bool text) {
+    throw_decode_error("TOML parse error: ", parser.has_error() ? parser.get_error() : "unknown error",
+                       parser.result(), input, text);
+}
+
+[[noreturn]] static void throw_errno_error(const std::string& path, int error) {
+    errno = error;
+    PyErr_SetFromErrnoWithFilename(PyExc_OSError, path.c_str());
+    throw py::error_already_set();
+}
+
+// ec as filled in by MappedFile::open
+[[noreturn]] static void throw_os_error(const std::string& path, const std::error_code& ec) {
+#ifdef _WIN32
+    PyErr_SetExcFromWindowsErrWithFilename(PyExc_OSError, ec.value(), path.c_str());
+    throw py::error_already_set();
+#else
+    throw_errno_error(path, ec.value());
+#endif
+}
+
+// Selection for the select= argument (an iterable of key paths); nullopt for None
+static std::optional<Selection> make_selection(const py::object& select) {
+    if (select.is_none()) return std::nullopt;
+    if (PyUnicode_Check(select.ptr())) {
+        throw py::type_error("select must be an iterable of key paths, not a single str");
+    }
+    py::object it = py::reinterpret_steal<py::object>(PyObject_GetIter(select.ptr()));
+    if (!it) throw py::error_already_set();
+    Selection selection;
+    std::string error;
+    while (PyObject* item = PyIter_Next(it.ptr())) {
+        py::object path = py::reinterpret_steal<py::object>(item);
+        if (!PyUnicode_Check(item)) throw py::type_error("select paths must be str");
+        Py_ssize_t size;
+        const char* data = PyUnicode_AsUTF8AndSize(item, &size);
+        if (!data) throw py::error_already_set();
+        if (!selection.add(std::string_view(data, static_cast<size_t>(size)), error)) throw py::value_error(error);
+    }
+    if (PyErr_Occurred()) throw py::error_already_set();
+    return selection;
+}
+
+// Options of the parsers behind loads and friends. Scalars are converted right
+// away and C++ trees dropped after conversion, so strings can point into the
+// input; trees (inputs parsed without the GIL) are built in an arena, on
+// `threads` threads for large documents.
+static ParseOptions python_options(unsigned threads = 1) {
+    ParseOptions options;
+    options.use_arena = true;
+    options.string_views = true;
+    options.threads = threads;
+    return options;
+}
+
+// Parse a buffer that stays valid and unchanged for the whole call with the
+// GIL released: the document goes into an arena-backed C++ tree whose strings
+// point into the buffer, and only the conversion to dict runs under the GIL.
+// With a selection only the selected parts are built; with numeric_buffers
+// packed numeric arrays become array.array objects.
+static py::dict parse_buffer_nogil(TomlParser& parser, std::string_view input, bool text,
+                                   const std::optional<Selection>& selection, bool numeric_buffers, KeyCache& keys) {
+    TablePtr table;
+    {
+        py::gil_scoped_release release;
+        table = selection ? parser.parse_selected(input, *selection) : parser.parse(input);
+    }
+    if (!table) throw_parse_error(parser, input, text);
+    return table_to_dict(*table, keys, numeric_buffers);
+}
+
+// Inputs at least this large are parsed with the GIL released (C++ tree, then
+// conversion); smaller ones are built directly, where the GIL round trip and
+// second traversal would cost more than other threads gain.
+static constexpr size_t kReleaseGilMinSize = 64 * 1024;
+
+// loads with a given parser (toml_string is the str's UTF-8 buffer, not a copy)
+static py::dict parse_str(TomlParser& parser, std::string_view toml_string, const py::object& select,
+                          bool numeric_buffers, KeyCache& keys) {
+    const std::optional<Selection> selection = make_selection(select);
+    // Packed arrays only exist in the C++ tree
+    if (toml_string.size() >= kReleaseGilMinSize || numeric_buffers) {
+        // str objects are immutable, so the buffer is stable without the GIL
+        return parse_buffer_nogil(parser, toml_string, true, selection, numeric_buffers, keys);
+    }
+    PyBuilder builder(keys);
     
-    if (!table) {
-        if (parser.has_error()) {
-            throw std::runtime_error("TOML parse error: " + parser.get_error());
+    bool ok;
+    if (selection) {
+        SelectBuilder<PyBuilder> selected(builder, *selection);
+        ok = parser.parse_with(toml_string, selected);
+    } else {
+        ok = parser.parse_with(toml_string, builder);
+    }
+    if (!ok) throw_parse_error(parser, toml_string, true);
+    
+    return builder.document();
+}
+
+// loads_bytes with a given parser: any contiguous bytes-like object, in place
+static py::dict parse_bytes(TomlParser& parser, const py::buffer& data, const py::object& select,
+                            bool numeric_buffers, KeyCache& keys) {
+    const std::optional<Selection> selection = make_selection(select);
+    py::buffer_info info = data.request();
+    if (info.ndim != 1 || info.itemsize != 1 || info.strides[0] != 1) {
+        throw py::type_error("loads_bytes() argument must be a C-contiguous bytes-like object");
+    }
+    return parse_buffer_nogil(parser,
+                              std::string_view(static_cast<const char*>(info.ptr), static_cast<size_t>(info.size)),
+                              false, selection, numeric_buffers, keys);
+}
+
+// load_path with a given parser: the file is read through a read-only memory mapping
+static py::dict parse_path(TomlParser& parser, const std::string& path, const py::object& select,
+                           bool numeric_buffers, KeyCache& keys) {
+    const std::optional<Selection> selection = make_selection(select);
+    MappedFile file;
+    std::error_code ec;
+    bool ok;
+    {
+        py::gil_scoped_release release;
+        ok = file.open(path, ec);
+    }
+    if (!ok) throw_os_error(path, ec);
+    return parse_buffer_nogil(parser, file.data(), false, selection, numeric_buffers, keys);
+}
+
+// Python loads function
+py::dict loads(std::string_view toml_string, const py::object& select, bool numeric_buffers, unsigned threads) {
+    TomlParser parser(python_options(threads));
+    KeyCache keys;
+    return parse_str(parser, toml_string, select, numeric_buffers, keys);
+}
+
+// Parse UTF-8 TOML from any contiguous bytes-like object, in place
+py::dict loads_bytes(const py::buffer& data, const py::object& select, bool numeric_buffers, unsigned threads) {
+    TomlParser parser(python_options(threads));
+    KeyCache keys;
+    return parse_bytes(parser, data, select, numeric_buffers, keys);
+}
+
+// Parse a TOML file through a read-only memory mapping
+py::dict load_path(const std::string& path, const py::object& select, bool numeric_buffers, unsigned threads) {
+    TomlParser parser(python_options(threads));
+    KeyCache keys;
+    return parse_path(parser, path, select, numeric_buffers, keys);
+}
+
+// stats=True: the parse is profiled with the GIL released, then the
+// conversion is timed; (dict, stats dict)
+static py::object parse_profiled(std::string_view input, bool text, bool numeric_buffers) {
+    TomlParser parser(python_options());
+    ParseStats stats;
+    TablePtr table;
+    {
+        py::gil_scoped_release release;
+        table = parser.parse(input, stats);
+    }
+    if (!table) throw_parse_error(parser, input, text);
+    KeyCache keys;
+    const uint64_t start = detail::stats_clock();
+    py::dict result = table_to_dict(*table, keys, numeric_buffers);
+    stats.convert_ns = detail::stats_clock() - start;
+
+    py::dict counters;
+    const std::pair<const char*, uint64_t> fields[] = {
+        {"bytes", stats.bytes},
+        {"integers", stats.integers},
+        {"floats", stats.floats},
+        {"booleans", stats.booleans},
+        {"strings", stats.strings},
+        {"datetimes", stats.datetimes},
+        {"arrays", stats.arrays},
+        {"inline_tables", stats.inline_tables},
+        {"tables", stats.tables},
+        {"array_tables", stats.array_tables},
+        {"keys", stats.keys},
+        {"max_depth", stats.max_depth},
+        {"arena_bytes", stats.arena_bytes},
+        {"arena_blocks", stats.arena_blocks},
+        {"arena_reserved", stats.arena_reserved},
+        {"validate_ns", stats.validate_ns},
+        {"strings_ns", stats.strings_ns},
+        {"numbers_ns", stats.numbers_ns},
+        {"datetimes_ns", stats.datetimes_ns},
+        {"tables_ns", stats.tables_ns},
+        {"parse_ns", stats.total_ns},
+        {"convert_ns", stats.convert_ns},
+    };
+    for (const auto& [name, value] : fields) {
+        py::object number = py::reinterpret_steal<py::object>(PyLong_FromUnsignedLongLong(value));
+        if (!number || PyDict_SetItemString(counters.ptr(), name, number.ptr()) < 0) throw py::error_already_set();
+    }
+    PyObject* item = PyTuple_Pack(2, result.ptr(), counters.ptr());
+    if (!item) throw py::error_already_set();
+    return py::reinterpret_steal<py::object>(item);
+}
+
+py::object loads_stats(std::string_view toml_string, bool numeric_buffers) {
+    return parse_profiled(toml_string, true, numeric_buffers);
+}
+
+py::object loads_bytes_stats(const py::buffer& data, bool numeric_buffers) {
+    py::buffer_info info = data.request();
+    if (info.ndim != 1 || info.itemsize != 1 || info.strides[0] != 1) {
+        throw py::type_error("loads_bytes() argument must be a C-contiguous bytes-like object");
+    }
+    return parse_profiled(std::string_view(static_cast<const char*>(info.ptr), static_cast<size_t>(info.size)), false,
+                          numeric_buffers);
+}
+
+py::object load_path_stats(const std::string& path, bool numeric_buffers) {
+    MappedFile file;
+    std::error_code ec;
+    bool ok;
+    {
+        py::gil_scoped_release release;
+        ok = file.open(path, ec);
+    }
+    if (!ok) throw_os_error(path, ec);
+    return parse_profiled(file.data(), false, numeric_buffers);
+}
+
+// Convert a snapshot table to a dict, reading the snapshot in place
+static py::dict snapshot_to_dict(const SnapshotTable& table, KeyCache& keys);
+
+static py::object snapshot_to_python(const SnapshotValue& value, KeyCache& keys) {
+    switch (value.type()) {
+        case SnapshotValue::Type::Table:
+            return snapshot_to_dict(value.as_table(), keys);
+        case SnapshotValue::Type::Array: {
+            const SnapshotArray array = value.as_array();
+            PyObject* list = PyList_New(static_cast<Py_ssize_t>(array.size()));
+            if (!list) throw py::error_already_set();
+            py::object result = py::reinterpret_steal<py::object>(list);
+            for (size_t i = 0; i < array.size(); ++i) {
+                PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), Py_NewRef(snapshot_to_python(array.at(i), keys).ptr()));
+            }
+            return result;
+        }
+        default:
+            return toml_value_to_python(value.to_value(), keys);
+    }
+}
+
+static py::dict snapshot_to_dict(const SnapshotTable& table, KeyCache& keys) {
+    py::dict result;
+    for (size_t i = 0; i < table.size(); ++i) {
+        py::object v = snapshot_to_python(table.value(i), keys);
+        if (PyDict_SetItem(result.ptr(), keys.get(table.key(i)).ptr(), v.ptr()) < 0) throw py::error_already_set();
+    }
+    return result;
+}
+
+// load_cached hit: the snapshot at snapshot_path as a dict if it was made from
+// a source of this size and mtime_ns, or, with by_hash, of this size and the
+// same hash as source_path's current contents. None if it is missing, stale or
+// damaged (the whole snapshot is hashed: it is read in full anyway).
+py::object load_snapshot(const std::string& snapshot_path, const std::string& source_path, uint64_t size,
+                         int64_t mtime_ns, bool by_hash) {
+    MappedFile file;
+    MappedFile source;
+    Snapshot snapshot;
+    bool current;
+    {
+        py::gil_scoped_release release;
+        std::error_code ec;
+        current = file.open(snapshot_path, ec) && snapshot.open(file.data()) && snapshot.source().size == size;
+        if (current && !by_hash) {
+            current = snapshot.source().mtime_ns == mtime_ns;
+        } else if (current) {
+            current = source.open(source_path, ec) &&
+                      snapshot_hash(source.data()) == snapshot.source().hash;
+        }
+        current = current && snapshot.verify();
+    }
+    if (!current) return py::none();
+    KeyCache keys;
+    try {
+        return snapshot_to_dict(snapshot.root(), keys);
+    } catch (const std::out_of_range&) {
+        return py::none();
+    }
+}
+
+// load_cached miss: parse the file at path and return (dict, snapshot bytes
+// recording size, mtime_ns and the contents' hash); the bytes are empty for a
+// document too large for a snapshot
+py::object make_snapshot(const std::string& path, uint64_t size, int64_t mtime_ns) {
+    TomlParser parser(python_options());
+    MappedFile file;
+    std::error_code ec;
+    bool ok;
+    TablePtr table;
+    std::string snapshot;
+    {
+        py::gil_scoped_release release;
+        ok = file.open(path, ec);
+        if (ok) table = parser.parse(file.data());
+        if (table) {
+            try {
+                snapshot = write_snapshot(*table, SnapshotSource{size, mtime_ns, snapshot_hash(file.data())});
+            } catch (const std::length_error&) {
+                snapshot.clear();
+            }
+        }
+    }
+    if (!ok) throw_os_error(path, ec);
+    if (!table) throw_parse_error(parser, file.data(), false);
+    KeyCache keys;
+    py::dict result = table_to_dict(*table, keys);
+    py::object bytes = py::reinterpret_steal<py::object>(
+        PyBytes_FromStringAndSize(snapshot.data(), static_cast<Py_ssize_t>(snapshot.size())));
+    if (!bytes) throw py::error_already_set();
+    PyObject* item = PyTuple_Pack(2, result.ptr(), bytes.ptr());
+    if (!item) throw py::error_already_set();
+    return py::reinterpret_steal<py::object>(item);
+}
+
+// Reusable parser behind fasttoml.Parser: one TomlParser, with its scratch
+// buffers and arena, serves every document, and documents share key objects
+// (the cache is kept for the next document if it holds at most kRetainedKeys). Not thread-safe;
+// the Python wrapper serializes calls.
+class PyParser {
+public:
+    static constexpr size_t kRetainedKeys = 4096;
+
+    PyParser() : parser_(python_options()) {}
+
+    py::dict loads(std::string_view toml_string, const py::object& select, bool numeric_buffers) {
+        keys_.trim(kRetainedKeys);
+        return parse_str(parser_, toml_string, select, numeric_buffers, keys_);
+    }
+
+    py::dict loads_bytes(const py::buffer& data, const py::object& select, bool numeric_buffers) {
+        keys_.trim(kRetainedKeys);
+        return parse_bytes(parser_, data, select, numeric_buffers, keys_);
+    }
+
+    py::dict load_path(const std::string& path, const py::object& select, bool numeric_buffers) {
+        keys_.trim(kRetainedKeys);
+        return parse_path(parser_, path, select, numeric_buffers, keys_);
+    }
+
+    void reset() {
+        parser_.reset();
+        keys_.trim(0);
+    }
+
+private:
+    TomlParser parser_;
+    KeyCache keys_;
+};
+
+// One document of a loads_many/load_many batch, filled in by a worker thread
+struct BatchItem {
+    std::string_view input;
+    bool text = false;  // input is a str's UTF-8 buffer
+    std::unique_ptr<MappedFile> file;
+    std::error_code open_error;
+    TablePtr table;
+    std::string error;
+    ParseResult result;
+};
+
+// Worker side of a batch: open (path set) and parse one item, without the GIL
+static void parse_item(TomlParser& parser, BatchItem& item, const std::string* path) {
+    try {
+        if (path) {
+            item.file = std::make_unique<MappedFile>();
+            if (item.file->open(*path, item.open_error)) item.input = item.file->data();
+        }
+        if (!item.open_error) {
+            item.table = parser.parse(item.input);
+            if (!item.table) {
+                item.error = parser.has_error() ? parser.get_error() : "unknown error";
+                item.result = parser.result();
+            }
+        }
+    } catch (const std::exception& e) {
+        item.error = e.what();
+    }
+}
+
+// Calling side: item i as a dict, or its error raised (naming its index if
+// numbered); its tree and mapping are dropped once converted
+static py::dict convert_item(std::vector<BatchItem>& items, size_t i, const std::vector<std::string>& paths,
+                             KeyCache& keys, bool numbered = true) {
+    BatchItem& item = items[i];
+    if (item.open_error) throw_os_error(paths[i], item.open_error);
+    if (!item.table) {
+        throw_decode_error(numbered ? "TOML parse error in document " + std::to_string(i) + ": " : "TOML parse error: ",
+                           item.error, item.result, item.input, item.text);
+    }
+    py::dict result = table_to_dict(*item.table, keys);
+    item.table.reset();
+    item.file.reset();
+    return result;
+}
+
+// Parses every item on `threads` native threads with the GIL released, and
+// converts finished items to dicts on the calling thread, in order, while the
+// workers continue. Each tree is dropped as soon as it has been converted.
+static py::list run_batch(std::vector<BatchItem>& items, unsigned threads, bool open_files,
+                          const std::vector<std::string>& paths) {
+    const size_t n = items.size();
+    py::list results;
+    if (n == 0) return results;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads > n) threads = static_cast<unsigned>(n);
+
+    std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[n]());
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable ready;
+    // Shared by the batch's documents, which usually have the same keys
+    KeyCache keys;
+
+    auto work = [&]() {
+        // One parser per worker, reused for its documents
+        TomlParser parser(python_options());
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= n) return;
+            parse_item(parser, items[i], open_files ? &paths[i] : nullptr);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done[i] = true;
+            }
+            ready.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    // Stops the workers early (on error) and joins them without the GIL
+    auto join_all = [&]() {
+        next = n;
+        py::gil_scoped_release release;
+        for (auto& t : pool) t.join();
+        pool.clear();
+    };
+    try {
+        {
+            py::gil_scoped_release release;
+            for (unsigned t = 0; t < threads; ++t) pool.emplace_back(work);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (!done[i]) {
+                py::gil_scoped_release release;
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return done[i].load(); });
+            }
+            results.append(convert_item(items, i, paths, keys));
+        }
+    } catch (...) {
+        join_all();
+        throw;
+    }
+    join_all();
+    return results;
+}
+
+// The documents of a loads_many batch (str or bytes-like) as items; keep_alive
+// and buffers hold what the inputs point into
+static void collect_documents(const py::sequence& docs, std::vector<BatchItem>& items,
+                              std::vector<py::object>& keep_alive, std::vector<py::buffer_info>& buffers) {
+    items.resize(docs.size());
+    keep_alive.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        py::object doc = docs[i];
+        if (PyUnicode_Check(doc.ptr())) {
+            Py_ssize_t size = 0;
+            const char* data = PyUnicode_AsUTF8AndSize(doc.ptr(), &size);
+            if (!data) throw py::error_already_set();
+            items[i].input = std::string_view(data, static_cast<size_t>(size));
+            items[i].text = true;
+        } else if (PyObject_CheckBuffer(doc.ptr())) {
+            buffers.push_back(py::reinterpret_borrow<py::buffer>(doc).request());
+            const py::buffer_info& info = buffers.back();
+            if (info.ndim != 1 || info.itemsize != 1 || info.strides[0] != 1) {
+                throw py::type_error("loads_many() documents must be str or C-contiguous bytes-like objects");
+            }
+            items[i].input = std::string_view(static_cast<const char*>(info.ptr), static_cast<size_t>(info.size));
         } else {
-            throw std::runtime_error("TOML parse error: unknown error");
+            throw py::type_error("loads_many() documents must be str or C-contiguous bytes-like objects");
         }
+        keep_alive.push_back(std::move(doc));
     }
-    
-    return table_to_dict(*table);
+}
+
+// Parse many TOML documents (str or bytes-like) in parallel
+py::list loads_many(const py::sequence& docs, unsigned threads) {
+    std::vector<BatchItem> items;
+    std::vector<py::object> keep_alive;
+    std::vector<py::buffer_info> buffers;
+    collect_documents(docs, items, keep_alive, buffers);
+    return run_batch(items, threads, false, {});
+}
+
+// Memory-map and parse many TOML files in parallel
+py::list load_many(const std::vector<std::string>& paths, unsigned threads) {
+    std::vector<BatchItem> items(paths.size());
+    return run_batch(items, threads, true, paths);
+}
+
+// A batch parsed in the background for the asyncio functions (aload,
+// aloads_many): the workers open and parse every item without the GIL, the
+// last one to finish calls notify() (taking the GIL only for that call, from
+// its thread), and result() converts the batch on the calling thread. The
+// workers are detached and the batch keeps itself alive until the last one
+// is done, so dropping a cancelled batch never waits for a parse.
+class PendingBatch : public std::enable_shared_from_this<PendingBatch> {
+public:
+    // single: one file, whose errors are raised like load_path's
+    PendingBatch(std::vector<std::string> paths, py::object notify, bool single = false)
+        : paths_(std::move(paths)), notify_(std::move(notify)), single_(single) {
+        items_.resize(paths_.size());
+    }
+
+    PendingBatch(const py::sequence& docs, py::object notify) : notify_(std::move(notify)) {
+        collect_documents(docs, items_, keep_alive_, buffers_);
+    }
+
+    void start(unsigned threads) {
+        const size_t n = items_.size();
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, n)));
+        running_ = threads;
+        self_ = shared_from_this();
+        py::gil_scoped_release release;
+        for (unsigned t = 0; t < threads; ++t) std::thread([this]() { work(); }).detach();
+    }
+
+    // Stop starting documents; those being parsed still finish
+    void cancel() {
+        cancelled_ = true;
+        next_ = items_.size();
+    }
+
+    // The dicts, in order, once notify() was called; raises the first error
+    py::list result() {
+        if (cancelled_) throw std::runtime_error("Batch was cancelled");
+        {
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(mutex_);
+            finished_.wait(lock, [this]() { return running_ == 0; });
+        }
+        KeyCache keys;
+        py::list results;
+        for (size_t i = 0; i < items_.size(); ++i) results.append(convert_item(items_, i, paths_, keys, !single_));
+        return results;
+    }
+
+private:
+    void work() {
+        TomlParser parser(python_options());
+        for (size_t i; (i = next_.fetch_add(1)) < items_.size();) {
+            parse_item(parser, items_[i], paths_.empty() ? nullptr : &paths_[i]);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--running_ > 0) return;
+        }
+        finished_.notify_all();
+        py::gil_scoped_acquire gil;
+        PyObject* r = PyObject_CallNoArgs(notify_.ptr());
+        if (!r) PyErr_WriteUnraisable(notify_.ptr());
+        Py_XDECREF(r);
+        // Last use of this: the batch may be destroyed here, with the GIL
+        // held for its Python references
+        std::shared_ptr<PendingBatch> self = std::move(self_);
+    }
+
+    std::vector<BatchItem> items_;
+    std::vector<std::string> paths_;  // empty for documents
+    std::vector<py::object> keep_alive_;
+    std::vector<py::buffer_info> buffers_;
+    py::object notify_;
+    bool single_ = false;
+    std::atomic<size_t> next_{0};
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    unsigned running_ = 0;  // workers not done, guarded by mutex_
+    std::atomic<bool> cancelled_{false};
+    std::shared_ptr<PendingBatch> self_;  // set while workers run
+};
+
+// Start parsing a file / files / documents in the background (see PendingBatch)
+std::shared_ptr<PendingBatch> start_load(const std::string& path, const py::object& notify) {
+    auto batch = std::make_shared<PendingBatch>(std::vector<std::string>{path}, notify, true);
+    batch->start(1);
+    return batch;
+}
+
+std::shared_ptr<PendingBatch> start_load_many(const std::vector<std::string>& paths, unsigned threads,
+                                              const py::object& notify) {
+    auto batch = std::make_shared<PendingBatch>(paths, notify);
+    batch->start(threads);
+    return batch;
+}
+
+std::shared_ptr<PendingBatch> start_loads_many(const py::sequence& docs, unsigned threads, const py::object& notify) {
+    auto batch = std::make_shared<PendingBatch>(docs, notify);
+    batch->start(threads);
+    return batch;
+}
+
+// Python side of LazyDocument: a read-only mapping over one table. Entries are
+// converted on first access and cached, so repeated lookups return the same
+// object; sub-tables become LazyTable views and arrays of tables lists of them.
+class LazyTable {
+public:
+    // text: the document was a str, so error positions count characters
+    LazyTable(std::shared_ptr<const LazyDocument> doc, const LazyDocument::Table& table, bool text)
+        : doc_(std::move(doc)), table_(table), text_(text), cache_(table.entries.size()) {}
+
+    size_t size() const { return table_.entries.size(); }
+
+    bool contains(const py::object& key) const { return find(key) != nullptr; }
+
+    py::object getitem(const py::object& key) {
+        const LazyDocument::Entry* entry = find(key);
+        if (!entry) {
+            PyErr_SetObject(PyExc_KeyError, key.ptr());
+            throw py::error_already_set();
+        }
+        return materialize(*entry);
+    }
+
+    py::object get(const py::object& key, const py::object& default_value) {
+        const LazyDocument::Entry* entry = find(key);
+        return entry ? materialize(*entry) : default_value;
+    }
+
+    py::list keys() const {
+        py::list result;
+        for (const auto& entry : table_.entries) result.append(py::str(entry.key.data(), entry.key.size()));
+        return result;
+    }
+
+    py::object iter() const {
+        py::list k = keys();
+        return py::reinterpret_steal<py::object>(PyObject_GetIter(k.ptr()));
+    }
+
+    py::list values() {
+        py::list result;
+        for (const auto& entry : table_.entries) result.append(materialize(entry));
+        return result;
+    }
+
+    py::list items() {
+        py::list result;
+        for (const auto& entry : table_.entries) {
+            py::str key(entry.key.data(), entry.key.size());
+            py::object value = materialize(entry);
+            PyObject* item = PyTuple_Pack(2, key.ptr(), value.ptr());
+            if (!item) throw py::error_already_set();
+            result.append(py::reinterpret_steal<py::object>(item));
+        }
+        return result;
+    }
+
+    // Whole table as plain dicts and lists, parsed afresh (not cached)
+    py::dict to_dict() const {
+        KeyCache keys;
+        return table_dict(table_, keys);
+    }
+
+    std::string repr() const { return "<fasttoml.LazyTable with " + std::to_string(size()) + " keys>"; }
+
+private:
+    const LazyDocument::Entry* find(const py::object& key) const {
+        if (!PyUnicode_Check(key.ptr())) return nullptr;
+        Py_ssize_t size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(key.ptr(), &size);
+        if (!data) throw py::error_already_set();
+        return table_.find(std::string_view(data, static_cast<size_t>(size)));
+    }
+
+    py::object parse_value(const LazyDocument::Entry& entry, KeyCache& keys) const {
+        PyBuilder builder(keys);
+        py::object value;
+        std::string error;
+        ParseResult result;
+        if (!doc_->parse_value(entry, builder, value, error, &result)) {
+            throw_decode_error("TOML parse error in value of '" + std::string(entry.key) + "': ", error, result,
+                               doc_->input(), text_);
+        }
+        return value;
+    }
+
+    py::object materialize(const LazyDocument::Entry& entry) {
+        py::object& cached = cache_[static_cast<size_t>(&entry - table_.entries.data())];
+        if (cached) return cached;
+        switch (entry.kind) {
+            case LazyDocument::Entry::Kind::Value: {
+                KeyCache keys;
+                cached = parse_value(entry, keys);
+                break;
+            }
+            case LazyDocument::Entry::Kind::Table:
+                cached = py::cast(std::make_shared<LazyTable>(doc_, doc_->table(entry.index), text_));
+                break;
+            case LazyDocument::Entry::Kind::TableArray: {
+                py::list tables;
+                for (uint32_t i : doc_->table_array(entry.index)) {
+                    tables.append(py::cast(std::make_shared<LazyTable>(doc_, doc_->table(i), text_)));
+                }
+                cached = std::move(tables);
+                break;
+            }
+        }
+        return cached;
+    }
+
+    py::dict table_dict(const LazyDocument::Table& table, KeyCache& keys) const {
+        py::dict result;
+        for (const auto& entry : table.entries) {
+            py::object key = keys.get(entry.key);
+            py::object value;
+            switch (entry.kind) {
+                case LazyDocument::Entry::Kind::Value:
+                    value = parse_value(entry, keys);
+                    break;
+                case LazyDocument::Entry::Kind::Table:
+                    value = table_dict(doc_->table(entry.index), keys);
+                    break;
+                case LazyDocument::Entry::Kind::TableArray: {
+                    py::list tables;
+                    for (uint32_t i : doc_->table_array(entry.index)) tables.append(table_dict(doc_->table(i), keys));
+                    value = std::move(tables);
+                    break;
+                }
+            }
+            if (PyDict_SetItem(result.ptr(), key.ptr(), value.ptr()) < 0) throw py::error_already_set();
+        }
+        return result;
+    }
+
+    std::shared_ptr<const LazyDocument> doc_;
+    const LazyDocument::Table& table_;
+    bool text_;
+    std::vector<py::object> cache_;  // per entry, null until first access
+};
+
+// Owner handle that keeps a Python object alive for a LazyDocument; the
+// document may be released on any thread, so the GIL is taken for the decref
+static std::shared_ptr<const void> keep_alive(py::object obj) {
+    return std::shared_ptr<const void>(new py::object(std::move(obj)), [](const void* p) {
+        py::gil_scoped_acquire gil;
+        delete static_cast<const py::object*>(p);
+    });
+}
+
+// owner keeps input alive (text: input is a str's UTF-8 buffer)
+static std::shared_ptr<LazyTable> parse_lazy(std::string_view input, bool text, std::shared_ptr<const void> owner) {
+    ParseOptions options;
+    // Values are converted to Python objects right after parsing
+    options.string_views = true;
+    TomlParser parser(options);
+    std::shared_ptr<LazyDocument> doc;
+    // owner is shared, not moved, so input is still there to locate an error
+    if (input.size() >= kReleaseGilMinSize) {
+        py::gil_scoped_release release;
+        doc = parser.parse_lazy(input, owner);
+    } else {
+        doc = parser.parse_lazy(input, owner);
+    }
+    if (!doc) throw_parse_error(parser, input, text);
+    const LazyDocument::Table& root = doc->root();
+    return std::make_shared<LazyTable>(std::move(doc), root, text);
+}
+
+// Index a str or bytes-like document for lazy access. str and bytes are
+// immutable and referenced in place; other buffers are copied once.
+std::shared_ptr<LazyTable> loads_lazy(const py::object& data) {
+    PyObject* o = data.ptr();
+    if (PyUnicode_Check(o)) {
+        Py_ssize_t size = 0;
+        const char* text = PyUnicode_AsUTF8AndSize(o, &size);
+        if (!text) throw py::error_already_set();
+        return parse_lazy(std::string_view(text, static_cast<size_t>(size)), true, keep_alive(data));
+    }
+    if (PyBytes_CheckExact(o)) {
+        return parse_lazy(std::string_view(PyBytes_AS_STRING(o), static_cast<size_t>(PyBytes_GET_SIZE(o))), false,
+                          keep_alive(data));
+    }
+    if (PyObject_CheckBuffer(o)) {
+        py::buffer_info info = py::reinterpret_borrow<py::buffer>(data).request();
+        if (info.ndim == 1 && info.itemsize == 1 && info.strides[0] == 1) {
+            auto copy = std::make_shared<std::string>(static_cast<const char*>(info.ptr), static_cast<size_t>(info.size));
+            std::string_view text(*copy);
+            return parse_lazy(text, false, std::move(copy));
+        }
+    }
+    throw py::type_error("loads_lazy() argument must be str or a C-contiguous bytes-like object");
+}
+
+// Memory-map a TOML file and index it for lazy access; the mapping lives as
+// long as any LazyTable of the document
+std::shared_ptr<LazyTable> load_lazy(const std::string& path) {
+    auto file = std::make_shared<MappedFile>();
+    std::error_code ec;
+    bool ok;
+    {
+        py::gil_scoped_release release;
+        ok = file->open(path, ec);
+    }
+    if (!ok) throw_os_error(path, ec);
+    std::string_view text = file->data();
+    return parse_lazy(text, false, std::move(file));
+}
+
+// Incremental parser behind iter_events: feed() and finish() return the
+// events completed so far as (kind, payload) tuples
+class PyEventParser {
+public:
+    py::list feed(const py::object& data) {
+        PyObject* o = data.ptr();
+        std::string_view chunk;
+        std::unique_ptr<py::buffer_info> info;
+        if (PyUnicode_Check(o)) {
+            Py_ssize_t size = 0;
+            const char* text = PyUnicode_AsUTF8AndSize(o, &size);
+            if (!text) throw py::error_already_set();
+            chunk = std::string_view(text, static_cast<size_t>(size));
+            chars_ += static_cast<size_t>(PyUnicode_GET_LENGTH(o));
+        } else if (PyObject_CheckBuffer(o)) {
+            info = std::make_unique<py::buffer_info>(py::reinterpret_borrow<py::buffer>(data).request());
+            if (info->ndim != 1 || info->itemsize != 1 || info->strides[0] != 1) {
+                throw py::type_error("feed() argument must be str or a C-contiguous bytes-like object");
+            }
+            chunk = std::string_view(static_cast<const char*>(info->ptr), static_cast<size_t>(info->size));
+            text_ = false;
+        } else {
+            throw py::type_error("feed() argument must be str or a C-contiguous bytes-like object");
+        }
+        if (parser_.finished()) throw std::runtime_error("Input fed after finish()");
+        bool ok;
+        if (chunk.size() >= kReleaseGilMinSize) {
+            py::gil_scoped_release release;
+            ok = parser_.feed(chunk);
+        } else {
+            ok = parser_.feed(chunk);
+        }
+        return drain(ok);
+    }
+
+    py::list finish() { return drain(parser_.finish()); }
+
+private:
+    py::list drain(bool ok) {
+        // Events parsed before an error are dropped with it. Positions count
+        // characters while every chunk was a str, otherwise bytes.
+        if (!ok) {
+            const std::string_view rest = parser_.buffered();
+            const size_t consumed_chars = text_ ? chars_ - utf8_chars(rest.data(), rest.data() + rest.size()) : 0;
+            throw_decode_error("TOML parse error: ", parser_.get_error(), parser_.result(), rest, text_,
+                               parser_.consumed(), consumed_chars);
+        }
+        static const char* const kinds[] = {"table", "array_table", "key", "scalar",
+                                            "begin_array", "begin_inline_table", "end"};
+        py::list result;
+        Event event;
+        while (parser_.next(event)) {
+            py::object payload;
+            switch (event.type) {
+                case Event::Type::Table:
+                case Event::Type::ArrayTable:
+                case Event::Type::Key: {
+                    PyObject* path = PyTuple_New(static_cast<Py_ssize_t>(event.path.size()));
+                    if (!path) throw py::error_already_set();
+                    payload = py::reinterpret_steal<py::object>(path);
+                    for (size_t i = 0; i < event.path.size(); ++i) {
+                        PyTuple_SET_ITEM(path, static_cast<Py_ssize_t>(i), Py_NewRef(keys_.get(event.path[i]).ptr()));
+                    }
+                    break;
+                }
+                case Event::Type::Scalar:
+                    payload = toml_value_to_python(event.value, keys_);
+                    break;
+                default:
+                    payload = py::none();
+                    break;
+            }
+            py::str kind(kinds[static_cast<int>(event.type)]);
+            PyObject* item = PyTuple_Pack(2, kind.ptr(), payload.ptr());
+            if (!item) throw py::error_already_set();
+            result.append(py::reinterpret_steal<py::object>(item));
+        }
+        return result;
+    }
+
+    StreamParser parser_;
+    KeyCache keys_;  // for the whole stream
+    bool text_ = true;  // every chunk so far was a str
+    size_t chars_ = 0;  // characters of the str chunks
+};
+
+// Python str as code points for writer::classify_string (str.isdigit semantics)
+struct PyText {
+    int kind;
+    const void* data;
+    size_t n;
+
+    explicit PyText(PyObject* s)
+        : kind(PyUnicode_KIND(s)), data(PyUnicode_DATA(s)), n(static_cast<size_t>(PyUnicode_GET_LENGTH(s))) {}
+    size_t size() const { return n; }
+    Py_UCS4 at(size_t i) const { return PyUnicode_READ(kind, data, static_cast<Py_ssize_t>(i)); }
+    bool is_digit(size_t i) const { return Py_UNICODE_ISDIGIT(at(i)); }
+};
+
+// Serializes Python dicts (loads() output) straight into one buffer; layout
+// and text are identical to the reference emitter in fasttoml/_dumps.py
+class PyEmitter {
+public:
+    std::string out;
+
+    void table_body(PyObject* table, const std::string& prefix) {
+        RecursionGuard guard;
+        std::vector<std::pair<std::string_view, py::object>> entries;
+        entries.reserve(static_cast<size_t>(PyDict_GET_SIZE(table)));
+        PyObject* key;
+        PyObject* value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(table, &pos, &key, &value)) {
+            entries.emplace_back(key_text(key), py::reinterpret_borrow<py::object>(value));
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (const auto& [k, v] : entries) {
+            if (PyDict_Check(v.ptr()) || is_table_array(v.ptr())) continue;
+            line();
+            writer::append_key(out, k);
+            out += " = ";
+            inline_value(v.ptr());
+        }
+        for (const auto& [k, v] : entries) {
+            if (!PyDict_Check(v.ptr())) continue;
+            std::string path = path_of(prefix, k);
+            line();
+            out += '[';
+            out += path;
+            out += ']';
+            table_body(v.ptr(), path);
+        }
+        for (const auto& [k, v] : entries) {
+            if (!is_table_array(v.ptr())) continue;
+            std::string path = path_of(prefix, k);
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(v.ptr()); ++i) {
+                // Hold the element: converting values may run arbitrary Python code
+                py::object item = py::reinterpret_borrow<py::object>(PyList_GET_ITEM(v.ptr(), i));
+                line();
+                out += "[[";
+                out += path;
+                out += "]]";
+                table_body(item.ptr(), path);
+            }
+        }
+    }
+
+private:
+    // Turns runaway nesting (e.g. a dict containing itself) into RecursionError
+    struct RecursionGuard {
+        RecursionGuard() {
+            if (Py_EnterRecursiveCall(" while serializing TOML")) throw py::error_already_set();
+        }
+        ~RecursionGuard() { Py_LeaveRecursiveCall(); }
+    };
+
+    void line() {
+        if (!out.empty()) out += '\n';
+    }
+
+    static std::string path_of(const std::string& prefix, std::string_view key) {
+        std::string path = prefix;
+        if (!path.empty()) path += '.';
+        writer::append_key(path, key);
+        return path;
+    }
+
+    static std::string_view utf8(PyObject* s) {
+        Py_ssize_t size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(s, &size);
+        if (!data) throw py::error_already_set();
+        return std::string_view(data, static_cast<size_t>(size));
+    }
+
+    static std::string_view key_text(PyObject* key) {
+        if (!PyUnicode_Check(key)) {
+            throw py::type_error(std::string("TOML keys must be str, not ") + Py_TYPE(key)->tp_name);
+        }
+        return utf8(key);
+    }
+
+    static bool is_table_array(PyObject* v) {
+        if (!PyList_Check(v) || PyList_GET_SIZE(v) == 0) return false;
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(v); ++i) {
+            if (!PyDict_Check(PyList_GET_ITEM(v, i))) return false;
+        }
+        return true;
+    }
+
+    [[noreturn]] static void unsupported(PyObject* v) {
+        py::object name = py::reinterpret_steal<py::object>(
+            PyObject_GetAttrString(reinterpret_cast<PyObject*>(Py_TYPE(v)), "__name__"));
+        if (!name) throw py::error_already_set();
+        throw py::type_error("Unsupported type for TOML: " + std::string(utf8(name.ptr())));
+    }
+
+    void append_str_result(PyObject* s) {
+        if (!s) throw py::error_already_set();
+        py::object text = py::reinterpret_steal<py::object>(s);
+        std::string_view v = utf8(text.ptr());
+        out.append(v.data(), v.size());
+    }
+
+    void inline_value(PyObject* v) {
+        if (PyDict_Check(v)) {
+            RecursionGuard guard;
+            out += '{';
+            PyObject* key;
+            PyObject* value;
+            Py_ssize_t pos = 0;
+            bool first = true;
+            while (PyDict_Next(v, &pos, &key, &value)) {
+                if (!first) out += ',';
+                first = false;
+                writer::append_key(out, key_text(key));
+                out += " = ";
+                py::object hold = py::reinterpret_borrow<py::object>(value);
+                inline_value(hold.ptr());
+            }
+            out += '}';
+        } else if (PyList_Check(v)) {
+            if (is_table_array(v)) throw py::type_error("List of tables must be emitted as [[section]]");
+            RecursionGuard guard;
+            out += '[';
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(v); ++i) {
+                if (i > 0) out += ", ";
+                py::object item = py::reinterpret_borrow<py::object>(PyList_GET_ITEM(v, i));
+                inline_value(item.ptr());
+            }
+            out += ']';
+        } else {
+            scalar(v);
+        }
+    }
+
+    void scalar(PyObject* v) {
+        if (v == Py_None) {
+            throw py::type_error("None is not a valid TOML value");
+        }
+        if (PyBool_Check(v)) {
+            out += v == Py_True ? "true" : "false";
+        } else if (PyLong_Check(v)) {
+            int overflow = 0;
+            long long n = PyLong_CheckExact(v) ? PyLong_AsLongLongAndOverflow(v, &overflow) : 0;
+            if (PyLong_CheckExact(v) && !overflow) {
+                if (n == -1 && PyErr_Occurred()) throw py::error_already_set();
+                char buf[24];
+                auto res = std::to_chars(buf, buf + sizeof(buf), n);
+                out.append(buf, res.ptr);
+            } else {
+                // Big integers and int subclasses: whatever str() says
+                append_str_result(PyObject_Str(v));
+            }
+        } else if (PyFloat_Check(v)) {
+            double d = PyFloat_AS_DOUBLE(v);
+            if (PyFloat_CheckExact(v) || std::isnan(d) || std::isinf(d)) {
+                writer::append_float(out, d);
+            } else {
+                append_str_result(PyObject_Repr(v));
+            }
+        } else if (PyDateTime_Check(v)) {
+            writer::append_datetime(out, PyDateTime_GET_YEAR(v), PyDateTime_GET_MONTH(v), PyDateTime_GET_DAY(v),
+                                    PyDateTime_DATE_GET_HOUR(v), PyDateTime_DATE_GET_MINUTE(v),
+                                    PyDateTime_DATE_GET_SECOND(v), PyDateTime_DATE_GET_MICROSECOND(v));
+            PyObject* tz = PyDateTime_DATE_GET_TZINFO(v);
+            if (tz == Py_None || tz == PyDateTime_TimeZone_UTC) {
+                // Naive datetimes are written as UTC
+                writer::append_offset(out, 0);
+                return;
+            }
+            py::object offset = py::reinterpret_steal<py::object>(PyObject_CallMethod(v, "utcoffset", nullptr));
+            if (!offset) throw py::error_already_set();
+            if (offset.ptr() == Py_None) return;
+            if (!PyDelta_Check(offset.ptr())) throw py::type_error("utcoffset() must return a timedelta");
+            // int(offset.total_seconds()): truncated toward zero
+            int64_t total_us = (int64_t(PyDateTime_DELTA_GET_DAYS(offset.ptr())) * 86400 +
+                                PyDateTime_DELTA_GET_SECONDS(offset.ptr())) * 1000000 +
+                               PyDateTime_DELTA_GET_MICROSECONDS(offset.ptr());
+            writer::append_offset(out, static_cast<int>(total_us / 1000000));
+        } else if (PyUnicode_Check(v)) {
+            std::string_view s = utf8(v);
+            switch (writer::classify_string(PyText(v))) {
+                case writer::StringForm::Date:
+                case writer::StringForm::Time:
+                    out.append(s.data(), s.size());
+                    break;
+                case writer::StringForm::LocalDateTime:
+                    // value.replace(" ", "T"): only position 10 can hold a space
+                    for (char c : s) out += c == ' ' ? 'T' : c;
+                    break;
+                case writer::StringForm::Basic:
+                    writer::append_basic_string(out, s);
+                    break;
+            }
+        } else {
+            unsupported(v);
+        }
+    }
+};
+
+static std::string emit_document(const py::object& obj) {
+    if (!PyDict_Check(obj.ptr())) throw py::type_error("dumps() requires a dict");
+    PyEmitter emitter;
+    emitter.table_body(obj.ptr(), "");
+    return std::move(emitter.out);
+}
+
+// Serialize a dict (loads() output) to a TOML string
+py::str dumps(const py::object& obj) {
+    std::string text = emit_document(obj);
+    return py::str(text.data(), text.size());
+}
+
+// Serialize a dict and write the UTF-8 text straight to a file
+void dump_path(const py::object& obj, const std::string& path) {
+    std::string text = emit_document(obj);
+    std::error_code ec;
+    {
+        py::gil_scoped_release release;
+#ifdef _WIN32
+        // Text mode, like Python's open(path, "w"): \n is written as \r\n
+        std::wstring wpath(static_cast<size_t>(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0)), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], static_cast<int>(wpath.size()));
+        std::FILE* f = _wfopen(wpath.c_str(), L"w");
+#else
+        std::FILE* f = std::fopen(path.c_str(), "w");
+#endif
+        if (!f) {
+            ec.assign(errno, std::generic_category());
+        } else {
+            if (std::fwrite(text.data(), 1, text.size(), f) != text.size()) ec.assign(errno, std::generic_category());
+            if (std::fclose(f) != 0 && !ec) ec.assign(errno, std::generic_category());
+        }
+    }
+    if (ec) throw_errno_error(path, ec.value());
 }
 
 PYBIND11_MODULE(_native, m) {
     m.doc() = "Fast TOML parser for Python with SIMD optimizations";
+
+    PyDateTime_IMPORT;
+    if (!PyDateTimeAPI) throw py::error_already_set();
+    datetime_cache = new DateTimeCache();
+
+    decode_error_type = PyErr_NewExceptionWithDoc(
+        "fasttoml.TOMLDecodeError",
+        "Invalid TOML document. msg is the error message; pos, lineno and colno locate it (pos and colno in "
+        "characters for str input, in bytes otherwise; lineno and colno start at 1).",
+        PyExc_ValueError, nullptr);
+    if (!decode_error_type) throw py::error_already_set();
+    const char* const decode_error_names[] = {"msg", "pos", "lineno", "colno"};
+    for (int i = 0; i < 4; ++i) {
+        decode_error_attrs[i] = PyUnicode_InternFromString(decode_error_names[i]);
+        if (!decode_error_attrs[i]) throw py::error_already_set();
+    }
+    m.attr("TOMLDecodeError") = py::reinterpret_borrow<py::object>(decode_error_type);
     
     // Main API
     m.def("loads", &loads, R"pbdoc(
@@ -88,14 +1522,282 @@ PYBIND11_MODULE(_native, m) {
         
         Args:
             toml_string: The TOML string to parse
+            select: Iterable of key paths to parse (None = whole document)
+            numeric_buffers: Return all-integer/all-float arrays as array.array
+            threads: Threads for documents of 1 MiB or more (0 = one per CPU)
+            
+        Returns:
+            dict: Parsed TOML data as a Python dictionary
+            
+        Raises:
+            TOMLDecodeError: If parsing fails
+    )pbdoc", py::arg("toml_string"), py::arg("select") = py::none(), py::arg("numeric_buffers") = false,
+          py::arg("threads") = 1);
+
+    m.def("loads_bytes", &loads_bytes, R"pbdoc(
+        Parse UTF-8 encoded TOML from a bytes-like object without decoding it to str.
+        The GIL is released while parsing.
+        
+        Args:
+            data: bytes, bytearray, memoryview or any C-contiguous buffer
+            select: Iterable of key paths to parse (None = whole document)
+            numeric_buffers: Return all-integer/all-float arrays as array.array
+            threads: Threads for documents of 1 MiB or more (0 = one per CPU)
             
         Returns:
             dict: Parsed TOML data as a Python dictionary
             
         Raises:
-            RuntimeError: If parsing fails
-    )pbdoc", py::arg("toml_string"));
+            TOMLDecodeError: If parsing fails
+    )pbdoc", py::arg("data"), py::arg("select") = py::none(), py::arg("numeric_buffers") = false,
+          py::arg("threads") = 1);
+
+    m.def("load_path", &load_path, R"pbdoc(
+        Memory-map a TOML file and parse it in place. The GIL is released while
+        mapping and parsing.
+        
+        Args:
+            path: Path of the file (str or bytes)
+            select: Iterable of key paths to parse (None = whole document)
+            numeric_buffers: Return all-integer/all-float arrays as array.array
+            threads: Threads for documents of 1 MiB or more (0 = one per CPU)
+            
+        Returns:
+            dict: Parsed TOML data as a Python dictionary
+            
+        Raises:
+            OSError: If the file cannot be opened or mapped
+            TOMLDecodeError: If parsing fails
+    )pbdoc", py::arg("path"), py::arg("select") = py::none(), py::arg("numeric_buffers") = false,
+          py::arg("threads") = 1);
+
+    m.def("loads_stats", &loads_stats, R"pbdoc(
+        loads() with a profile of the parse (on one thread): value counts,
+        depth, arena use and phase times in nanoseconds.
+
+        Returns:
+            tuple: (dict, stats dict)
+    )pbdoc", py::arg("toml_string"), py::arg("numeric_buffers") = false);
+
+    m.def("loads_bytes_stats", &loads_bytes_stats, R"pbdoc(
+        loads_bytes() with a profile of the parse, see loads_stats.
+    )pbdoc", py::arg("data"), py::arg("numeric_buffers") = false);
+
+    m.def("load_path_stats", &load_path_stats, R"pbdoc(
+        load_path() with a profile of the parse, see loads_stats.
+    )pbdoc", py::arg("path"), py::arg("numeric_buffers") = false);
+
+    m.def("load_snapshot", &load_snapshot, R"pbdoc(
+        Read a snapshot written by load_cached, if it is current.
+
+        Args:
+            snapshot_path: Path of the snapshot
+            source_path: Path of the source file
+            size: Size of the source file
+            mtime_ns: Modification time of the source file
+            by_hash: Compare the source's contents by hash instead of mtime_ns
+
+        Returns:
+            dict, or None if the snapshot is missing, stale or damaged
+    )pbdoc", py::arg("snapshot_path"), py::arg("source_path"), py::arg("size"), py::arg("mtime_ns"),
+          py::arg("by_hash") = false);
+
+    m.def("make_snapshot", &make_snapshot, R"pbdoc(
+        Parse a TOML file for load_cached and serialize it as a snapshot.
+
+        Args:
+            path: Path of the file
+            size: Size of the file, recorded in the snapshot
+            mtime_ns: Modification time of the file, recorded in the snapshot
+
+        Returns:
+            tuple: (dict, snapshot bytes); the bytes are empty if the document is too large
+
+        Raises:
+            OSError: If the file cannot be opened or mapped
+            TOMLDecodeError: If parsing fails
+    )pbdoc", py::arg("path"), py::arg("size"), py::arg("mtime_ns"));
+
+    m.def("loads_many", &loads_many, R"pbdoc(
+        Parse a sequence of TOML documents (str or bytes-like) on a pool of
+        native threads. Parsing runs without the GIL; results are converted
+        to dicts in order as they complete.
+        
+        Args:
+            docs: Sequence of TOML documents
+            threads: Number of worker threads (0 = one per CPU)
+            
+        Returns:
+            list: One dict per document, in input order
+            
+        Raises:
+            TOMLDecodeError: If any document fails to parse (first failing index)
+    )pbdoc", py::arg("docs"), py::arg("threads") = 0);
+
+    m.def("load_many", &load_many, R"pbdoc(
+        Memory-map and parse a list of TOML files on a pool of native threads.
+        
+        Args:
+            paths: List of file paths
+            threads: Number of worker threads (0 = one per CPU)
+            
+        Returns:
+            list: One dict per file, in input order
+            
+        Raises:
+            OSError: If a file cannot be opened or mapped
+            TOMLDecodeError: If any file fails to parse (first failing index)
+    )pbdoc", py::arg("paths"), py::arg("threads") = 0);
+
+    py::class_<PendingBatch, std::shared_ptr<PendingBatch>>(m, "PendingBatch", R"pbdoc(
+        Files or documents being parsed on native threads for aload and
+        aloads_many. Dropping it cancels the documents not started yet and
+        waits for the others.
+    )pbdoc")
+        .def("cancel", &PendingBatch::cancel, "Stop starting documents; notify() is still called.")
+        .def("result", &PendingBatch::result, R"pbdoc(
+        Convert the parsed documents to dicts (call after notify()).
+        
+        Returns:
+            list: One dict per input, in order
+            
+        Raises:
+            OSError: If a file cannot be opened or mapped
+            TOMLDecodeError: If any input fails to parse (first failing index)
+    )pbdoc");
+
+    m.def("start_load", &start_load, R"pbdoc(
+        Memory-map and parse one file on a native thread without blocking
+        (see start_load_many); errors are raised like load_path's.
+    )pbdoc", py::arg("path"), py::arg("notify"));
+
+    m.def("start_load_many", &start_load_many, R"pbdoc(
+        Memory-map and parse files on native threads without blocking.
+        
+        Args:
+            paths: List of file paths
+            threads: Number of worker threads (0 = one per CPU)
+            notify: Called with no arguments, on a worker thread, once every
+                file is parsed (e.g. loop.call_soon_threadsafe)
+            
+        Returns:
+            PendingBatch
+    )pbdoc", py::arg("paths"), py::arg("threads"), py::arg("notify"));
+
+    m.def("start_loads_many", &start_loads_many, R"pbdoc(
+        Parse documents (str or bytes-like) on native threads without blocking
+        (see start_load_many).
+    )pbdoc", py::arg("docs"), py::arg("threads"), py::arg("notify"));
     
+    m.def("dumps", &dumps, R"pbdoc(
+        Serialize a dict (as returned by loads) to a TOML string.
+        
+        Args:
+            obj: Root table
+            
+        Returns:
+            str: TOML text (keys sorted, tables after plain values)
+            
+        Raises:
+            TypeError: If obj is not a dict or contains unsupported types
+    )pbdoc", py::arg("obj"));
+
+    m.def("dump_path", &dump_path, R"pbdoc(
+        Serialize a dict to TOML and write it as UTF-8 to the file at path.
+        
+        Args:
+            obj: Root table
+            path: Output file path
+            
+        Raises:
+            TypeError: If obj is not a dict or contains unsupported types
+            OSError: If the file cannot be written
+    )pbdoc", py::arg("obj"), py::arg("path"));
+    
+    py::class_<LazyTable, std::shared_ptr<LazyTable>>(m, "LazyTable", R"pbdoc(
+        Read-only mapping over a table of a lazily parsed document (see
+        loads_lazy). Values are parsed on first access and cached; sub-tables
+        are LazyTable objects, arrays of tables lists of them.
+    )pbdoc")
+        .def("__len__", &LazyTable::size)
+        .def("__contains__", &LazyTable::contains, py::arg("key"))
+        .def("__getitem__", &LazyTable::getitem, py::arg("key"))
+        .def("__iter__", &LazyTable::iter)
+        .def("__repr__", &LazyTable::repr)
+        .def("get", &LazyTable::get, py::arg("key"), py::arg("default") = py::none())
+        .def("keys", &LazyTable::keys)
+        .def("values", &LazyTable::values)
+        .def("items", &LazyTable::items)
+        .def("to_dict", &LazyTable::to_dict, "Parse the whole table into plain dicts and lists.");
+
+    m.def("loads_lazy", &loads_lazy, R"pbdoc(
+        Index the structure of a TOML document (str or bytes-like) without
+        parsing its values. The GIL is released while indexing large inputs.
+        
+        Args:
+            data: The TOML document
+            
+        Returns:
+            LazyTable: The root table
+            
+        Raises:
+            TOMLDecodeError: If the document structure is invalid
+    )pbdoc", py::arg("data"));
+
+    m.def("load_lazy", &load_lazy, R"pbdoc(
+        Memory-map a TOML file and index it for lazy access (see loads_lazy).
+        
+        Args:
+            path: Path of the file (str or bytes)
+            
+        Returns:
+            LazyTable: The root table
+            
+        Raises:
+            OSError: If the file cannot be opened or mapped
+            TOMLDecodeError: If the document structure is invalid
+    )pbdoc", py::arg("path"));
+
+    py::class_<PyEventParser, std::shared_ptr<PyEventParser>>(m, "EventParser", R"pbdoc(
+        Incremental TOML parser for input that arrives in chunks (see
+        iter_events). Only the statement being read is buffered.
+    )pbdoc")
+        .def(py::init<>())
+        .def("feed", &PyEventParser::feed, R"pbdoc(
+        Add a chunk (str or UTF-8 bytes-like) and return the events of the
+        statements it completes as a list of (kind, payload) tuples.
+        
+        Raises:
+            TOMLDecodeError: If parsing fails
+            RuntimeError: If called after finish()
+    )pbdoc", py::arg("data"))
+        .def("finish", &PyEventParser::finish, R"pbdoc(
+        End the input and return the events of the last statement.
+        
+        Raises:
+            TOMLDecodeError: If parsing fails
+    )pbdoc");
+
+    py::class_<PyParser, std::shared_ptr<PyParser>>(m, "Parser", R"pbdoc(
+        Parser reused for many documents: scratch buffers and the tree arena
+        are kept between calls instead of being allocated for each one.
+        Not thread-safe (fasttoml.Parser serializes calls).
+    )pbdoc")
+        .def(py::init<>())
+        .def("loads", &PyParser::loads, "Parse a TOML string (see loads).", py::arg("toml_string"),
+             py::arg("select") = py::none(), py::arg("numeric_buffers") = false)
+        .def("loads_bytes", &PyParser::loads_bytes, "Parse a UTF-8 bytes-like object (see loads_bytes).",
+             py::arg("data"), py::arg("select") = py::none(), py::arg("numeric_buffers") = false)
+        .def("load_path", &PyParser::load_path, "Memory-map and parse a file (see load_path).", py::arg("path"),
+             py::arg("select") = py::none(), py::arg("numeric_buffers") = false)
+        .def("reset", &PyParser::reset, "Drop the state of the previous parse, keeping its memory for reuse.");
+
+    m.def("simd_isa", &simd_utils::isa, R"pbdoc(
+        Instruction set of the native scanning kernels: "avx2" or "sse2" on
+        x86-64 (chosen from the CPU at import; FASTTOML_SIMD=sse2 forces SSE2),
+        "neon" on ARM, "scalar" elsewhere.
+    )pbdoc");
+
     // Version info
     m.attr("__version__") = "0.1.0";
 }
@@ -0,0 +1,73 @@
+#include "fasttoml/selection.hpp"
+#include <cstring>
+
+namespace fasttoml {
+
+bool Selection::add(std::string_view path, std::string& error) {
+    std::vector<std::string> keys;
+    TomlParser parser;
+    if (!parser.parse_select_path(path, keys)) {
+        error = "Invalid select path '" + std::string(path) + "': " + parser.get_error();
+        return false;
+    }
+    uint32_t node = kRoot;
+    for (const std::string& key : keys) {
+        // Already selected as a whole
+        if (nodes_[node].all) return true;
+        auto inserted = nodes_[node].children.emplace(key, static_cast<uint32_t>(nodes_.size()));
+        if (inserted.second) nodes_.emplace_back();
+        node = inserted.first->second;
+    }
+    // A shorter path covers any longer ones added before it
+    nodes_[node].all = true;
+    nodes_[node].children.clear();
+    return true;
+}
+
+bool TomlParser::parse_select_path(std::string_view text, std::vector<std::string>& keys) {
+    set_input(text);
+    skip_whitespace_no_nl();
+    if (eof()) {
+        set_error(ParseErrorCode::Syntax, "Empty path");
+        return false;
+    }
+    for (;;) {
+        keys.emplace_back();
+        parse_key(keys.back());
+        if (has_error()) return false;
+        skip_whitespace_no_nl();
+        if (end_ - current_ >= 3 && std::memcmp(current_, "[*]", 3) == 0) {
+            current_ += 3;
+            skip_whitespace_no_nl();
+        }
+        if (eof()) return true;
+        expect_char('.');
+        if (has_error()) return false;
+        skip_whitespace_no_nl();
+    }
+}
+
+std::shared_ptr<Table> TomlParser::parse_selected(std::string_view input, const Selection& selection) {
+    // The selected tree is usually small, so the arena starts at its default size
+    TreeBuilder tree(options_.use_arena ? acquire_arena(Arena::kDefaultBlockSize) : nullptr);
+    SelectBuilder<TreeBuilder> builder(tree, selection);
+    if (!parse_with(input, builder)) {
+        return nullptr;
+    }
+    return tree.document();
+}
+
+std::shared_ptr<Table> TomlParser::parse_selected(std::string_view input, const std::vector<std::string>& paths) {
+    Selection selection;
+    std::string error;
+    for (const std::string& path : paths) {
+        if (!selection.add(path, error)) {
+            clear_error();
+            set_error_at(nullptr, ParseErrorCode::InvalidSelectPath, "{}", error);
+            return nullptr;
+        }
+    }
+    return parse_selected(input, selection);
+}
+
+} // namespace fasttoml
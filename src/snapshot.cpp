@@ -0,0 +1,441 @@
+#include "fasttoml/snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace fasttoml {
+namespace {
+
+// Header: magic, the snapshot_hash of everything after it (rest of the
+// header included), version, byte order mark, total size, clock ticks per
+// second (DateTime values are stored as system_clock ticks), the source and
+// the root table's record
+constexpr char kMagic[8] = {'F', 'T', 'O', 'M', 'L', 'S', 'N', 'P'};
+constexpr size_t kHash = 8;
+constexpr size_t kHashed = kHash + 8;
+constexpr uint32_t kVersion = 3;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr size_t kRootRecord = 64;
+constexpr size_t kHeaderSize = kRootRecord + 16;
+constexpr int64_t kTicksPerSecond = DateTime::period::den / DateTime::period::num;
+// Records are {uint8 type, 3 unused, uint32 a, uint64 b}; table entries are
+// {uint32 key offset, uint32 key size, record}
+constexpr size_t kRecordSize = 16;
+constexpr size_t kEntrySize = 8 + kRecordSize;
+// Tables with more entries get an index of entry numbers sorted by key
+constexpr size_t kIndexMin = 16;
+
+[[noreturn]] void damaged() { throw std::out_of_range("Snapshot is damaged"); }
+
+void check(std::string_view data, size_t offset, size_t bytes) {
+    if (offset > data.size() || bytes > data.size() - offset) damaged();
+}
+
+template<typename T>
+T load(std::string_view data, size_t offset) {
+    check(data, offset, sizeof(T));
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+template<typename T>
+uint64_t bits(T value) {
+    uint64_t out = 0;
+    std::memcpy(&out, &value, sizeof(T));
+    return out;
+}
+
+template<typename T>
+T from_bits(uint64_t value) {
+    T out;
+    std::memcpy(&out, &value, sizeof(T));
+    return out;
+}
+
+class SnapshotWriter {
+public:
+    std::string out;
+
+    // Zeroed space for a block at the next 8-byte boundary
+    size_t reserve(size_t bytes) {
+        out.resize((out.size() + 7) & ~size_t(7));
+        const size_t at = out.size();
+        out.resize(at + bytes);
+        return at;
+    }
+
+    template<typename T>
+    void put(size_t at, T value) {
+        std::memcpy(&out[at], &value, sizeof(T));
+    }
+
+    uint32_t offset(size_t at) const {
+        if (at > UINT32_MAX) throw std::length_error("Snapshot exceeds 4 GiB");
+        return static_cast<uint32_t>(at);
+    }
+
+    uint32_t string(std::string_view text) {
+        const uint32_t at = offset(out.size());
+        out.append(text.data(), text.size());
+        offset(out.size());
+        return at;
+    }
+
+    void record(size_t at, SnapshotValue::Type type, uint32_t a, uint64_t b) {
+        put(at, static_cast<uint8_t>(type));
+        put(at + 4, a);
+        put(at + 8, b);
+    }
+
+    // Local dates and times are fields packed into b (the nanoseconds go in a)
+    static uint64_t pack(const LocalDate& date) {
+        return static_cast<uint64_t>(date.year) << 16 | static_cast<uint64_t>(date.month) << 8 |
+               static_cast<uint64_t>(date.day);
+    }
+    static uint64_t pack(const LocalTime& time) {
+        return static_cast<uint64_t>(time.hour) << 24 | static_cast<uint64_t>(time.minute) << 16 |
+               static_cast<uint64_t>(time.second) << 8 | static_cast<uint64_t>(time.precision);
+    }
+
+    void value(size_t at, const TomlValue& value) {
+        using Type = SnapshotValue::Type;
+        std::visit([&](auto&& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, Integer>) {
+                record(at, Type::Integer, 0, bits(v));
+            } else if constexpr (std::is_same_v<T, Float>) {
+                record(at, Type::Float, 0, bits(v));
+            } else if constexpr (std::is_same_v<T, Boolean>) {
+                record(at, Type::Boolean, 0, v ? 1 : 0);
+            } else if constexpr (std::is_same_v<T, String> || std::is_same_v<T, StringView>) {
+                const uint32_t size = offset(v.size());
+                record(at, Type::String, size, string(v));
+            } else if constexpr (std::is_same_v<T, DateTime>) {
+                record(at, Type::DateTime, 0, bits(v.time_since_epoch().count()));
+            } else if constexpr (std::is_same_v<T, DateTimeOffset>) {
+                record(at, Type::DateTimeOffset, static_cast<uint32_t>(v.offset_minutes),
+                       bits(v.utc.time_since_epoch().count()));
+            } else if constexpr (std::is_same_v<T, LocalDate>) {
+                record(at, Type::LocalDate, 0, pack(v));
+            } else if constexpr (std::is_same_v<T, LocalTime>) {
+                record(at, Type::LocalTime, static_cast<uint32_t>(v.nanosecond), pack(v));
+            } else if constexpr (std::is_same_v<T, LocalDateTime>) {
+                record(at, Type::LocalDateTime, static_cast<uint32_t>(v.time.nanosecond),
+                       pack(v.date) << 32 | pack(v.time));
+            } else if constexpr (std::is_same_v<T, TablePtr>) {
+                const size_t block = table(*v);
+                record(at, Type::Table, 0, block);
+            } else {
+                const size_t block = array(*v);
+                record(at, Type::Array, static_cast<uint32_t>(v->storage()), block);
+            }
+        }, value);
+    }
+
+    // Blocks are written after the record that refers to them, which the
+    // reader relies on to reject cycles
+    size_t table(const Table& table) {
+        const size_t n = table.values.size();
+        const bool indexed = n > kIndexMin;
+        const size_t block = reserve(8 + n * kEntrySize + (indexed ? n * sizeof(uint32_t) : 0));
+        put(block, static_cast<uint64_t>(n));
+        const auto* entries = table.values.begin();
+        for (size_t i = 0; i < n; ++i) {
+            const size_t entry = block + 8 + i * kEntrySize;
+            put(entry, string(entries[i].first));
+            put(entry + 4, offset(entries[i].first.size()));
+            value(entry + 8, entries[i].second);
+        }
+        if (indexed) {
+            std::vector<uint32_t> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(),
+                      [entries](uint32_t x, uint32_t y) { return entries[x].first < entries[y].first; });
+            std::memcpy(&out[block + 8 + n * kEntrySize], order.data(), n * sizeof(uint32_t));
+        }
+        return block;
+    }
+
+    size_t array(const Array& array) {
+        const size_t n = array.size();
+        switch (array.storage()) {
+            case Array::Storage::Integers: {
+                const size_t block = reserve(8 + n * sizeof(Integer));
+                put(block, static_cast<uint64_t>(n));
+                if (n) std::memcpy(&out[block + 8], array.integers().data(), n * sizeof(Integer));
+                return block;
+            }
+            case Array::Storage::Floats: {
+                const size_t block = reserve(8 + n * sizeof(Float));
+                put(block, static_cast<uint64_t>(n));
+                if (n) std::memcpy(&out[block + 8], array.floats().data(), n * sizeof(Float));
+                return block;
+            }
+            default: {
+                const size_t block = reserve(8 + n * kRecordSize);
+                put(block, static_cast<uint64_t>(n));
+                for (size_t i = 0; i < n; ++i) value(block + 8 + i * kRecordSize, array.values()[i]);
+                return block;
+            }
+        }
+    }
+};
+
+} // namespace
+
+uint64_t snapshot_hash(std::string_view text) {
+    constexpr uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t h = text.size() * k;
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, text.data() + i, 8);
+        h = (h ^ word) * k;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, text.data() + i, text.size() - i);
+    h = (h ^ tail) * k;
+    return h ^ (h >> 29);
+}
+
+std::string write_snapshot(const Table& root, const SnapshotSource& source) {
+    SnapshotWriter writer;
+    writer.reserve(kHeaderSize);
+    std::memcpy(&writer.out[0], kMagic, sizeof(kMagic));
+    writer.put(16, kVersion);
+    writer.put(20, kByteOrder);
+    writer.put(32, kTicksPerSecond);
+    writer.put(40, source.size);
+    writer.put(48, source.mtime_ns);
+    writer.put(56, source.hash);
+    const size_t block = writer.table(root);
+    writer.record(kRootRecord, SnapshotValue::Type::Table, 0, block);
+    writer.out.resize((writer.out.size() + 7) & ~size_t(7));
+    writer.put(24, static_cast<uint64_t>(writer.out.size()));
+    writer.put(kHash, snapshot_hash(std::string_view(writer.out).substr(kHashed)));
+    return std::move(writer.out);
+}
+
+SnapshotValue SnapshotValue::record(std::string_view data, size_t offset) {
+    const uint8_t type = load<uint8_t>(data, offset);
+    if (type > static_cast<uint8_t>(Type::LocalDateTime)) damaged();
+    return SnapshotValue(data, offset, static_cast<Type>(type), load<uint32_t>(data, offset + 4),
+                         load<uint64_t>(data, offset + 8));
+}
+
+namespace {
+
+void expect(SnapshotValue::Type actual, SnapshotValue::Type expected) {
+    if (actual != expected) throw std::logic_error("Snapshot value has another type");
+}
+
+} // namespace
+
+Integer SnapshotValue::as_integer() const {
+    expect(type_, Type::Integer);
+    return from_bits<Integer>(b_);
+}
+
+Float SnapshotValue::as_float() const {
+    expect(type_, Type::Float);
+    return from_bits<Float>(b_);
+}
+
+Boolean SnapshotValue::as_boolean() const {
+    expect(type_, Type::Boolean);
+    return b_ != 0;
+}
+
+std::string_view SnapshotValue::as_string() const {
+    expect(type_, Type::String);
+    check(data_, b_, a_);
+    return data_.substr(b_, a_);
+}
+
+DateTime SnapshotValue::as_datetime() const {
+    expect(type_, Type::DateTime);
+    return DateTime(DateTime::duration(from_bits<int64_t>(b_)));
+}
+
+DateTimeOffset SnapshotValue::as_datetime_offset() const {
+    expect(type_, Type::DateTimeOffset);
+    return DateTimeOffset{DateTime(DateTime::duration(from_bits<int64_t>(b_))), static_cast<int32_t>(a_)};
+}
+
+namespace {
+
+// Unpack (see SnapshotWriter::pack), checking the fields so that a damaged
+// snapshot cannot produce a date the writer would not format
+LocalDate unpack_date(uint64_t bits) {
+    const LocalDate date{static_cast<int>(bits >> 16 & 0xFFFF), static_cast<int>(bits >> 8 & 0xFF),
+                         static_cast<int>(bits & 0xFF)};
+    if (date.year > 9999 || date.month < 1 || date.month > 12 || date.day < 1 || date.day > 31) damaged();
+    return date;
+}
+
+LocalTime unpack_time(uint64_t bits, uint32_t nanosecond) {
+    const LocalTime time{static_cast<int>(bits >> 24 & 0xFF), static_cast<int>(bits >> 16 & 0xFF),
+                         static_cast<int>(bits >> 8 & 0xFF), static_cast<int>(nanosecond), static_cast<int>(bits & 0xFF)};
+    if (time.hour > 23 || time.minute > 59 || time.second > 60 || nanosecond > 999999999 || time.precision > 9) {
+        damaged();
+    }
+    return time;
+}
+
+} // namespace
+
+LocalDate SnapshotValue::as_local_date() const {
+    expect(type_, Type::LocalDate);
+    return unpack_date(b_);
+}
+
+LocalTime SnapshotValue::as_local_time() const {
+    expect(type_, Type::LocalTime);
+    return unpack_time(b_, a_);
+}
+
+LocalDateTime SnapshotValue::as_local_datetime() const {
+    expect(type_, Type::LocalDateTime);
+    return LocalDateTime{unpack_date(b_ >> 32), unpack_time(b_ & 0xFFFFFFFF, a_)};
+}
+
+SnapshotTable SnapshotValue::as_table() const {
+    expect(type_, Type::Table);
+    if (b_ <= origin_) damaged();
+    return SnapshotTable(data_, b_);
+}
+
+SnapshotArray SnapshotValue::as_array() const {
+    expect(type_, Type::Array);
+    if (b_ <= origin_ || a_ > static_cast<uint32_t>(Array::Storage::Floats)) damaged();
+    return SnapshotArray(data_, b_, static_cast<Array::Storage>(a_));
+}
+
+TomlValue SnapshotValue::to_value() const {
+    switch (type_) {
+        case Type::Integer: return as_integer();
+        case Type::Float: return as_float();
+        case Type::Boolean: return as_boolean();
+        case Type::String: return as_string();
+        case Type::DateTime: return as_datetime();
+        case Type::DateTimeOffset: return as_datetime_offset();
+        case Type::Table: return as_table().to_table();
+        case Type::LocalDate: return as_local_date();
+        case Type::LocalTime: return as_local_time();
+        case Type::LocalDateTime: return as_local_datetime();
+        default: return as_array().to_array();
+    }
+}
+
+SnapshotTable::SnapshotTable(std::string_view data, size_t offset)
+    : data_(data), offset_(offset), size_(load<uint64_t>(data, offset)) {
+    const size_t entry_size = kEntrySize + (size_ > kIndexMin ? sizeof(uint32_t) : 0);
+    if (size_ > (data.size() - offset - 8) / entry_size) damaged();
+}
+
+std::string_view SnapshotTable::key(size_t i) const {
+    const size_t entry = offset_ + 8 + i * kEntrySize;
+    const uint32_t at = load<uint32_t>(data_, entry);
+    const uint32_t size = load<uint32_t>(data_, entry + 4);
+    check(data_, at, size);
+    return data_.substr(at, size);
+}
+
+SnapshotValue SnapshotTable::value(size_t i) const {
+    return SnapshotValue::record(data_, offset_ + 8 + i * kEntrySize + 8);
+}
+
+size_t SnapshotTable::find(std::string_view key) const {
+    if (size_ <= kIndexMin) {
+        for (size_t i = 0; i < size_; ++i) {
+            if (this->key(i) == key) return i;
+        }
+        return size_;
+    }
+    const size_t index = offset_ + 8 + size_ * kEntrySize;
+    size_t low = 0;
+    size_t high = size_;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const uint32_t i = load<uint32_t>(data_, index + mid * sizeof(uint32_t));
+        if (i >= size_) damaged();
+        const int order = this->key(i).compare(key);
+        if (order == 0) return i;
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return size_;
+}
+
+TablePtr SnapshotTable::to_table() const {
+    auto table = std::make_shared<Table>();
+    table->values.reserve(size_);
+    for (size_t i = 0; i < size_; ++i) table->values.try_emplace(std::string(key(i)), value(i).to_value());
+    return table;
+}
+
+SnapshotArray::SnapshotArray(std::string_view data, size_t offset, Array::Storage storage)
+    : data_(data), offset_(offset), size_(load<uint64_t>(data, offset)), storage_(storage) {
+    const size_t element_size = storage == Array::Storage::Values ? kRecordSize : 8;
+    if (size_ > (data.size() - offset - 8) / element_size) damaged();
+}
+
+SnapshotValue SnapshotArray::at(size_t i) const {
+    switch (storage_) {
+        case Array::Storage::Integers:
+            return SnapshotValue(data_, offset_ + 8 + i * 8, SnapshotValue::Type::Integer, 0,
+                                 load<uint64_t>(data_, offset_ + 8 + i * 8));
+        case Array::Storage::Floats:
+            return SnapshotValue(data_, offset_ + 8 + i * 8, SnapshotValue::Type::Float, 0,
+                                 load<uint64_t>(data_, offset_ + 8 + i * 8));
+        default:
+            return SnapshotValue::record(data_, offset_ + 8 + i * kRecordSize);
+    }
+}
+
+const Integer* SnapshotArray::integers() const {
+    return reinterpret_cast<const Integer*>(data_.data() + offset_ + 8);
+}
+
+const Float* SnapshotArray::floats() const {
+    return reinterpret_cast<const Float*>(data_.data() + offset_ + 8);
+}
+
+ArrayPtr SnapshotArray::to_array() const {
+    auto array = std::make_shared<Array>();
+    if (storage_ == Array::Storage::Values) array->reserve(size_);
+    for (size_t i = 0; i < size_; ++i) array->append(at(i).to_value());
+    return array;
+}
+
+bool Snapshot::open(std::string_view data) {
+    if (data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0 ||
+        load<uint32_t>(data, 16) != kVersion || load<uint32_t>(data, 20) != kByteOrder ||
+        load<uint64_t>(data, 24) != data.size() || load<int64_t>(data, 32) != kTicksPerSecond) {
+        return false;
+    }
+    data_ = data;
+    source_.size = load<uint64_t>(data, 40);
+    source_.mtime_ns = load<int64_t>(data, 48);
+    source_.hash = load<uint64_t>(data, 56);
+    return true;
+}
+
+bool Snapshot::verify() const {
+    return snapshot_hash(data_.substr(kHashed)) == load<uint64_t>(data_, kHash);
+}
+
+SnapshotTable Snapshot::root() const {
+    const SnapshotValue root = SnapshotValue::record(data_, kRootRecord);
+    // The writer puts the root table's block right after the header
+    if (root.type() != SnapshotValue::Type::Table || root.b_ != kHeaderSize) damaged();
+    return root.as_table();
+}
+
+} // namespace fasttoml
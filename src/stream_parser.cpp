@@ -0,0 +1,224 @@
+#include "fasttoml/stream_parser.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace fasttoml {
+
+// Builder that turns the parser's callbacks into events. Nothing is built, so
+// every key looks new to the parser.
+class StreamParser::Builder {
+public:
+    // true for an array or inline table, which is closed by End once complete
+    using Value = bool;
+    using TableRef = Builder*;
+    using ArrayRef = Builder*;
+
+    explicit Builder(std::deque<Event>& events) : events_(events) {}
+
+    TableRef root() { return this; }
+
+    NodeKind find(TableRef, const std::string&, TableRef&, ArrayRef&) { return NodeKind::Missing; }
+
+    TableRef add_table(TableRef, const std::string&) { return this; }
+
+    ArrayRef add_array(TableRef, const std::string&) { return this; }
+
+    TableRef append_table(ArrayRef) { return this; }
+
+    // Not asked: find() never reports an array
+    size_t array_size(ArrayRef) const { return 0; }
+
+    TableRef last_table(ArrayRef) { return this; }
+
+    Value new_table(TableRef& out) {
+        out = this;
+        push(Event::Type::BeginInlineTable);
+        return true;
+    }
+
+    Value new_array(ArrayRef& out) {
+        out = this;
+        push(Event::Type::BeginArray);
+        return true;
+    }
+
+    void append(ArrayRef, Value&& container) {
+        if (container) push(Event::Type::End);
+    }
+
+    void set(TableRef, const std::string&, Value&& container) {
+        if (container) push(Event::Type::End);
+    }
+
+    Value scalar(TomlValue&& value) {
+        events_.push_back(Event{Event::Type::Scalar, {}, std::move(value)});
+        return false;
+    }
+
+    // Each key is wanted; asked right before its value is parsed
+    bool select(TableRef, const std::vector<std::string>& path) {
+        events_.push_back(Event{Event::Type::Key, path, {}});
+        return true;
+    }
+
+    void header(const std::vector<std::string>& path, bool array_of_tables) {
+        events_.push_back(Event{array_of_tables ? Event::Type::ArrayTable : Event::Type::Table, path, {}});
+    }
+
+private:
+    void push(Event::Type type) { events_.push_back(Event{type, {}, {}}); }
+
+    std::deque<Event>& events_;
+};
+
+static ParseOptions stream_options(ParseOptions options) {
+    // Events outlive the buffered input they were parsed from
+    options.string_views = false;
+    return options;
+}
+
+StreamParser::StreamParser(const ParseOptions& options) : parser_(stream_options(options)) {}
+
+bool StreamParser::feed(const char* data, size_t size) {
+    if (has_error()) return false;
+    if (finished_) {
+        error_message_ = "Input fed after finish()";
+        return false;
+    }
+    buffer_.append(data, size);
+    scan();
+    return parse_buffered(complete_);
+}
+
+bool StreamParser::finish() {
+    if (has_error()) return false;
+    finished_ = true;
+    // Whatever is left is the last statement, complete or not
+    scan_ = buffer_.size();
+    return parse_buffered(buffer_.size());
+}
+
+bool StreamParser::next(Event& event) {
+    if (events_.empty()) return false;
+    event = std::move(events_.front());
+    events_.pop_front();
+    return true;
+}
+
+// A statement ends at a newline outside strings, comments, arrays and inline
+// tables. Tokens that could continue in the next chunk (a quote that may open
+// or close a multiline string, an escape) are left for the next scan; at
+// finish() the rest is parsed as it is.
+void StreamParser::scan() {
+    const char* begin = buffer_.data();
+    const char* end = begin + buffer_.size();
+    const char* p = begin + scan_;
+    while (p < end) {
+        switch (mode_) {
+            case Mode::Value: {
+                p = simd_utils::find_value_delim(p, end);
+                if (p == end) break;
+                const char c = *p;
+                if (c == '\n') {
+                    ++p;
+                    if (depth_ == 0) complete_ = static_cast<size_t>(p - begin);
+                } else if (c == '#') {
+                    mode_ = Mode::Comment;
+                    ++p;
+                } else if (c == '"' || c == '\'') {
+                    if (end - p < 3) goto wait;
+                    const bool triple = p[1] == c && p[2] == c;
+                    if (c == '"') {
+                        mode_ = triple ? Mode::MultilineBasic : Mode::Basic;
+                    } else {
+                        mode_ = triple ? Mode::MultilineLiteral : Mode::Literal;
+                    }
+                    p += triple ? 3 : 1;
+                } else if (c == '[' || c == '{') {
+                    ++depth_;
+                    ++p;
+                } else if (c == ']' || c == '}') {
+                    // Stray closers are left for the parser to reject
+                    if (depth_ > 0) --depth_;
+                    ++p;
+                } else {
+                    ++p;
+                }
+                break;
+            }
+            case Mode::Comment:
+                p = simd_utils::find_char_simd(p, end, '\n');
+                if (p != end) mode_ = Mode::Value;
+                break;
+            case Mode::Basic:
+            case Mode::Literal: {
+                const bool basic = mode_ == Mode::Basic;
+                const char quote = basic ? '"' : '\'';
+                p = simd_utils::find_string_special(p, end, quote, basic);
+                if (p == end) break;
+                if (*p == quote) {
+                    mode_ = Mode::Value;
+                    ++p;
+                } else if (*p == '\\') {
+                    if (end - p < 2) goto wait;
+                    p += 2;
+                } else if (*p == '\n') {
+                    // Unterminated string; the parser reports it
+                    mode_ = Mode::Value;
+                } else {
+                    ++p;
+                }
+                break;
+            }
+            case Mode::MultilineBasic:
+            case Mode::MultilineLiteral: {
+                const bool basic = mode_ == Mode::MultilineBasic;
+                const char quote = basic ? '"' : '\'';
+                p = simd_utils::find_string_special(p, end, quote, basic);
+                if (p == end) break;
+                if (*p == quote) {
+                    // Same closing rule as the multiline string parsers
+                    const char* run = p;
+                    while (p < end && *p == quote) ++p;
+                    if (p == end) {
+                        p = run;
+                        goto wait;
+                    }
+                    const size_t n = static_cast<size_t>(p - run);
+                    if (n >= 3 && (n == 3 || *p == '\n' || *p == '\r')) mode_ = Mode::Value;
+                } else if (*p == '\\') {
+                    if (end - p < 2) goto wait;
+                    p += 2;
+                } else {
+                    ++p;
+                }
+                break;
+            }
+        }
+    }
+wait:
+    scan_ = static_cast<size_t>(p - begin);
+}
+
+bool StreamParser::parse_buffered(size_t end) {
+    if (end == 0) return true;
+    Builder builder(events_);
+    if (!parser_.parse_with(std::string_view(buffer_.data(), end), builder)) {
+        error_message_ = parser_.has_error() ? parser_.get_error() : "unknown error";
+        // Statements start at a line start, so only offset and line move
+        result_ = parser_.result();
+        if (result_.line != 0) {
+            result_.offset += consumed_;
+            result_.line += consumed_lines_;
+        }
+        return false;
+    }
+    consumed_ += end;
+    consumed_lines_ += static_cast<size_t>(std::count(buffer_.data(), buffer_.data() + end, '\n'));
+    buffer_.erase(0, end);
+    scan_ -= end;
+    complete_ = 0;
+    return true;
+}
+
+} // namespace fasttoml
@@ -1,14 +1,29 @@
 #include "fasttoml/toml_parser.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 #include <cctype>
-#include <ctime>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <iomanip>
 #include <regex>
+#include <thread>
 
-#ifdef __AVX2__
+// x86-64 always has SSE2; the AVX2 kernels are compiled for AVX2 with a target
+// attribute (MSVC needs none) and chosen at load time, so no -mavx2 is needed
+#if defined(__SSE2__) || defined(_M_X64)
+#define FASTTOML_X86 1
 #include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define FASTTOML_AVX2
+#else
+#define FASTTOML_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
 #endif
 
 // Cross-platform count trailing zeros
@@ -46,9 +61,51 @@ inline bool is_whitespace_no_nl(char c) {
     return c == ' ' || c == '\t' || c == '\r';
 }
 
-#if defined(__AVX2__)
+#if defined(FASTTOML_X86)
+namespace {
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    // AVX with OSXSAVE, and the OS saving the YMM registers
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// FASTTOML_SIMD=sse2 forces the SSE2 kernels, e.g. to test them on an AVX2 machine
+bool select_avx2() {
+    const char* forced = std::getenv("FASTTOML_SIMD");
+    if (forced && std::strcmp(forced, "sse2") == 0) return false;
+    return cpu_has_avx2();
+}
+
+// Kernel set in use, decided once when the library is loaded
+const bool use_avx2 = select_avx2();
+
+} // namespace
+#endif
+
+const char* isa() {
+#if defined(FASTTOML_X86)
+    return use_avx2 ? "avx2" : "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+#if defined(FASTTOML_X86)
 // AVX2-optimized skip whitespace
-const char* skip_whitespace(const char* ptr, const char* end) {
+FASTTOML_AVX2 static const char* skip_whitespace_avx2(const char* ptr, const char* end) {
     if (end - ptr < 32) {
         // Small buffer, use scalar code
         while (ptr < end && is_whitespace(*ptr)) {
@@ -95,7 +152,7 @@ const char* skip_whitespace(const char* ptr, const char* end) {
 }
 
 // AVX2-optimized skip whitespace (no newlines)
-const char* skip_whitespace_no_nl(const char* ptr, const char* end) {
+FASTTOML_AVX2 static const char* skip_whitespace_no_nl_avx2(const char* ptr, const char* end) {
     if (end - ptr < 32) {
         while (ptr < end && is_whitespace_no_nl(*ptr)) {
             ++ptr;
@@ -133,7 +190,7 @@ const char* skip_whitespace_no_nl(const char* ptr, const char* end) {
 }
 
 // AVX2-optimized find character
-const char* find_char_simd(const char* ptr, const char* end, char c) {
+FASTTOML_AVX2 static const char* find_char_simd_avx2(const char* ptr, const char* end, char c) {
     if (end - ptr < 32) {
         while (ptr < end && *ptr != c) {
             ++ptr;
@@ -163,6 +220,136 @@ const char* find_char_simd(const char* ptr, const char* end, char c) {
     return ptr;
 }
 
+// SSE2 versions, 16 bytes at a time
+static const char* skip_whitespace_sse2(const char* ptr, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i combined = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, nl)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(combined));
+        if (mask != 0xFFFFU) {
+            return ptr + ctz(~mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && is_whitespace(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+static const char* skip_whitespace_no_nl_sse2(const char* ptr, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i combined = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                        _mm_cmpeq_epi8(chunk, cr));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(combined));
+        if (mask != 0xFFFFU) {
+            return ptr + ctz(~mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && is_whitespace_no_nl(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+static const char* find_char_simd_sse2(const char* ptr, const char* end, char c) {
+    const __m128i target = _mm_set1_epi8(c);
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && *ptr != c) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* skip_whitespace(const char* ptr, const char* end) {
+    return use_avx2 ? skip_whitespace_avx2(ptr, end) : skip_whitespace_sse2(ptr, end);
+}
+
+const char* skip_whitespace_no_nl(const char* ptr, const char* end) {
+    return use_avx2 ? skip_whitespace_no_nl_avx2(ptr, end) : skip_whitespace_no_nl_sse2(ptr, end);
+}
+
+const char* find_char_simd(const char* ptr, const char* end, char c) {
+    return use_avx2 ? find_char_simd_avx2(ptr, end, c) : find_char_simd_sse2(ptr, end, c);
+}
+#elif defined(__ARM_NEON)
+// First set byte of a 0x00/0xFF NEON mask, narrowed to 4 bits per byte; 16 if none
+static inline int first_set_neon(uint8x16_t hit) {
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+    return mask != 0 ? ctz(static_cast<unsigned long long>(mask)) >> 2 : 16;
+}
+
+const char* skip_whitespace(const char* ptr, const char* end) {
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t cr = vdupq_n_u8('\r');
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(chunk, space), vceqq_u8(chunk, tab)),
+                                 vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, nl)));
+        int idx = first_set_neon(vmvnq_u8(ws));
+        if (idx < 16) {
+            return ptr + idx;
+        }
+        ptr += 16;
+    }
+    while (ptr < end && is_whitespace(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* skip_whitespace_no_nl(const char* ptr, const char* end) {
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t cr = vdupq_n_u8('\r');
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(chunk, space), vceqq_u8(chunk, tab)), vceqq_u8(chunk, cr));
+        int idx = first_set_neon(vmvnq_u8(ws));
+        if (idx < 16) {
+            return ptr + idx;
+        }
+        ptr += 16;
+    }
+    while (ptr < end && is_whitespace_no_nl(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* find_char_simd(const char* ptr, const char* end, char c) {
+    const uint8x16_t target = vdupq_n_u8(static_cast<uint8_t>(c));
+    while (end - ptr >= 16) {
+        int idx = first_set_neon(vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(ptr)), target));
+        if (idx < 16) {
+            return ptr + idx;
+        }
+        ptr += 16;
+    }
+    while (ptr < end && *ptr != c) {
+        ++ptr;
+    }
+    return ptr;
+}
 #else
 // Fallback scalar implementations
 const char* skip_whitespace(const char* ptr, const char* end) {
@@ -187,328 +374,1129 @@ const char* find_char_simd(const char* ptr, const char* end, char c) {
 }
 #endif
 
-} // namespace simd_utils
+static inline bool is_string_special(char c, char quote, bool basic) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return c == quote || (basic && c == '\\') || (u <= 0x1F && u != 0x09) || u == 0x7F;
+}
 
-// TomlParser implementation
-TomlParser::TomlParser() : current_(nullptr), end_(nullptr) {
-    root_table_ = std::make_shared<Table>();
-    current_table_ = root_table_;
+#if defined(FASTTOML_X86)
+FASTTOML_AVX2 static const char* find_string_special_avx2(const char* ptr, const char* end, char quote, bool basic) {
+    const __m256i q = _mm256_set1_epi8(quote);
+    // Backslash only matters for basic strings; for literal strings compare against the quote twice
+    const __m256i bs = _mm256_set1_epi8(basic ? '\\' : quote);
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    while (end - ptr >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        // Unsigned chunk <= 0x1F: min(chunk, 0x1F) == chunk
+        __m256i ctrl = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, tab),
+                                           _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, ctrl_max), chunk));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, q), _mm256_cmpeq_epi8(chunk, bs)),
+            _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(chunk, del)));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 32;
+    }
+    while (ptr < end && !is_string_special(*ptr, quote, basic)) {
+        ++ptr;
+    }
+    return ptr;
 }
 
-TomlParser::~TomlParser() = default;
+static const char* find_string_special_sse2(const char* ptr, const char* end, char quote, bool basic) {
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i bs = _mm_set1_epi8(basic ? '\\' : quote);
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i del = _mm_set1_epi8(0x7F);
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i ctrl = _mm_andnot_si128(_mm_cmpeq_epi8(chunk, tab),
+                                        _mm_cmpeq_epi8(_mm_min_epu8(chunk, ctrl_max), chunk));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, q), _mm_cmpeq_epi8(chunk, bs)),
+            _mm_or_si128(ctrl, _mm_cmpeq_epi8(chunk, del)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_string_special(*ptr, quote, basic)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* find_string_special(const char* ptr, const char* end, char quote, bool basic) {
+    return use_avx2 ? find_string_special_avx2(ptr, end, quote, basic) : find_string_special_sse2(ptr, end, quote, basic);
+}
+#elif defined(__ARM_NEON)
+const char* find_string_special(const char* ptr, const char* end, char quote, bool basic) {
+    const uint8x16_t q = vdupq_n_u8(static_cast<uint8_t>(quote));
+    const uint8x16_t bs = vdupq_n_u8(static_cast<uint8_t>(basic ? '\\' : quote));
+    const uint8x16_t ctrl_max = vdupq_n_u8(0x1F);
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t del = vdupq_n_u8(0x7F);
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t ctrl = vbicq_u8(vcleq_u8(chunk, ctrl_max), vceqq_u8(chunk, tab));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(chunk, q), vceqq_u8(chunk, bs)),
+                                  vorrq_u8(ctrl, vceqq_u8(chunk, del)));
+        // Narrow to 4 bits per byte to get a 64-bit movemask equivalent
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask != 0) {
+            return ptr + (ctz(static_cast<unsigned long long>(mask)) >> 2);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_string_special(*ptr, quote, basic)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#else
+const char* find_string_special(const char* ptr, const char* end, char quote, bool basic) {
+    while (ptr < end && !is_string_special(*ptr, quote, basic)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#endif
 
-// TOML 1.0: control chars U+0000-U+001F (except tab, LF, CR in CRLF) and U+007F are not permitted
-static bool is_forbidden_control(char c) {
+static inline bool needs_escape(char c) {
     unsigned char u = static_cast<unsigned char>(c);
-    if (u == 0x09 || u == 0x0A) return false;  // tab, LF always allowed
-    if (u == 0x0D) return false;  // CR allowed only in CRLF; checked separately
-    if (u <= 0x1F || u == 0x7F) return true;
-    return false;
+    return c == '"' || c == '\\' || u <= 0x1F || u == 0x7F;
+}
+
+#if defined(FASTTOML_X86)
+FASTTOML_AVX2 static const char* find_escape_char_avx2(const char* ptr, const char* end) {
+    const __m256i q = _mm256_set1_epi8('"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    while (end - ptr >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, ctrl_max), chunk);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, q), _mm256_cmpeq_epi8(chunk, bs)),
+            _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(chunk, del)));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 32;
+    }
+    while (ptr < end && !needs_escape(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+static const char* find_escape_char_sse2(const char* ptr, const char* end) {
+    const __m128i q = _mm_set1_epi8('"');
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    const __m128i del = _mm_set1_epi8(0x7F);
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, ctrl_max), chunk);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, q), _mm_cmpeq_epi8(chunk, bs)),
+            _mm_or_si128(ctrl, _mm_cmpeq_epi8(chunk, del)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !needs_escape(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* find_escape_char(const char* ptr, const char* end) {
+    return use_avx2 ? find_escape_char_avx2(ptr, end) : find_escape_char_sse2(ptr, end);
+}
+#elif defined(__ARM_NEON)
+const char* find_escape_char(const char* ptr, const char* end) {
+    const uint8x16_t q = vdupq_n_u8('"');
+    const uint8x16_t bs = vdupq_n_u8('\\');
+    const uint8x16_t ctrl_max = vdupq_n_u8(0x1F);
+    const uint8x16_t del = vdupq_n_u8(0x7F);
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(chunk, q), vceqq_u8(chunk, bs)),
+                                  vorrq_u8(vcleq_u8(chunk, ctrl_max), vceqq_u8(chunk, del)));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask != 0) {
+            return ptr + (ctz(static_cast<unsigned long long>(mask)) >> 2);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !needs_escape(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#else
+const char* find_escape_char(const char* ptr, const char* end) {
+    while (ptr < end && !needs_escape(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#endif
+
+// Bytes that end a run of value characters for skip_value: quotes, brackets,
+// braces, '#', ',' and line breaks (tab too, which is harmless)
+static inline bool is_value_delim(char c) {
+    switch (c) {
+        case '"': case '\'': case '[': case ']': case '{': case '}':
+        case '#': case ',': case '\t': case '\n': case '\r':
+            return true;
+        default:
+            return false;
+    }
+}
+
+#if defined(FASTTOML_X86)
+FASTTOML_AVX2 static const char* find_value_delim_avx2(const char* ptr, const char* end) {
+    // '[' '{' and ']' '}' differ only in bit 0x20, as do '"' '#' in bit 0x01;
+    // tab, LF and CR are the only bytes <= 0x0D left after input validation
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i low_bit = _mm256_set1_epi8(0x01);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i hash = _mm256_set1_epi8('#');
+    const __m256i apos = _mm256_set1_epi8('\'');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i ctrl_max = _mm256_set1_epi8(0x0D);
+    while (end - ptr >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        __m256i folded = _mm256_or_si256(chunk, case_bit);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_or_si256(chunk, low_bit), hash),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, apos), _mm256_cmpeq_epi8(chunk, comma))));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, ctrl_max), chunk));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 32;
+    }
+    while (ptr < end && !is_value_delim(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+static const char* find_value_delim_sse2(const char* ptr, const char* end) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i low_bit = _mm_set1_epi8(0x01);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i apos = _mm_set1_epi8('\'');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i ctrl_max = _mm_set1_epi8(0x0D);
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i folded = _mm_or_si128(chunk, case_bit);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+            _mm_or_si128(_mm_cmpeq_epi8(_mm_or_si128(chunk, low_bit), hash),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, apos), _mm_cmpeq_epi8(chunk, comma))));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(chunk, ctrl_max), chunk));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_value_delim(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+const char* find_value_delim(const char* ptr, const char* end) {
+    return use_avx2 ? find_value_delim_avx2(ptr, end) : find_value_delim_sse2(ptr, end);
+}
+#elif defined(__ARM_NEON)
+const char* find_value_delim(const char* ptr, const char* end) {
+    const uint8x16_t case_bit = vdupq_n_u8(0x20);
+    const uint8x16_t low_bit = vdupq_n_u8(0x01);
+    const uint8x16_t open = vdupq_n_u8('{');
+    const uint8x16_t close = vdupq_n_u8('}');
+    const uint8x16_t hash = vdupq_n_u8('#');
+    const uint8x16_t apos = vdupq_n_u8('\'');
+    const uint8x16_t comma = vdupq_n_u8(',');
+    const uint8x16_t ctrl_max = vdupq_n_u8(0x0D);
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t folded = vorrq_u8(chunk, case_bit);
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(folded, open), vceqq_u8(folded, close)),
+                                  vorrq_u8(vceqq_u8(vorrq_u8(chunk, low_bit), hash),
+                                           vorrq_u8(vceqq_u8(chunk, apos), vceqq_u8(chunk, comma))));
+        hit = vorrq_u8(hit, vcleq_u8(chunk, ctrl_max));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask != 0) {
+            return ptr + (ctz(static_cast<unsigned long long>(mask)) >> 2);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_value_delim(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#else
+const char* find_value_delim(const char* ptr, const char* end) {
+    while (ptr < end && !is_value_delim(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#endif
+
+// Bytes find_structural stops at
+static inline bool is_structural(char c) {
+    switch (c) {
+        case '"': case '\'': case '[': case ']': case '{': case '}': case '#': case '\n':
+            return true;
+        default:
+            return false;
+    }
+}
+
+#if defined(FASTTOML_X86)
+FASTTOML_AVX2 static const char* find_structural_avx2(const char* ptr, const char* end) {
+    // Same folding as find_value_delim; LF is the only control byte left
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i low_bit = _mm256_set1_epi8(0x01);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i hash = _mm256_set1_epi8('#');
+    const __m256i apos = _mm256_set1_epi8('\'');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    while (end - ptr >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        __m256i folded = _mm256_or_si256(chunk, case_bit);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_or_si256(chunk, low_bit), hash),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, apos), _mm256_cmpeq_epi8(chunk, lf))));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 32;
+    }
+    while (ptr < end && !is_structural(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+
+static const char* find_structural_sse2(const char* ptr, const char* end) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i low_bit = _mm_set1_epi8(0x01);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i apos = _mm_set1_epi8('\'');
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i folded = _mm_or_si128(chunk, case_bit);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+            _mm_or_si128(_mm_cmpeq_epi8(_mm_or_si128(chunk, low_bit), hash),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, apos), _mm_cmpeq_epi8(chunk, lf))));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) {
+            return ptr + ctz(mask);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_structural(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
 }
 
-std::shared_ptr<Table> TomlParser::parse(const std::string& input) {
-    error_message_.clear();
-    array_of_tables_paths_.clear();
-    const size_t n = input.size();
-    for (size_t i = 0; i < n; ++i) {
-        unsigned char u = static_cast<unsigned char>(input[i]);
+const char* find_structural(const char* ptr, const char* end) {
+    return use_avx2 ? find_structural_avx2(ptr, end) : find_structural_sse2(ptr, end);
+}
+#elif defined(__ARM_NEON)
+const char* find_structural(const char* ptr, const char* end) {
+    const uint8x16_t case_bit = vdupq_n_u8(0x20);
+    const uint8x16_t low_bit = vdupq_n_u8(0x01);
+    const uint8x16_t open = vdupq_n_u8('{');
+    const uint8x16_t close = vdupq_n_u8('}');
+    const uint8x16_t hash = vdupq_n_u8('#');
+    const uint8x16_t apos = vdupq_n_u8('\'');
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t folded = vorrq_u8(chunk, case_bit);
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(folded, open), vceqq_u8(folded, close)),
+                                  vorrq_u8(vceqq_u8(vorrq_u8(chunk, low_bit), hash),
+                                           vorrq_u8(vceqq_u8(chunk, apos), vceqq_u8(chunk, lf))));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask != 0) {
+            return ptr + (ctz(static_cast<unsigned long long>(mask)) >> 2);
+        }
+        ptr += 16;
+    }
+    while (ptr < end && !is_structural(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#else
+const char* find_structural(const char* ptr, const char* end) {
+    while (ptr < end && !is_structural(*ptr)) {
+        ++ptr;
+    }
+    return ptr;
+}
+#endif
+
+// Validate one character (ASCII byte or UTF-8 sequence) at p; returns the
+// position after it, or nullptr with err set. Used for non-plain bytes and tails.
+static const char* validate_char(const char* p, const char* end, InputError& err) {
+    unsigned char u = static_cast<unsigned char>(*p);
+    if (u < 0x80) {
         if (u == 0x0D) {
             // CR only permitted as part of CRLF
-            if (i + 1 >= n || input[i + 1] != '\n') {
-                set_error("Control characters (U+0000-U+001F except tab/LF/CR in CRLF) and U+007F are not permitted");
-                return nullptr;
-            }
-        } else if (is_forbidden_control(static_cast<char>(u))) {
-            set_error("Control characters (U+0000-U+001F except tab/LF/CR in CRLF) and U+007F are not permitted");
-            return nullptr;
+            if (p + 1 >= end || p[1] != '\n') { err = InputError::ControlChar; return nullptr; }
+            return p + 2;
         }
+        if ((u <= 0x1F && u != 0x09 && u != 0x0A) || u == 0x7F) { err = InputError::ControlChar; return nullptr; }
+        return p + 1;
     }
-    current_ = input.c_str();
-    end_ = current_ + input.size();
-    root_table_ = std::make_shared<Table>();
-    current_table_ = root_table_;
-    
-    try {
-        parse_document();
-    } catch (const std::exception& e) {
-        set_error(e.what());
-        return nullptr;
+    // Strict UTF-8: no overlongs, no surrogates, nothing above U+10FFFF
+    int len;
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (u >= 0xC2 && u <= 0xDF) len = 2;
+    else if (u == 0xE0) { len = 3; lo = 0xA0; }
+    else if (u == 0xED) { len = 3; hi = 0x9F; }
+    else if (u >= 0xE1 && u <= 0xEF) len = 3;
+    else if (u == 0xF0) { len = 4; lo = 0x90; }
+    else if (u >= 0xF1 && u <= 0xF3) len = 4;
+    else if (u == 0xF4) { len = 4; hi = 0x8F; }
+    else { err = InputError::InvalidUtf8; return nullptr; }
+    if (end - p < len) { err = InputError::InvalidUtf8; return nullptr; }
+    unsigned char c1 = static_cast<unsigned char>(p[1]);
+    if (c1 < lo || c1 > hi) { err = InputError::InvalidUtf8; return nullptr; }
+    for (int i = 2; i < len; ++i) {
+        if ((static_cast<unsigned char>(p[i]) & 0xC0) != 0x80) { err = InputError::InvalidUtf8; return nullptr; }
     }
-    
-    if (has_error()) {
-        return nullptr;
+    return p + len;
+}
+
+static InputError validate_scalar(const char* ptr, const char* end, const char** error_pos) {
+    InputError err = InputError::None;
+    while (ptr < end) {
+        // Printable ASCII and tab/LF need no further checks
+        unsigned char u = static_cast<unsigned char>(*ptr);
+        if ((u >= 0x20 && u < 0x7F) || u == 0x09 || u == 0x0A) { ++ptr; continue; }
+        const char* next = validate_char(ptr, end, err);
+        if (!next) {
+            if (error_pos) *error_pos = ptr;
+            return err;
+        }
+        ptr = next;
     }
-    
-    return root_table_;
+    return InputError::None;
 }
 
-void TomlParser::parse_document() {
-    skip_whitespace();
-    while (!eof()) {
-        skip_whitespace();
-        if (eof()) break;
-        
-        if (peek() == '#') {
-            skip_comment();
-            continue;
+#if defined(FASTTOML_X86)
+// UTF-8 validation after Keiser & Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte" (the simdjson/simdutf lookup algorithm): three nibble
+// lookups classify each (previous byte, current byte) pair into error bits.
+namespace {
+
+constexpr uint8_t TOO_SHORT = 1 << 0;      // lead byte not followed by continuation
+constexpr uint8_t TOO_LONG = 1 << 1;       // ASCII followed by continuation
+constexpr uint8_t OVERLONG_3 = 1 << 2;
+constexpr uint8_t TOO_LARGE = 1 << 3;
+constexpr uint8_t SURROGATE = 1 << 4;
+constexpr uint8_t OVERLONG_2 = 1 << 5;
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+constexpr uint8_t OVERLONG_4 = 1 << 6;
+constexpr uint8_t TWO_CONTS = 1 << 7;      // continuation not preceded by lead
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+FASTTOML_AVX2 inline __m256i lookup16(__m256i idx, uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3,
+                        uint8_t t4, uint8_t t5, uint8_t t6, uint8_t t7,
+                        uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11,
+                        uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15) {
+    const __m256i table = _mm256_setr_epi8(
+        (char)t0, (char)t1, (char)t2, (char)t3, (char)t4, (char)t5, (char)t6, (char)t7,
+        (char)t8, (char)t9, (char)t10, (char)t11, (char)t12, (char)t13, (char)t14, (char)t15,
+        (char)t0, (char)t1, (char)t2, (char)t3, (char)t4, (char)t5, (char)t6, (char)t7,
+        (char)t8, (char)t9, (char)t10, (char)t11, (char)t12, (char)t13, (char)t14, (char)t15);
+    return _mm256_shuffle_epi8(table, idx);
+}
+
+FASTTOML_AVX2 inline __m256i high_nibble(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Bytes of input shifted right by N, filling from the end of prev
+template<int N>
+FASTTOML_AVX2 inline __m256i prev_bytes(__m256i input, __m256i prev) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+FASTTOML_AVX2 inline __m256i utf8_block_errors(__m256i input, __m256i prev_input) {
+    const __m256i prev1 = prev_bytes<1>(input, prev_input);
+    const __m256i byte_1_high = lookup16(high_nibble(prev1),
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const __m256i byte_1_low = lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)),
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const __m256i byte_2_high = lookup16(high_nibble(input),
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+    // Third/fourth bytes of 3/4-byte sequences must be continuations (TWO_CONTS is expected there)
+    const __m256i prev2 = prev_bytes<2>(input, prev_input);
+    const __m256i prev3 = prev_bytes<3>(input, prev_input);
+    const __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m256i must23_80 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must23_80, special);
+}
+
+// Bit i set where byte i is a TOML-forbidden control byte; CR is reported
+// separately so the caller can pair it with the following LF.
+FASTTOML_AVX2 inline unsigned int control_mask(__m256i chunk, unsigned int& cr_mask, unsigned int& lf_mask) {
+    const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk);
+    const __m256i tab = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'));
+    const __m256i lf = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+    const __m256i cr = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'));
+    const __m256i del = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(0x7F));
+    const __m256i bad = _mm256_or_si256(_mm256_andnot_si256(_mm256_or_si256(_mm256_or_si256(tab, lf), cr), ctrl), del);
+    cr_mask = static_cast<unsigned int>(_mm256_movemask_epi8(cr));
+    lf_mask = static_cast<unsigned int>(_mm256_movemask_epi8(lf));
+    return static_cast<unsigned int>(_mm256_movemask_epi8(bad));
+}
+
+} // namespace
+
+FASTTOML_AVX2 static InputError validate_input_avx2(const char* ptr, const char* end, const char** error_pos) {
+    const char* const begin = ptr;
+    __m256i prev = _mm256_setzero_si256();
+    __m256i utf8_error = _mm256_setzero_si256();
+    bool prev_ascii = true;
+    alignas(32) char tail[32];
+    bool done = false;
+    while (!done) {
+        const char* block = ptr;
+        __m256i chunk;
+        bool next_is_lf;
+        if (end - ptr >= 32) {
+            chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+            next_is_lf = end - ptr > 32 && ptr[32] == '\n';
+            ptr += 32;
+        } else {
+            // Final block zero-padded: a truncated UTF-8 sequence shows up as TOO_SHORT
+            // against the padding, a trailing CR has no LF after it
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, ptr, static_cast<size_t>(end - ptr));
+            chunk = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+            next_is_lf = false;
+            ptr = end;
+            done = true;
         }
-        
-        if (peek() == '[') {
-            advance(); // '['
-            skip_whitespace();
-            
-            bool is_array_of_tables = false;
-            if (peek() == '[') {
-                is_array_of_tables = true;
-                advance();
-                skip_whitespace();
-            }
-            
-            std::vector<std::string> path = parse_dotted_key();
-            if (path.empty()) {
-                set_error("Empty table header");
-                return;
-            }
-            
-            skip_whitespace();
-            if (is_array_of_tables) {
-                expect_char(']');
-                expect_char(']');
-            } else {
-                expect_char(']');
-            }
-            skip_whitespace();
-            skip_comment();
-            
-            if (is_array_of_tables) {
-                current_table_ = get_or_create_array_append_table(path);
-                if (!current_table_) return;
-            } else {
-                current_table_ = get_or_create_table_at_path(path);
-                if (!current_table_) return;
-            }
-            continue;
+        unsigned int cr_mask, lf_mask;
+        unsigned int bad = control_mask(chunk, cr_mask, lf_mask);
+        if (done) {
+            // Padding bytes are NUL; ignore them
+            size_t valid = static_cast<size_t>(end - block);
+            unsigned int keep = valid >= 32 ? 0xFFFFFFFFU : ((1U << valid) - 1U);
+            bad &= keep;
         }
-        
-        // Parse key-value pair (supports dotted keys: a.b.c = value)
-        parse_key_value_pair(current_table_);
-        skip_whitespace();
-        
-        if (!eof() && peek() != '#' && peek() != '[') {
-            skip_whitespace();
+        unsigned int lone_cr = cr_mask & ~((lf_mask >> 1) | (next_is_lf ? 0x80000000U : 0U));
+        bool ascii = _mm256_movemask_epi8(chunk) == 0;
+        if (!(ascii && prev_ascii)) {
+            utf8_error = _mm256_or_si256(utf8_error, utf8_block_errors(chunk, prev));
         }
+        if ((bad | lone_cr) != 0 || !_mm256_testz_si256(utf8_error, utf8_error)) {
+            // Rare: locate and classify the error with the scalar validator. Sequences
+            // starting in the last 3 bytes of the previous block are only checked
+            // here, so start at the character boundary at or before block - 3.
+            const char* from = block - begin >= 3 ? block - 3 : begin;
+            for (int i = 0; i < 3 && from > begin && (static_cast<unsigned char>(*from) & 0xC0) == 0x80; ++i) --from;
+            // The scalar pass covers the rest of the input, so its verdict is final
+            return validate_scalar(from, end, error_pos);
+        }
+        prev = chunk;
+        prev_ascii = ascii;
     }
+    return InputError::None;
 }
+#endif
 
-void TomlParser::parse_key_value_pair(std::shared_ptr<Table> table) {
-    std::vector<std::string> path = parse_dotted_key();
-    if (path.empty()) return;
-    skip_whitespace_no_nl();
-    expect_char('=');
-    skip_whitespace_no_nl();
-    TomlValue value = parse_value();
-    skip_whitespace_no_nl();
-    skip_comment();
-    set_value_at_path(table, path, value);
+// Skip runs of printable ASCII/tab/LF 16 bytes at a time, validate the rest per character.
+static InputError validate_ascii_runs(const char* ptr, const char* end, const char** error_pos) {
+#if defined(FASTTOML_X86)
+    const __m128i lo = _mm_set1_epi8(0x1F);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i del = _mm_set1_epi8(0x7F);
+    while (end - ptr >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i ctrl = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, lf)),
+                                        _mm_cmpeq_epi8(_mm_min_epu8(chunk, lo), chunk));
+        // High bit set (non-ASCII) or control byte: hand over to the scalar checker
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(ctrl, _mm_cmpeq_epi8(chunk, del)), chunk));
+        if (mask == 0) { ptr += 16; continue; }
+        ptr += ctz(static_cast<unsigned int>(mask));
+        InputError err = InputError::None;
+        const char* next = validate_char(ptr, end, err);
+        if (!next) {
+            if (error_pos) *error_pos = ptr;
+            return err;
+        }
+        ptr = next;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t lo = vdupq_n_u8(0x1F);
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    const uint8x16_t del = vdupq_n_u8(0x7F);
+    const uint8x16_t high = vdupq_n_u8(0x80);
+    while (end - ptr >= 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+        uint8x16_t ctrl = vbicq_u8(vcleq_u8(chunk, lo), vorrq_u8(vceqq_u8(chunk, tab), vceqq_u8(chunk, lf)));
+        uint8x16_t hit = vorrq_u8(vorrq_u8(ctrl, vceqq_u8(chunk, del)), vcgeq_u8(chunk, high));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask == 0) { ptr += 16; continue; }
+        ptr += ctz(static_cast<unsigned long long>(mask)) >> 2;
+        InputError err = InputError::None;
+        const char* next = validate_char(ptr, end, err);
+        if (!next) {
+            if (error_pos) *error_pos = ptr;
+            return err;
+        }
+        ptr = next;
+    }
+#endif
+    return validate_scalar(ptr, end, error_pos);
 }
 
-std::vector<std::string> TomlParser::parse_dotted_key() {
-    std::vector<std::string> path;
-    path.push_back(parse_key());
-    skip_whitespace_no_nl();
-    while (!eof() && peek() == '.') {
-        advance(); // '.'
+InputError validate_input(const char* ptr, const char* end, const char** error_pos) {
+#if defined(FASTTOML_X86)
+    if (use_avx2) return validate_input_avx2(ptr, end, error_pos);
+#endif
+    return validate_ascii_runs(ptr, end, error_pos);
+}
+
+} // namespace simd_utils
+
+// TomlParser implementation
+TomlParser::TomlParser() : begin_(nullptr), statement_(nullptr), current_(nullptr), end_(nullptr) {}
+
+TomlParser::TomlParser(const ParseOptions& options) : TomlParser() {
+    options_ = options;
+}
+
+TomlParser::~TomlParser() = default;
+
+void TomlParser::reset() {
+    clear_error();
+    header_paths_.clear();
+    inline_depth_ = 0;
+    recycle_arena();
+}
+
+void TomlParser::recycle_arena() {
+    if (!arena_) return;
+    if (arena_.use_count() == 1) {
+        // The last document may have been released on another thread
+        std::atomic_thread_fence(std::memory_order_acquire);
+        arena_->reset();
+    } else {
+        // Still in use by a document, which keeps it
+        arena_.reset();
+    }
+}
+
+std::shared_ptr<Arena> TomlParser::acquire_arena(size_t block_size) {
+    recycle_arena();
+    if (!arena_) arena_ = std::make_shared<Arena>(block_size);
+    return arena_;
+}
+
+bool TomlParser::begin_parse(std::string_view input) {
+    header_paths_.clear();
+    inline_depth_ = 0;
+    set_input(input);
+    // TOML 1.0: input must be valid UTF-8; control chars U+0000-U+001F (except tab,
+    // LF, CR in CRLF) and U+007F are not permitted anywhere. One vectorized pass.
+    const char* error_pos = nullptr;
+    switch (simd_utils::validate_input(current_, end_, &error_pos)) {
+        case simd_utils::InputError::None:
+            break;
+        case simd_utils::InputError::ControlChar:
+            set_error_at(error_pos, ParseErrorCode::ControlCharacter,
+                         "Control characters (U+0000-U+001F except tab/LF/CR in CRLF) and U+007F are not permitted");
+            return false;
+        case simd_utils::InputError::InvalidUtf8:
+            set_error_at(error_pos, ParseErrorCode::InvalidUtf8, "Invalid UTF-8 in input");
+            return false;
+    }
+    return true;
+}
+
+void TomlParser::set_input(std::string_view text) {
+    clear_error();
+    begin_ = text.data();
+    statement_ = begin_;
+    current_ = begin_;
+    end_ = begin_ + text.size();
+}
+
+std::shared_ptr<Table> TomlParser::parse(std::string_view input) {
+    unsigned threads = options_.threads ? options_.threads : std::thread::hardware_concurrency();
+    if (threads > 1 && input.size() >= options_.parallel_min_size) {
+        if (TablePtr doc = parse_parallel(input, threads)) return doc;
+    }
+    // Roughly one byte of tree per byte of input; the arena grows if needed
+    TreeBuilder builder(options_.use_arena ? acquire_arena(input.size()) : nullptr);
+    if (!parse_with(input, builder)) {
+        return nullptr;
+    }
+    return builder.document();
+}
+
+namespace {
+
+// TreeBuilder with the stats() hook, for parse(input, stats)
+class ProfilingTreeBuilder : public TreeBuilder {
+public:
+    ProfilingTreeBuilder(std::shared_ptr<Arena> arena, ParseStats& stats)
+        : TreeBuilder(std::move(arena)), stats_(stats) {}
+
+    ParseStats& stats() { return stats_; }
+
+private:
+    ParseStats& stats_;
+};
+
+} // namespace
+
+std::shared_ptr<Table> TomlParser::parse(std::string_view input, ParseStats& stats) {
+    std::shared_ptr<Arena> arena = options_.use_arena ? acquire_arena(input.size()) : nullptr;
+    ProfilingTreeBuilder builder(arena, stats);
+    const bool ok = parse_with(input, builder);
+    if (arena) {
+        stats.arena_bytes = arena->bytes_used();
+        stats.arena_blocks = arena->blocks();
+        stats.arena_reserved = arena->bytes_reserved();
+    }
+    if (!ok) return nullptr;
+    return builder.document();
+}
+
+std::vector<std::string>& TomlParser::key_path(size_t depth) {
+    if (depth >= key_paths_.size()) key_paths_.resize(depth + 1);
+    return key_paths_[depth];
+}
+
+void TomlParser::parse_dotted_key(std::vector<std::string>& path) {
+    size_t size = 0;
+    for (;;) {
+        if (size == path.size()) path.emplace_back();
+        parse_key(path[size++]);
+        if (has_error()) break;
         skip_whitespace_no_nl();
-        path.push_back(parse_key());
+        if (eof() || peek() != '.') break;
+        advance(); // '.'
         skip_whitespace_no_nl();
     }
-    return path;
-}
-
-std::shared_ptr<Table> TomlParser::get_or_create_table_at_path(const std::vector<std::string>& path) {
-    std::shared_ptr<Table> t = root_table_;
-    for (size_t i = 0; i < path.size(); ++i) {
-        const std::string& key = path[i];
-        if (t->has(key)) {
-            TomlValue& v = t->values[key];
-            if (std::holds_alternative<TablePtr>(v)) {
-                t = std::get<TablePtr>(v);
-            } else if (std::holds_alternative<ArrayPtr>(v)) {
-                // [arr.subtab] only when arr is array-of-tables (from [[arr]]). Static array (a = [...]) cannot be extended.
-                std::vector<std::string> path_so_far(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(i) + 1);
-                if (array_of_tables_paths_.find(path_so_far) == array_of_tables_paths_.end()) {
-                    set_error("Cannot extend static array with table header");
-                    return nullptr;
-                }
-                auto arr = std::get<ArrayPtr>(v);
-                if (arr->elements.empty()) {
-                    set_error("Array of tables is empty");
-                    return nullptr;
-                }
-                auto& last = arr->elements.back();
-                if (!std::holds_alternative<TablePtr>(last)) {
-                    set_error("Key '" + key + "' already defined as non-table");
-                    return nullptr;
-                }
-                t = std::get<TablePtr>(last);
-            } else {
-                set_error("Key '" + key + "' already defined as non-table");
-                return nullptr;
-            }
+    path.resize(size);
+}
+
+bool TomlParser::parse_table_header(std::vector<std::string>& path, bool& array_of_tables) {
+    advance(); // '['
+    skip_whitespace();
+    array_of_tables = false;
+    if (peek() == '[') {
+        array_of_tables = true;
+        advance();
+        skip_whitespace();
+    }
+    parse_dotted_key(path);
+    if (has_error()) return false;
+    if (path.empty()) {
+        set_error(ParseErrorCode::Syntax, "Empty table header");
+        return false;
+    }
+    skip_whitespace();
+    expect_char(']');
+    if (array_of_tables) expect_char(']');
+    if (has_error()) return false;
+    skip_whitespace();
+    skip_comment();
+    return true;
+}
+
+void TomlParser::parse_key(std::string& key) {
+    skip_whitespace_no_nl();
+    
+    if (peek() == '"') {
+        if (current_ + 2 < end_ && current_[1] == '"' && current_[2] == '"') {
+            current_ += 3;
+            key = parse_multiline_basic_string();
+            return;
+        }
+        key = parse_basic_string();
+    } else if (peek() == '\'') {
+        if (current_ + 2 < end_ && current_[1] == '\'' && current_[2] == '\'') {
+            current_ += 3;
+            key = parse_multiline_literal_string();
+            return;
+        }
+        key = parse_literal_string();
+    } else {
+        // Bare key, copied into the existing buffer
+        const char* start = current_;
+        while (!eof() && (std::isalnum(static_cast<unsigned char>(peek())) || peek() == '_' || peek() == '-')) {
+            ++current_;
+        }
+        key.assign(start, current_);
+        if (key.empty()) {
+            set_error(ParseErrorCode::Syntax, "Expected key");
+            // Consume one character to make progress and avoid infinite loop on invalid input
+            if (!eof()) advance();
+        }
+    }
+}
+
+namespace {
+
+// Result of scanning a number token; errors are codes, the message is only
+// formatted by the caller when parsing actually fails
+enum class NumberError { None, Malformed, LeadingZero, LeadingDot, DoubleDot, TrailingDot, Overflow };
+
+// Significant decimal digits kept in the 64-bit mantissa; 19 always fit
+constexpr int kMaxMantissaDigits = 19;
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Characters the number scanner treats as part of the token (for error reporting)
+inline bool is_number_char(char c) {
+    return is_digit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-' || c == '_';
+}
+
+// Scan digit(_?digit)* starting at p (which must be a digit). Significant digits
+// go into mant (up to kMaxMantissaDigits, the rest set truncated). Returns false
+// on a misplaced underscore.
+inline bool scan_digit_run(const char*& p, const char* end, uint64_t& mant, int& nsig,
+                           int& count, bool fraction, int& exp10, bool& truncated) {
+    for (;;) {
+        unsigned d = static_cast<unsigned>(*p - '0');
+        ++count;
+        if (nsig == 0 && d == 0) {
+            // Leading zero: not significant, but shifts the exponent for fractions
+            if (fraction) --exp10;
+        } else if (nsig < kMaxMantissaDigits) {
+            mant = mant * 10 + d;
+            ++nsig;
+            if (fraction) --exp10;
         } else {
-            auto new_table = std::make_shared<Table>();
-            t->set(key, new_table);
-            t = new_table;
+            truncated = true;
+            if (!fraction) ++exp10;
         }
+        ++p;
+        if (p < end && *p == '_') {
+            ++p;
+            if (p >= end || !is_digit(*p)) return false;
+            continue;
+        }
+        if (p >= end || !is_digit(*p)) return true;
     }
-    return t;
 }
 
-std::shared_ptr<Table> TomlParser::get_or_create_array_append_table(const std::vector<std::string>& path) {
-    if (path.empty()) {
-        set_error("Empty array of tables path");
-        return nullptr;
+// Exact powers of ten representable as double (Clinger's fast path)
+constexpr double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Correctly rounded conversion of [begin, end) minus underscores, for the
+// rare floats outside the fast path. Uses a stack buffer; no exceptions.
+NumberError slow_parse_float(const char* begin, const char* end, double& out) {
+    char stack_buf[128];
+    std::string heap_buf;
+    char* buf = stack_buf;
+    size_t cap = sizeof(stack_buf) - 1;
+    if (static_cast<size_t>(end - begin) > cap) {
+        heap_buf.resize(static_cast<size_t>(end - begin) + 1);
+        buf = &heap_buf[0];
     }
-    std::shared_ptr<Table> t = root_table_;
-    for (size_t i = 0; i + 1 < path.size(); ++i) {
-        const std::string& key = path[i];
-        if (t->has(key)) {
-            TomlValue& v = t->values[key];
-            if (std::holds_alternative<TablePtr>(v)) {
-                t = std::get<TablePtr>(v);
-            } else if (std::holds_alternative<ArrayPtr>(v)) {
-                std::vector<std::string> path_so_far(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(i) + 1);
-                if (array_of_tables_paths_.find(path_so_far) == array_of_tables_paths_.end()) {
-                    set_error("Key '" + key + "' already defined as non-table");
-                    return nullptr;
-                }
-                auto arr = std::get<ArrayPtr>(v);
-                if (arr->elements.empty()) {
-                    set_error("Array of tables is empty");
-                    return nullptr;
-                }
-                auto& last = arr->elements.back();
-                if (!std::holds_alternative<TablePtr>(last)) {
-                    set_error("Key '" + key + "' already defined as non-array-of-tables");
-                    return nullptr;
-                }
-                t = std::get<TablePtr>(last);
-            } else {
-                set_error("Key '" + key + "' already defined as non-table");
-                return nullptr;
+    size_t n = 0;
+    for (const char* q = begin; q < end; ++q) {
+        if (*q != '_') buf[n++] = *q;
+    }
+    buf[n] = '\0';
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char* first = buf;
+    if (*first == '+') ++first;  // from_chars does not accept a leading '+'
+    auto res = std::from_chars(first, buf + n, out);
+    if (res.ec == std::errc::result_out_of_range) return NumberError::Overflow;
+    if (res.ec != std::errc() || res.ptr != buf + n) return NumberError::Malformed;
+#else
+    char* parsed_end = nullptr;
+    errno = 0;
+    out = std::strtod(buf, &parsed_end);
+    if (errno == ERANGE) return NumberError::Overflow;
+    if (parsed_end != buf + n) return NumberError::Malformed;
+#endif
+    return NumberError::None;
+}
+
+// Decimal integer or float starting at p (a sign was already consumed by the caller
+// into `negative`). Parses straight from the input span.
+NumberError scan_decimal(const char*& p, const char* end, const char* token_start, bool negative,
+                         TomlValue& out) {
+    if (p >= end) return NumberError::Malformed;
+    if (*p == '.') return NumberError::LeadingDot;
+    if (!is_digit(*p)) return NumberError::Malformed;
+    if (*p == '0' && p + 1 < end && (is_digit(p[1]) || p[1] == '_')) return NumberError::LeadingZero;
+
+    uint64_t mant = 0;
+    int nsig = 0;
+    int int_digits = 0;
+    int exp10 = 0;
+    bool truncated = false;
+    if (!scan_digit_run(p, end, mant, nsig, int_digits, false, exp10, truncated)) return NumberError::Malformed;
+
+    bool is_float = false;
+    if (p < end && *p == '.') {
+        ++p;
+        is_float = true;
+        if (p >= end || !is_digit(*p)) {
+            return (p < end && *p == '.') ? NumberError::DoubleDot : NumberError::TrailingDot;
+        }
+        int frac_digits = 0;
+        if (!scan_digit_run(p, end, mant, nsig, frac_digits, true, exp10, truncated)) return NumberError::Malformed;
+        if (p < end && *p == '.') return NumberError::DoubleDot;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        is_float = true;
+        bool exp_negative = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            exp_negative = *p == '-';
+            ++p;
+        }
+        if (p >= end || !is_digit(*p)) return NumberError::Malformed;
+        int exp = 0;
+        for (;;) {
+            if (exp < 100000) exp = exp * 10 + (*p - '0');
+            ++p;
+            if (p < end && *p == '_') {
+                ++p;
+                if (p >= end || !is_digit(*p)) return NumberError::Malformed;
+                continue;
             }
-        } else {
-            auto new_table = std::make_shared<Table>();
-            t->set(key, new_table);
-            t = new_table;
-        }
-    }
-    const std::string& last_key = path.back();
-    if (!t->has(last_key)) {
-        array_of_tables_paths_.insert(path);
-        auto arr = std::make_shared<Array>();
-        auto new_table = std::make_shared<Table>();
-        arr->append(new_table);
-        t->set(last_key, arr);
-        return new_table;
-    }
-    TomlValue& v = t->values[last_key];
-    if (!std::holds_alternative<ArrayPtr>(v)) {
-        set_error("Key '" + last_key + "' already defined as non-array");
-        return nullptr;
+            if (p >= end || !is_digit(*p)) break;
+        }
+        exp10 += exp_negative ? -exp : exp;
     }
-    auto arr = std::get<ArrayPtr>(v);
-    // [[key]] only allowed if key was created by a previous [[key]] (array-of-tables), not by key = [] (static array)
-    if (array_of_tables_paths_.find(path) == array_of_tables_paths_.end()) {
-        set_error("Key '" + last_key + "' already defined as non-array-of-tables");
-        return nullptr;
+    // Anything else that looks like part of a number (e.g. 1.2.3, 1e5e, 1-2) is malformed
+    if (p < end && is_number_char(*p)) return NumberError::Malformed;
+
+    if (!is_float) {
+        const uint64_t limit = negative ? uint64_t(1) << 63 : uint64_t(std::numeric_limits<Integer>::max());
+        if (truncated || mant > limit) return NumberError::Overflow;
+        out = negative ? static_cast<Integer>(0 - mant) : static_cast<Integer>(mant);
+        return NumberError::None;
     }
-    for (const auto& elem : arr->elements) {
-        if (!std::holds_alternative<TablePtr>(elem)) {
-            set_error("Key '" + last_key + "' already defined as non-array-of-tables");
-            return nullptr;
+    double value;
+    if (!truncated && mant <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+        // Both operands exact, so one IEEE operation gives the correctly rounded result
+        value = static_cast<double>(mant);
+        value = exp10 < 0 ? value / kPow10[-exp10] : value * kPow10[exp10];
+        if (negative) value = -value;
+    } else {
+        NumberError err = slow_parse_float(token_start, p, value);
+        if (err != NumberError::None) return err;
+    }
+    out = Float(value);
+    return NumberError::None;
+}
+
+// Hex/octal/binary digits after the 0x/0o/0b prefix, underscores between digits
+NumberError scan_prefixed_integer(const char*& p, const char* end, int base, bool negative, TomlValue& out) {
+    auto digit_value = [base](char ch) -> int {
+        int d;
+        if (ch >= '0' && ch <= '9') d = ch - '0';
+        else if (ch >= 'a' && ch <= 'f') d = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') d = ch - 'A' + 10;
+        else return -1;
+        return d < base ? d : -1;
+    };
+    if (p >= end || digit_value(*p) < 0) return NumberError::Malformed;
+    const int shift = base == 16 ? 4 : (base == 8 ? 3 : 1);
+    uint64_t v = 0;
+    for (;;) {
+        if (v >> (63 - shift)) return NumberError::Overflow;
+        v = (v << shift) | static_cast<uint64_t>(digit_value(*p));
+        ++p;
+        if (p < end && *p == '_') {
+            ++p;
+            if (p >= end || digit_value(*p) < 0) return NumberError::Malformed;
+            continue;
         }
+        if (p >= end || digit_value(*p) < 0) break;
     }
-    auto new_table = std::make_shared<Table>();
-    arr->append(new_table);
-    return new_table;
+    if (p < end && (is_number_char(*p) || std::isalnum(static_cast<unsigned char>(*p)))) return NumberError::Malformed;
+    out = negative ? -static_cast<Integer>(v) : static_cast<Integer>(v);
+    return NumberError::None;
 }
 
-void TomlParser::set_value_at_path(std::shared_ptr<Table> table, const std::vector<std::string>& path, const TomlValue& value) {
-    if (path.empty()) return;
-    std::shared_ptr<Table> t = table;
-    for (size_t i = 0; i + 1 < path.size(); ++i) {
-        const std::string& key = path[i];
-        if (t->has(key)) {
-            TomlValue& v = t->values[key];
-            if (std::holds_alternative<TablePtr>(v)) {
-                t = std::get<TablePtr>(v);
-            } else {
-                set_error("Key '" + key + "' already defined as non-table");
-                return;
+} // namespace
+
+TomlValue TomlParser::parse_number() {
+    const char* start = current_;
+    const char* p = current_;
+    bool negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        ++p;
+        // Special floats +inf, -inf, +nan, -nan
+        if (end_ - p >= 3 && (p + 3 >= end_ || !(std::isalnum(static_cast<unsigned char>(p[3])) || p[3] == '_'))) {
+            if (p[0] == 'i' && p[1] == 'n' && p[2] == 'f') {
+                current_ = p + 3;
+                return Float(negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity());
+            }
+            if (p[0] == 'n' && p[1] == 'a' && p[2] == 'n') {
+                current_ = p + 3;
+                return Float(negative ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN());
             }
-        } else {
-            auto new_table = std::make_shared<Table>();
-            t->set(key, new_table);
-            t = new_table;
         }
     }
-    t->set(path.back(), value);
-}
 
+    TomlValue value = Integer(0);
+    NumberError err;
+    bool prefixed = false;
+    if (end_ - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X' || p[1] == 'o' || p[1] == 'O' || p[1] == 'b' || p[1] == 'B')) {
+        // Integer literals: 0x hex, 0o octal, 0b binary (with optional leading +/-)
+        char n = p[1];
+        int base = (n == 'x' || n == 'X') ? 16 : ((n == 'o' || n == 'O') ? 8 : 2);
+        p += 2;
+        prefixed = true;
+        err = scan_prefixed_integer(p, end_, base, negative, value);
+    } else {
+        err = scan_decimal(p, end_, start, negative, value);
+    }
+    if (err == NumberError::None) {
+        current_ = p;
+        return value;
+    }
+
+    // Error path only: report the whole number-like token
+    const char* token_end = start + 1;
+    while (token_end < end_ && (is_number_char(*token_end) || (prefixed && std::isalnum(static_cast<unsigned char>(*token_end))))) ++token_end;
+    current_ = token_end;
+    const std::string_view token(start, static_cast<size_t>(token_end - start));
+    const bool looks_float = !prefixed && token.find_first_of(".eE") != std::string_view::npos;
+    switch (err) {
+        case NumberError::LeadingZero:
+            set_error_at(start, ParseErrorCode::InvalidNumber, "Leading zero not allowed in decimal integer");
+            break;
+        case NumberError::LeadingDot:
+            set_error_at(start, ParseErrorCode::InvalidNumber, "Leading dot not allowed in number");
+            break;
+        case NumberError::DoubleDot:
+            set_error_at(start, ParseErrorCode::InvalidNumber, "Double dot not allowed in float");
+            break;
+        case NumberError::TrailingDot:
+            set_error_at(start, ParseErrorCode::InvalidNumber, "Trailing dot not allowed in float");
+            break;
+        case NumberError::Overflow:
+            set_error_at(start, ParseErrorCode::NumberOutOfRange,
+                         looks_float ? "Float out of range: {}" : "Integer out of range: {}", token);
+            break;
+        default:
+            set_error_at(start, ParseErrorCode::InvalidNumber, looks_float ? "Invalid float: {}" : "Invalid integer: {}",
+                         token);
+            break;
+    }
+    return value;
+}
 
-std::string TomlParser::parse_key() {
+TomlValue TomlParser::parse_scalar_profiled(ParseStats& stats) {
     skip_whitespace_no_nl();
-    
-    if (peek() == '"') {
-        if (current_ + 2 < end_ && current_[1] == '"' && current_[2] == '"') {
-            current_ += 3;
-            return parse_multiline_basic_string();
-        }
-        return parse_basic_string();
-    } else if (peek() == '\'') {
-        if (current_ + 2 < end_ && current_[1] == '\'' && current_[2] == '\'') {
-            current_ += 3;
-            return parse_multiline_literal_string();
-        }
-        return parse_literal_string();
+    const char c = peek();
+    const uint64_t start = detail::stats_clock();
+    TomlValue value = parse_scalar();
+    const uint64_t elapsed = detail::stats_clock() - start;
+    if (c == '"' || c == '\'') {
+        ++stats.strings;
+        stats.strings_ns += elapsed;
+    } else if (c == 't' || c == 'f') {
+        ++stats.booleans;
+    } else if (std::holds_alternative<Integer>(value)) {
+        ++stats.integers;
+        stats.numbers_ns += elapsed;
+    } else if (std::holds_alternative<Float>(value)) {
+        ++stats.floats;
+        stats.numbers_ns += elapsed;
     } else {
-        // Bare key
-        std::string key;
-        while (!eof() && (std::isalnum(peek()) || peek() == '_' || peek() == '-')) {
-            key += advance();
-        }
-        if (key.empty()) {
-            set_error("Expected key");
-            // Consume one character to make progress and avoid infinite loop on invalid input
-            if (!eof()) advance();
-        }
-        return key;
+        // Offset and local datetimes, local dates and times
+        ++stats.datetimes;
+        stats.datetimes_ns += elapsed;
     }
+    return value;
 }
 
-TomlValue TomlParser::parse_value() {
+TomlValue TomlParser::parse_scalar() {
     skip_whitespace_no_nl();
     
     char c = peek();
     
-    if (c == '"') {
-        if (current_ + 2 < end_ && current_[1] == '"' && current_[2] == '"') {
-            current_ += 3;
-            return parse_multiline_basic_string();
-        }
-        return parse_basic_string();
-    } else if (c == '\'') {
-        if (current_ + 2 < end_ && current_[1] == '\'' && current_[2] == '\'') {
-            current_ += 3;
-            return parse_multiline_literal_string();
-        }
-        return parse_literal_string();
-    } else if (c == '[') {
-        // Array
-        return TomlValue(parse_array());
-    } else if (c == '{') {
-        return TomlValue(parse_inline_table());
+    if (c == '"' || c == '\'') {
+        return parse_string_value();
     } else if (std::isdigit(c) || c == '+' || c == '-' || c == '.') {
         // Date/time or number: try datetime first if pattern matches
         if (std::isdigit(c) && static_cast<size_t>(end_ - current_) >= 10 &&
@@ -516,111 +1504,18 @@ TomlValue TomlParser::parse_value() {
             std::isdigit(current_[2]) && std::isdigit(current_[3]) &&
             current_[4] == '-') {
             auto dt = try_parse_datetime();
-            if (dt) return *dt;
+            if (dt) return std::move(*dt);
             if (has_error()) return Integer(0);
         }
         if (std::isdigit(c) && static_cast<size_t>(end_ - current_) >= 8 &&
             std::isdigit(current_[0]) && std::isdigit(current_[1]) &&
             current_[2] == ':') {
             auto dt = try_parse_datetime();
-            if (dt) return *dt;
+            if (dt) return std::move(*dt);
             if (has_error()) return Integer(0);
         }
         // Number (or special float +inf, -inf, +nan, -nan) or integer 0x/0o/0b
-        const char* start = current_;
-        bool has_dot = false;
-        bool has_exp = false;
-        
-        if (c == '+' || c == '-') {
-            advance();
-            if (!eof() && peek() == 'i' && end_ - current_ >= 3 && current_[0] == 'i' && current_[1] == 'n' && current_[2] == 'f' &&
-                (current_ + 3 >= end_ || !(std::isalnum(current_[3]) || current_[3] == '_'))) {
-                current_ += 3;
-                double v = (*start == '-') ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
-                return TomlValue(Float(v));
-            }
-            if (!eof() && peek() == 'n' && end_ - current_ >= 3 && current_[0] == 'n' && current_[1] == 'a' && current_[2] == 'n' &&
-                (current_ + 3 >= end_ || !(std::isalnum(current_[3]) || current_[3] == '_'))) {
-                current_ += 3;
-                double v = (*start == '-') ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN();
-                return TomlValue(Float(v));
-            }
-        }
-        
-        // Integer literals: 0x hex, 0o octal, 0b binary (with optional leading +/-)
-        if (current_ < end_ && *current_ == '0' && current_ + 2 <= end_) {
-            char n = current_[1];
-            int base = 0;
-            if (n == 'x' || n == 'X') base = 16;
-            else if (n == 'o' || n == 'O') base = 8;
-            else if (n == 'b' || n == 'B') base = 2;
-            if (base != 0) {
-                current_ += 2;
-                std::string num_clean;
-                auto is_hex = [](char ch) { return std::isdigit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F'); };
-                auto is_oct = [](char ch) { return ch >= '0' && ch <= '7'; };
-                auto is_bin = [](char ch) { return ch == '0' || ch == '1'; };
-                while (!eof() && (peek() == '_' || (base == 16 && is_hex(peek())) || (base == 8 && is_oct(peek())) || (base == 2 && is_bin(peek())))) {
-                    if (peek() != '_') num_clean += advance();
-                    else advance();
-                }
-                if (num_clean.empty()) {
-                    set_error("Invalid integer literal");
-                    return Integer(0);
-                }
-                try {
-                    Integer v = static_cast<Integer>(std::stoll(num_clean, nullptr, base));
-                    if (start < end_ && *start == '-') v = -v;
-                    return TomlValue(v);
-                } catch (...) {
-                    set_error("Invalid integer: " + std::string(start, current_));
-                    return Integer(0);
-                }
-            }
-        }
-        // Leading dot (e.g. .1) or leading zero in decimal (e.g. 09) invalid
-        if (current_ == start && peek() == '.') {
-            set_error("Leading dot not allowed in number");
-            return Float(0.0);
-        }
-        if (current_ == start && peek() == '0' && current_ + 1 < end_ && std::isdigit(current_[1])) {
-            set_error("Leading zero not allowed in decimal integer");
-            return Integer(0);
-        }
-        while (!eof() && (std::isdigit(peek()) || peek() == '.' || peek() == 'e' || peek() == 'E' || peek() == '+' || peek() == '-' || peek() == '_')) {
-            if (peek() == '.') {
-                if (has_dot) {
-                    set_error("Double dot not allowed in float");
-                    return Float(0.0);
-                }
-                has_dot = true;
-            }
-            if (peek() == 'e' || peek() == 'E') has_exp = true;
-            advance();
-        }
-        
-        std::string num_str(start, current_);
-        if (has_dot && !has_exp && !num_str.empty() && num_str.back() == '.') {
-            set_error("Trailing dot not allowed in float");
-            return Float(0.0);
-        }
-        std::string num_clean;
-        for (char ch : num_str) if (ch != '_') num_clean += ch;
-        if (has_dot || has_exp) {
-            try {
-                return Float(std::stod(num_clean));
-            } catch (...) {
-                set_error("Invalid float: " + num_str);
-                return Float(0.0);
-            }
-        } else {
-            try {
-                return Integer(std::stoll(num_clean));
-            } catch (...) {
-                set_error("Invalid integer: " + num_str);
-                return Integer(0);
-            }
-        }
+        return parse_number();
     } else if (c == 't' || c == 'f') {
         // Boolean
         return parse_boolean();
@@ -633,11 +1528,187 @@ TomlValue TomlParser::parse_value() {
         current_ += 3;
         return TomlValue(Float(std::numeric_limits<double>::quiet_NaN()));
     } else {
-        set_error("Unexpected character in value: " + std::string(1, c));
+        set_error(ParseErrorCode::Syntax, "Unexpected character in value: {}", std::string_view(&c, 1));
         return Integer(0);
     }
 }
 
+TomlValue TomlParser::make_string_value(const char* begin, const char* end) {
+    if (options_.string_views) {
+        return StringView(begin, static_cast<size_t>(end - begin));
+    }
+    return String(begin, end);
+}
+
+// Find the closing delimiter of a multiline string body starting at p.
+// Returns the position after the closing quotes and sets content_end, or nullptr
+// if the body needs the slow path (escape when stop_at_backslash, unclosed, or
+// a quote run that does not close the string).
+static const char* find_multiline_close(const char* p, const char* end, char quote,
+                                        bool stop_at_backslash, const char*& content_end) {
+    while (p < end) {
+        p = simd_utils::find_string_special(p, end, quote, stop_at_backslash);
+        if (p == end) break;
+        char ch = *p;
+        if (ch == quote) {
+            const char* run = p;
+            while (p < end && *p == quote) ++p;
+            size_t n = static_cast<size_t>(p - run);
+            if (n >= 3) {
+                if (n == 3 || p == end || *p == '\n' || *p == '\r') {
+                    content_end = run + (n - 3);
+                    return p;
+                }
+                return nullptr;
+            }
+            continue;
+        }
+        // Escapes and CRLF (normalized to LF) need the copying parsers
+        if (ch == '\\' || ch == '\r') return nullptr;
+        ++p;  // newline or other control byte: part of the content
+    }
+    return nullptr;
+}
+
+TomlValue TomlParser::parse_string_value() {
+    const char quote = *current_;
+    const bool basic = quote == '"';
+    if (current_ + 2 < end_ && current_[1] == quote && current_[2] == quote) {
+        // Multiline: the newline right after the opening delimiter is trimmed
+        const char* body = current_ + 3;
+        if (body < end_ && *body == '\n') ++body;
+        else if (end_ - body >= 2 && body[0] == '\r' && body[1] == '\n') body += 2;
+        const char* content_end = nullptr;
+        const char* after = find_multiline_close(body, end_, quote, basic, content_end);
+        if (after) {
+            current_ = after;
+            return make_string_value(body, content_end);
+        }
+        current_ += 3;
+        return basic ? parse_multiline_basic_string() : parse_multiline_literal_string();
+    }
+    const char* body = current_ + 1;
+    const char* p = simd_utils::find_string_special(body, end_, quote, basic);
+    if (p < end_ && *p == quote) {
+        current_ = p + 1;
+        return make_string_value(body, p);
+    }
+    // Escape sequence, control byte or unterminated string
+    return basic ? parse_basic_string() : parse_literal_string();
+}
+
+bool TomlParser::skip_string() {
+    const char quote = *current_;
+    const bool basic = quote == '"';
+    const char* p = current_ + 1;
+    if (end_ - current_ >= 3 && current_[1] == quote && current_[2] == quote) {
+        // Same closing rule as the multiline parsers: a run of 3+ quotes closes
+        // when it is exactly 3 long or ends the line
+        p = current_ + 3;
+        while (p < end_) {
+            p = simd_utils::find_string_special(p, end_, quote, basic);
+            if (p == end_) break;
+            if (*p == quote) {
+                const char* run = p;
+                while (p < end_ && *p == quote) ++p;
+                const size_t n = static_cast<size_t>(p - run);
+                if (n >= 3 && (n == 3 || p == end_ || *p == '\n' || *p == '\r')) {
+                    current_ = p;
+                    return true;
+                }
+                continue;
+            }
+            p += (*p == '\\' && end_ - p >= 2) ? 2 : 1;
+        }
+        set_error(ParseErrorCode::UnterminatedString,
+                  basic ? "Unclosed multiline basic string" : "Unclosed multiline literal string");
+        return false;
+    }
+    while (p < end_) {
+        p = simd_utils::find_string_special(p, end_, quote, basic);
+        if (p == end_) break;
+        if (*p == quote) {
+            current_ = p + 1;
+            return true;
+        }
+        p += (*p == '\\' && end_ - p >= 2) ? 2 : 1;
+    }
+    set_error(ParseErrorCode::UnterminatedString, "Unterminated string");
+    return false;
+}
+
+// Commas up to the closing ']', skipping single-line strings; nested arrays,
+// inline tables, comments and multi-line strings give up
+size_t TomlParser::count_array_elements() const {
+    size_t commas = 0;
+    bool trailing = false;  // an element since the last comma
+    for (const char* p = current_; p < end_; ++p) {
+        switch (*p) {
+            case ',':
+                ++commas;
+                trailing = false;
+                break;
+            case ']':
+                return commas + trailing;
+            case '[': case '{': case '#':
+                return 0;
+            case '"': case '\'': {
+                const char quote = *p;
+                if (end_ - p >= 3 && p[1] == quote && p[2] == quote) return 0;
+                for (p = simd_utils::find_string_special(p + 1, end_, quote, quote == '"'); p < end_ && *p != quote;
+                     p = simd_utils::find_string_special(p + 2, end_, quote, true)) {
+                    if (*p != '\\' || end_ - p < 2) return 0;  // a newline or other control byte
+                }
+                if (p == end_) return 0;
+                trailing = true;
+                break;
+            }
+            case ' ': case '\t': case '\r': case '\n':
+                break;
+            default:
+                trailing = true;
+        }
+    }
+    return 0;
+}
+
+std::string_view TomlParser::skip_value() {
+    const char* begin = current_;
+    // Nesting of arrays and inline tables; strings are skipped as tokens so
+    // brackets, quotes and '#' inside them do not count
+    int depth = 0;
+    while (!eof()) {
+        const char c = *current_;
+        if (c == '"' || c == '\'') {
+            if (!skip_string()) return {};
+            if (depth == 0) break;
+        } else if ((c == '[' || c == '{') && (depth > 0 || current_ == begin)) {
+            ++depth;
+            ++current_;
+        } else if (c == ']' || c == '}') {
+            // A closer at depth 0 is left for the caller to reject
+            if (depth == 0) break;
+            ++current_;
+            if (--depth == 0) break;
+        } else if (c == '#' && depth > 0) {
+            skip_comment();
+        } else if ((c == '#' || c == ',' || c == '\n' || c == '\r') && depth == 0) {
+            break;
+        } else {
+            // Run of plain value bytes (digits, words, blanks, separators)
+            current_ = simd_utils::find_value_delim(current_ + 1, end_);
+        }
+    }
+    if (depth > 0) {
+        set_error(ParseErrorCode::Syntax, "Unterminated array or inline table");
+        return {};
+    }
+    const char* end = current_;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    if (end == begin) set_error(ParseErrorCode::Syntax, "Expected value");
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+}
+
 String TomlParser::parse_string() {
     if (peek() == '"') {
         return parse_basic_string();
@@ -650,10 +1721,16 @@ String TomlParser::parse_basic_string() {
     expect_char('"');
     std::string result;
     
-    while (!eof() && peek() != '"') {
+    while (!eof()) {
+        // Append the clean run up to the next quote/backslash/control byte at once
+        const char* run = current_;
+        current_ = simd_utils::find_string_special(current_, end_, '"', true);
+        result.append(run, current_);
+        if (eof() || peek() == '"') break;
         if (peek() == '\\') {
             advance(); // skip '\'
             result += parse_escape_sequence();
+            if (has_error()) return result;
         } else {
             result += advance();
         }
@@ -667,7 +1744,11 @@ String TomlParser::parse_literal_string() {
     expect_char('\'');
     std::string result;
     
-    while (!eof() && peek() != '\'') {
+    while (!eof()) {
+        const char* run = current_;
+        current_ = simd_utils::find_string_special(current_, end_, '\'', false);
+        result.append(run, current_);
+        if (eof() || peek() == '\'') break;
         result += advance();
     }
     
@@ -678,87 +1759,68 @@ String TomlParser::parse_literal_string() {
 String TomlParser::parse_multiline_basic_string() {
     // Opening """ already consumed. Trim first newline if present.
     if (!eof() && peek() == '\n') advance();
+    else if (end_ - current_ >= 2 && current_[0] == '\r' && current_[1] == '\n') current_ += 2;
     std::string result;
     while (!eof()) {
+        const char* run = current_;
+        current_ = simd_utils::find_string_special(current_, end_, '"', true);
+        result.append(run, current_);
+        if (eof()) break;
         if (peek() == '"') {
             int n = 0;
             while (!eof() && peek() == '"') { advance(); n++; }
             if (n >= 3) {
-                for (int i = 0; i < n - 3; i++) result += '"';
+                result.append(static_cast<size_t>(n - 3), '"');
                 // Close only if exactly 3 quotes, or next char is newline/eof (end of value)
                 if (n == 3 || eof() || peek() == '\n' || peek() == '\r') return result;
             } else {
-                for (int i = 0; i < n; i++) result += '"';
+                result.append(static_cast<size_t>(n), '"');
             }
         } else if (peek() == '\\') {
             advance();
             result += parse_escape_sequence();
+            if (has_error()) return result;
+        } else if (peek() == '\r') {
+            // CRLF (input validation guarantees the LF) is normalized to LF
+            advance();
         } else {
             result += advance();
         }
     }
-    set_error("Unclosed multiline basic string");
+    set_error(ParseErrorCode::UnterminatedString, "Unclosed multiline basic string");
     return result;
 }
 
 String TomlParser::parse_multiline_literal_string() {
     // Opening ''' already consumed. Trim first newline if present.
     if (!eof() && peek() == '\n') advance();
+    else if (end_ - current_ >= 2 && current_[0] == '\r' && current_[1] == '\n') current_ += 2;
     std::string result;
     while (!eof()) {
+        const char* run = current_;
+        current_ = simd_utils::find_string_special(current_, end_, '\'', false);
+        result.append(run, current_);
+        if (eof()) break;
         if (peek() == '\'') {
             int n = 0;
             while (!eof() && peek() == '\'') { advance(); n++; }
             if (n >= 3) {
-                for (int i = 0; i < n - 3; i++) result += '\'';
+                result.append(static_cast<size_t>(n - 3), '\'');
                 if (n == 3 || eof() || peek() == '\n' || peek() == '\r') return result;
             } else {
-                for (int i = 0; i < n; i++) result += '\'';
+                result.append(static_cast<size_t>(n), '\'');
             }
+        } else if (peek() == '\r') {
+            // CRLF (input validation guarantees the LF) is normalized to LF
+            advance();
         } else {
             result += advance();
         }
     }
-    set_error("Unclosed multiline literal string");
+    set_error(ParseErrorCode::UnterminatedString, "Unclosed multiline literal string");
     return result;
 }
 
-Integer TomlParser::parse_integer() {
-    std::string num_str;
-    if (peek() == '+' || peek() == '-') {
-        num_str += advance();
-    }
-    
-    while (!eof() && std::isdigit(peek())) {
-        num_str += advance();
-    }
-    
-    try {
-        return Integer(std::stoll(num_str));
-    } catch (...) {
-        set_error("Invalid integer: " + num_str);
-        return Integer(0);
-    }
-}
-
-Float TomlParser::parse_float() {
-    std::string num_str;
-    if (peek() == '+' || peek() == '-') {
-        num_str += advance();
-    }
-    
-    while (!eof() && (std::isdigit(peek()) || peek() == '.' || peek() == 'e' || peek() == 'E')) {
-        num_str += advance();
-    }
-    
-    try {
-        return Float(std::stod(num_str));
-    } catch (...) {
-        set_error("Invalid float: " + num_str);
-        return Float(0.0);
-    }
-}
-
 Boolean TomlParser::parse_boolean() {
     if (peek() == 't') {
         expect_char('t');
@@ -776,52 +1838,83 @@ Boolean TomlParser::parse_boolean() {
     }
 }
 
-TablePtr TomlParser::parse_inline_table() {
-    expect_char('{');
-    skip_whitespace_no_nl();
-    auto table = std::make_shared<Table>();
-    if (peek() == '}') {
-        advance();
-        return table;
-    }
-    while (!eof()) {
-        std::vector<std::string> path = parse_dotted_key();
-        if (path.empty()) break;
-        skip_whitespace_no_nl();
-        expect_char('=');
-        skip_whitespace_no_nl();
-        TomlValue value = parse_value();
-        set_value_at_path(table, path, value);
-        skip_whitespace_no_nl();
-        if (peek() == '}') break;
-        expect_char(',');
-        skip_whitespace_no_nl();
-    }
-    expect_char('}');
-    return table;
+// Date and time fields are checked eight bytes at a time: a word of the
+// input is matched against a layout of digit and separator bytes
+// ("YYYY-MM-" or "HH:MM:SS") in a few integer operations.
+namespace {
+
+constexpr uint64_t kOnes = 0x0101010101010101ull;
+
+uint64_t load_word(const char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;  // p[0] in the low byte
 }
 
-static bool parse_int(const char*& ptr, const char* end, int min_digits, int max_digits, int64_t& out) {
-    if (ptr >= end || !std::isdigit(*ptr)) return false;
-    int64_t v = 0;
-    int n = 0;
-    while (ptr < end && n < max_digits && std::isdigit(*ptr)) {
-        v = v * 10 + (*ptr - '0');
-        ++ptr;
-        ++n;
+// Bytes 0x80 of the word where it is not an ASCII digit
+uint64_t non_digits(uint64_t word) {
+    return ((word - kOnes * '0') | (word + kOnes * (0x80 - 0x3A)) | word) & (kOnes * 0x80);
+}
+
+// Whether word is digits where digit_mask has 0xFF bytes and equals
+// separators elsewhere. Separator bytes are replaced by '0' first, so they
+// cannot borrow from their neighbours in the digit test.
+bool matches_layout(uint64_t word, uint64_t digit_mask, uint64_t separators) {
+    const uint64_t digits = (word & digit_mask) | (kOnes * '0' & ~digit_mask);
+    return (word & ~digit_mask) == separators && non_digits(digits) == 0;
+}
+
+// Value of the two digits at byte i of a word that matched its layout
+int digits_at(uint64_t word, int i) {
+    const uint64_t v = word >> (8 * i);
+    return static_cast<int>((v & 0xF) * 10 + ((v >> 8) & 0xF));
+}
+
+constexpr uint64_t kDateDigits = 0x00FFFF00FFFFFFFFull;  // YYYY-MM-
+constexpr uint64_t kDateSeparators = 0x2D00002D00000000ull;
+constexpr uint64_t kTimeDigits = 0xFFFF00FFFF00FFFFull;  // HH:MM:SS
+constexpr uint64_t kTimeSeparators = 0x00003A00003A0000ull;
+
+// Layout of YYYY-MM-DD at p (10 bytes available)
+bool is_date(const char* p) {
+    return matches_layout(load_word(p), kDateDigits, kDateSeparators) && is_digit(p[8]) && is_digit(p[9]);
+}
+
+// Layout of HH:MM:SS at p (8 bytes available)
+bool is_time(const char* p) { return matches_layout(load_word(p), kTimeDigits, kTimeSeparators); }
+
+// Digits of a fraction at p: nanoseconds from the first nine, and how many
+// of those there were; returns the end of all the digits
+const char* parse_fraction(const char* p, const char* end, int& nanosecond, int& precision) {
+    const char* digits = p;
+    while (end - p >= 8) {
+        const uint64_t stop = non_digits(load_word(p));
+        if (stop) {
+            p += ctz(static_cast<unsigned long long>(stop)) / 8;
+            break;
+        }
+        p += 8;
     }
-    if (n < min_digits) return false;
-    out = v;
-    return true;
+    while (p < end && is_digit(*p)) ++p;
+    precision = static_cast<int>(std::min<ptrdiff_t>(p - digits, 9));
+    int value = 0;
+    for (int i = 0; i < 9; ++i) value = value * 10 + (i < precision ? digits[i] - '0' : 0);
+    nanosecond = value;
+    return p;
 }
 
+} // namespace
+
 // True if character can follow a date/time value (TOML value terminator).
 static bool is_value_terminator(char c) {
     return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ']' || c == '}' || c == '#';
 }
 
 // Max day in month (1-12); leap year for February.
-static int max_day_in_month(int64_t year, int64_t month) {
+static int max_day_in_month(int year, int month) {
     static const int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
     int maxd = days_in_month[month - 1];
     if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)))
@@ -829,213 +1922,169 @@ static int max_day_in_month(int64_t year, int64_t month) {
     return maxd;
 }
 
-// Portable: days from 1970-01-01 to (y, m, d). y full year, m 1-12, d 1-31.
-static int days_from_1970(int y, int m, int d) {
-    static const int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    int days = 0;
-    for (int yy = 1970; yy < y; ++yy)
-        days += (yy % 4 == 0 && (yy % 100 != 0 || yy % 400 == 0)) ? 366 : 365;
-    for (int mm = 0; mm < m - 1; ++mm)
-        days += days_in_month[mm];
-    if (m > 2 && (y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)))
-        days += 1;
-    days += d - 1;
-    return days;
+// Days from 1970-01-01 to a civil date, negative before (H. Hinnant's algorithm)
+static int64_t days_from_civil(int year, int month, int day) {
+    const int64_t y = year - (month <= 2);
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
 }
 
-static std::time_t tm_to_time_t_utc(const std::tm& tm) {
-    int days = days_from_1970(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
-    return static_cast<std::time_t>(days) * 86400 +
-           tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+// Time fields at p (8 bytes available) and their fraction; sets the error
+// (prefix "Invalid time" or "Invalid datetime") and returns nullptr for an
+// invalid field, or returns nullptr without an error where the text is not
+// a time (a missing ':')
+const char* TomlParser::parse_time_fields(const char* p, bool time_only, LocalTime& time) {
+    const char* what = time_only ? "Invalid time" : "Invalid datetime";
+    const uint64_t word = load_word(p);
+    if (matches_layout(word, kTimeDigits, kTimeSeparators)) {
+        time.hour = digits_at(word, 0);
+        time.minute = digits_at(word, 3);
+        time.second = digits_at(word, 6);
+    } else {
+        // Not the layout: find the first bad field, as parsing them in turn would
+        time.hour = is_digit(p[0]) && is_digit(p[1]) ? digits_at(word, 0) : -1;
+        time.minute = is_digit(p[3]) && is_digit(p[4]) ? digits_at(word, 3) : -1;
+        time.second = is_digit(p[6]) && is_digit(p[7]) ? digits_at(word, 6) : -1;
+    }
+    if (time.hour < 0 || time.hour > 23) {
+        set_error(ParseErrorCode::InvalidDateTime, "{}: hour must be 00-23", what);
+        return nullptr;
+    }
+    if (p[2] != ':') return nullptr;
+    if (time.minute < 0 || time.minute > 59) {
+        set_error(ParseErrorCode::InvalidDateTime, "{}: minute must be 00-59", what);
+        return nullptr;
+    }
+    if (p[5] != ':') return nullptr;
+    if (time.second < 0 || time.second > 60) {
+        set_error(ParseErrorCode::InvalidDateTime, "{}: second must be 00-60", what);
+        return nullptr;
+    }
+    p += 8;
+    time.nanosecond = 0;
+    time.precision = 0;
+    if (p < end_ && *p == '.') {
+        const char* digits = p + 1;
+        p = parse_fraction(digits, end_, time.nanosecond, time.precision);
+        if (p == digits) {
+            set_error(ParseErrorCode::InvalidDateTime, "{}: fractional seconds must have at least one digit",
+                      what);
+            return nullptr;
+        }
+    }
+    return p;
 }
 
 std::optional<TomlValue> TomlParser::try_parse_datetime() {
     const char* start = current_;
     // Date: YYYY-MM-DD or datetime: YYYY-MM-DDTHH:MM:SS or with offset
-    if (end_ - current_ >= 10 &&
-        std::isdigit(current_[0]) && std::isdigit(current_[1]) &&
-        std::isdigit(current_[2]) && std::isdigit(current_[3]) &&
-        current_[4] == '-' && std::isdigit(current_[5]) && std::isdigit(current_[6]) &&
-        current_[7] == '-' && std::isdigit(current_[8]) && std::isdigit(current_[9])) {
-        const char* p = current_;
-        int64_t year, month, day;
-        if (!parse_int(p, end_, 4, 4, year)) { current_ = start; return std::nullopt; }
-        if (p >= end_ || *p != '-') { current_ = start; return std::nullopt; }
-        ++p;
-        if (!parse_int(p, end_, 2, 2, month) || month < 1 || month > 12) {
-            set_error("Invalid date: month must be 01-12");
-            current_ = start;
+    if (end_ - current_ >= 10 && is_date(current_)) {
+        const uint64_t word = load_word(current_);
+        LocalDate date;
+        date.year = digits_at(word, 0) * 100 + digits_at(word, 2);
+        date.month = digits_at(word, 5);
+        date.day = (current_[8] - '0') * 10 + (current_[9] - '0');
+        if (date.month < 1 || date.month > 12) {
+            set_error(ParseErrorCode::InvalidDateTime, "Invalid date: month must be 01-12");
             return std::nullopt;
         }
-        if (p >= end_ || *p != '-') { current_ = start; return std::nullopt; }
-        ++p;
-        if (!parse_int(p, end_, 2, 2, day) || day < 1 || day > 31) {
-            set_error("Invalid date: day must be 01-31");
-            current_ = start;
+        if (date.day < 1 || date.day > 31) {
+            set_error(ParseErrorCode::InvalidDateTime, "Invalid date: day must be 01-31");
             return std::nullopt;
         }
-        if (day > max_day_in_month(year, month)) {
-            set_error("Invalid date: day out of range for month");
-            current_ = start;
+        if (date.day > max_day_in_month(date.year, date.month)) {
+            set_error(ParseErrorCode::InvalidDateTime, "Invalid date: day out of range for month");
             return std::nullopt;
         }
+        const char* p = current_ + 10;
         if (p == end_) {
             current_ = p;
-            return TomlValue(String(start, p));
+            return TomlValue(date);
         }
         if (*p == ' ') {
             // Date only if not followed by HH:MM:SS
-            if (end_ - p < 9) { current_ = p; return TomlValue(String(start, p)); }
-            const char* q = p + 1;
-            if (!(end_ - q >= 8 && std::isdigit(q[0]) && std::isdigit(q[1]) && q[2] == ':' &&
-                  std::isdigit(q[3]) && std::isdigit(q[4]) && q[5] == ':' && std::isdigit(q[6]) && std::isdigit(q[7]))) {
+            if (end_ - p < 9 || !is_time(p + 1)) {
                 current_ = p;
-                return TomlValue(String(start, p));
+                return TomlValue(date);
             }
             ++p;
         } else if (*p == 'T' || *p == 't') {
             ++p;
         } else {
             // Date only: must not have trailing garbage (e.g. 1979-01-01x)
-            if (p < end_ && !is_value_terminator(*p)) {
-                set_error("Invalid date: unexpected character after date");
-                current_ = start;
+            if (!is_value_terminator(*p)) {
+                set_error(ParseErrorCode::InvalidDateTime, "Invalid date: unexpected character after date");
                 return std::nullopt;
             }
             current_ = p;
-            return TomlValue(String(start, start + 10));
+            return TomlValue(date);
         }
-        if (end_ - p >= 8) {
-            int64_t hour, minute, second = 0;
-            if (!parse_int(p, end_, 2, 2, hour) || hour > 23) {
-                set_error("Invalid datetime: hour must be 00-23");
-                current_ = start;
-                return std::nullopt;
-            }
-            if (p >= end_ || *p != ':') { current_ = start; return std::nullopt; }
-            ++p;
-            if (!parse_int(p, end_, 2, 2, minute) || minute > 59) {
-                set_error("Invalid datetime: minute must be 00-59");
-                current_ = start;
-                return std::nullopt;
-            }
-            if (p >= end_ || *p != ':') { current_ = start; return std::nullopt; }
+        if (end_ - p < 8) {
+            // 'T' with no room for HH:MM:SS after it
+            set_error(ParseErrorCode::InvalidDateTime, "Invalid datetime: expected HH:MM:SS after date");
+            return std::nullopt;
+        }
+        LocalTime time;
+        p = parse_time_fields(p, false, time);
+        if (!p) return std::nullopt;
+        int offset_minutes = 0;
+        bool has_offset = false;
+        if (p < end_ && (*p == 'Z' || *p == 'z')) {
             ++p;
-            if (!parse_int(p, end_, 2, 2, second) || second > 60) {
-                set_error("Invalid datetime: second must be 00-60");
-                current_ = start;
-                return std::nullopt;
-            }
-            double subsecond = 0.0;
-            if (p < end_ && *p == '.') {
-                ++p;
-                const char* frac_start = p;
-                while (p < end_ && std::isdigit(*p)) ++p;
-                if (p == frac_start) {
-                    set_error("Invalid datetime: fractional seconds must have at least one digit");
-                    current_ = start;
-                    return std::nullopt;
-                }
-                std::string frac(frac_start, p);
-                subsecond = std::stod("0." + frac);
-            }
-            int offset_minutes = 0;
-            bool has_offset = false;
-            if (p < end_ && (*p == 'Z' || *p == 'z')) {
-                ++p;
+            has_offset = true;
+        } else if (p + 1 < end_ && (*p == '+' || *p == '-')) {
+            const char sign = *p;
+            if (end_ - p >= 6 && is_digit(p[1]) && is_digit(p[2]) && p[3] == ':' && is_digit(p[4]) &&
+                is_digit(p[5]) && (p[1] - '0') * 10 + (p[2] - '0') <= 23 && (p[4] - '0') * 10 + (p[5] - '0') <= 59) {
+                const int hours = (p[1] - '0') * 10 + (p[2] - '0');
+                const int minutes = (p[4] - '0') * 10 + (p[5] - '0');
+                offset_minutes = (hours * 60 + minutes) * (sign == '-' ? -1 : 1);
                 has_offset = true;
-            } else if (p + 1 < end_ && (*p == '+' || *p == '-')) {
-                const char* offset_start = p;
-                char sign = *p++;
-                int64_t oh, om;
-                if (parse_int(p, end_, 2, 2, oh) && oh <= 23 && p < end_ && *p == ':' &&
-                    parse_int(++p, end_, 2, 2, om) && om <= 59) {
-                    offset_minutes = static_cast<int>((oh * 60 + om) * (sign == '-' ? -1 : 1));
-                    has_offset = true;
-                } else {
-                    set_error("Invalid datetime: offset must be Z or ±HH:MM");
-                    current_ = start;
-                    return std::nullopt;
-                }
-            }
-            using namespace std::chrono;
-            std::tm tm = {};
-            tm.tm_year = static_cast<int>(year - 1900);
-            tm.tm_mon = static_cast<int>(month - 1);
-            tm.tm_mday = static_cast<int>(day);
-            tm.tm_hour = static_cast<int>(hour);
-            tm.tm_min = static_cast<int>(minute);
-            tm.tm_sec = static_cast<int>(second);
-            tm.tm_isdst = 0;
-            std::time_t t = tm_to_time_t_utc(tm);
-            if (t < 0) { current_ = start; return std::nullopt; }
-            system_clock::time_point tp = system_clock::from_time_t(t) +
-                duration_cast<system_clock::duration>(duration<double>(subsecond));
-            if (has_offset) {
-                current_ = p;
-                // Years outside time_t range: return as string for correct tagged output
-                if (year < 1970 || year > 2037) {
-                    std::string raw(start, p);
-                    if (raw.size() >= 19 && raw[10] == ' ') raw[10] = 'T';
-                    return TomlValue(raw);
-                }
-                tp -= minutes(offset_minutes);
-                return TomlValue(DateTimeOffset{tp, offset_minutes});
+                p += 6;
+            } else {
+                set_error(ParseErrorCode::InvalidDateTime, "Invalid datetime: offset must be Z or ±HH:MM");
+                return std::nullopt;
             }
-            // Local datetime (no offset): preserve as string; reject trailing garbage
+        }
+        if (!has_offset) {
+            // Local datetime (no offset); reject trailing garbage
             if (p < end_ && !is_value_terminator(*p)) {
-                set_error("Invalid datetime: unexpected character after time");
-                current_ = start;
+                set_error(ParseErrorCode::InvalidDateTime, "Invalid datetime: unexpected character after time");
                 return std::nullopt;
             }
             current_ = p;
-            return TomlValue(String(start, p));
-        }
-        if (p < end_ && !is_value_terminator(*p)) {
-            set_error("Invalid date: unexpected character after date");
-            current_ = start;
-            return std::nullopt;
+            return TomlValue(LocalDateTime{date, time});
         }
         current_ = p;
-        return TomlValue(String(start, p));
+        // UTC seconds since 1970, then DateTime ticks if they fit (system_clock
+        // counts nanoseconds from 1970 in 64 bits on most platforms, about
+        // 1678-2262); instants outside its range are returned as text
+        constexpr int64_t ticks_per_second = DateTime::period::den / DateTime::period::num;
+        constexpr int64_t max_seconds = std::numeric_limits<DateTime::rep>::max() / ticks_per_second - 1;
+        const int64_t seconds = days_from_civil(date.year, date.month, date.day) * 86400 + time.hour * 3600 +
+                                time.minute * 60 + time.second - offset_minutes * 60;
+        if (seconds > max_seconds || seconds < -max_seconds) {
+            String raw(start, p);
+            if (raw[10] == ' ') raw[10] = 'T';
+            return TomlValue(std::move(raw));
+        }
+        const DateTime::rep ticks = seconds * ticks_per_second + time.nanosecond / (1000000000 / ticks_per_second);
+        return TomlValue(DateTimeOffset{DateTime(DateTime::duration(ticks)), offset_minutes});
     }
     // Time only: HH:MM:SS or HH:MM:SS.frac
-    if (end_ - current_ >= 8 &&
-        std::isdigit(current_[0]) && std::isdigit(current_[1]) &&
-        current_[2] == ':' && std::isdigit(current_[3]) && std::isdigit(current_[4]) &&
-        current_[5] == ':' && std::isdigit(current_[6]) && std::isdigit(current_[7])) {
-        const char* p = current_;
-        int64_t h, m, s;
-        if (!parse_int(p, end_, 2, 2, h) || h > 23) {
-            set_error("Invalid time: hour must be 00-23");
-            current_ = start;
-            return std::nullopt;
-        }
-        if (p >= end_ || *p != ':') { current_ = start; return std::nullopt; }
-        ++p;
-        if (!parse_int(p, end_, 2, 2, m) || m > 59) {
-            set_error("Invalid time: minute must be 00-59");
-            current_ = start;
-            return std::nullopt;
-        }
-        if (p >= end_ || *p != ':') { current_ = start; return std::nullopt; }
-        ++p;
-        if (!parse_int(p, end_, 2, 2, s) || s > 60) {
-            set_error("Invalid time: second must be 00-60");
-            current_ = start;
-            return std::nullopt;
-        }
-        if (p < end_ && *p == '.') {
-            ++p;
-            while (p < end_ && std::isdigit(*p)) ++p;
-        }
+    if (end_ - current_ >= 8 && is_time(current_)) {
+        LocalTime time;
+        const char* p = parse_time_fields(current_, true, time);
+        if (!p) return std::nullopt;
         if (p < end_ && !is_value_terminator(*p)) {
-            set_error("Invalid time: unexpected character after time");
-            current_ = start;
+            set_error(ParseErrorCode::InvalidDateTime, "Invalid time: unexpected character after time");
             return std::nullopt;
         }
         current_ = p;
-        return TomlValue(String(start, p));
+        return TomlValue(time);
     }
     return std::nullopt;
 }
@@ -1044,53 +2093,13 @@ DateTime TomlParser::parse_datetime() {
     auto v = try_parse_datetime();
     if (v && std::holds_alternative<DateTime>(*v))
         return std::get<DateTime>(*v);
-    set_error("Expected datetime");
+    set_error(ParseErrorCode::InvalidDateTime, "Expected datetime");
     return std::chrono::system_clock::now();
 }
 
-ArrayPtr TomlParser::parse_array() {
-    expect_char('[');
-    skip_whitespace();
-    skip_comment();
-    
-    auto array = std::make_shared<Array>();
-    
-    if (peek() == ']') {
-        advance();
-        return array;
-    }
-    
-    while (!eof()) {
-        for (;;) {
-            skip_whitespace();
-            if (peek() == ']') goto end_array_loop;
-            if (peek() == '#') { skip_comment(); continue; }
-            break;
-        }
-        
-        TomlValue value = parse_value();
-        array->append(value);
-        
-        skip_whitespace();
-        skip_comment();
-        skip_whitespace();
-        if (peek() == ',') {
-            advance();
-            skip_whitespace();
-            skip_comment();
-        } else if (peek() != ']') {
-            set_error("Expected ',' or ']' in array");
-            break;
-        }
-    }
-end_array_loop:
-    expect_char(']');
-    return array;
-}
-
 std::string TomlParser::parse_escape_sequence() {
     if (eof()) {
-        set_error("Unexpected end of string in escape sequence");
+        set_error(ParseErrorCode::UnterminatedString, "Unexpected end of string in escape sequence");
         return "";
     }
     char c = advance();
@@ -1105,8 +2114,9 @@ std::string TomlParser::parse_escape_sequence() {
         case 'u': return parse_unicode_escape(4);
         case 'U': return parse_unicode_escape(8);
         default: {
-            set_error("Invalid escape sequence in string: \\" + std::string(1, c) +
-                      " (allowed: \\b \\t \\n \\f \\r \\\" \\\\ \\uXXXX \\UXXXXXXXX)");
+            set_error_at(current_ - 2, ParseErrorCode::InvalidEscape,
+                         "Invalid escape sequence in string: \\{} (allowed: \\b \\t \\n \\f \\r \\\" \\\\ \\uXXXX \\UXXXXXXXX)",
+                         std::string_view(&c, 1));
             return "";
         }
     }
@@ -1147,18 +2157,18 @@ std::string TomlParser::parse_unicode_escape(int num_hex_digits) {
     for (; i < num_hex_digits && !eof(); ++i) {
         int d = hex_digit(peek());
         if (d < 0) {
-            set_error("Invalid hex digit in Unicode escape");
+            set_error(ParseErrorCode::InvalidEscape, "Invalid hex digit in Unicode escape");
             return "\xEF\xBF\xBD";
         }
         advance();
         cp = (cp << 4) | static_cast<uint32_t>(d);
     }
     if (i != num_hex_digits) {
-        set_error("Unicode escape truncated");
+        set_error(ParseErrorCode::InvalidEscape, "Unicode escape truncated");
         return "\xEF\xBF\xBD";
     }
     if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
-        set_error("Invalid Unicode codepoint in escape");
+        set_error(ParseErrorCode::InvalidEscape, "Invalid Unicode codepoint in escape");
         return "\xEF\xBF\xBD";
     }
     std::string out;
@@ -1184,7 +2194,8 @@ void TomlParser::skip_comment() {
 
 void TomlParser::expect_char(char c) {
     if (eof() || peek() != c) {
-        set_error("Expected '" + std::string(1, c) + "' but found '" + (eof() ? std::string("EOF") : std::string(1, peek())) + "'");
+        set_error(ParseErrorCode::Syntax, "Expected '{}' but found '{}'", std::string_view(&c, 1),
+                  eof() ? std::string_view("EOF") : std::string_view(current_, 1));
         return;
     }
     advance();
@@ -1208,10 +2219,40 @@ bool TomlParser::eof() {
     return current_ >= end_;
 }
 
-void TomlParser::set_error(const std::string& message) {
-    if (error_message_.empty()) {
-        error_message_ = message;
+void TomlParser::set_error(ParseErrorCode code, const char* format, std::string_view arg, std::string_view arg2) {
+    set_error_at(current_, code, format, arg, arg2);
+}
+
+void TomlParser::set_error_at(const char* at, ParseErrorCode code, const char* format, std::string_view arg,
+                              std::string_view arg2) {
+    if (has_error()) return;
+    result_.code = code;
+    error_format_ = format;
+    error_args_[0].assign(arg.data(), arg.size());
+    error_args_[1].assign(arg2.data(), arg2.size());
+    if (!begin_ || !at) return;
+    // Only failed parses pay for the line count
+    if (at > end_) at = end_;
+    const char* line_start = at;
+    while (line_start > begin_ && line_start[-1] != '\n') --line_start;
+    result_.offset = static_cast<size_t>(at - begin_);
+    result_.line = 1 + static_cast<size_t>(std::count(begin_, line_start, '\n'));
+    result_.column = 1 + static_cast<size_t>(at - line_start);
+}
+
+std::string TomlParser::get_error() const {
+    std::string message;
+    if (!has_error()) return message;
+    size_t arg = 0;
+    for (const char* p = error_format_; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && arg < 2) {
+            message += error_args_[arg++];
+            ++p;
+        } else {
+            message += *p;
+        }
     }
+    return message;
 }
 
 } // namespace fasttoml
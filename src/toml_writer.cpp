@@ -0,0 +1,358 @@
+#include "fasttoml/toml_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace fasttoml {
+namespace writer {
+
+bool is_bare_key(std::string_view key) {
+    if (key.empty()) return false;
+    for (char c : key) {
+        if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void append_key(std::string& out, std::string_view key) {
+    if (is_bare_key(key)) {
+        out.append(key.data(), key.size());
+    } else {
+        append_basic_string(out, key);
+    }
+}
+
+void append_basic_string(std::string& out, std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    out.reserve(out.size() + s.size() + 2);
+    out += '"';
+    const char* p = s.data();
+    const char* end = p + s.size();
+    while (p < end) {
+        const char* run = p;
+        p = simd_utils::find_escape_char(p, end);
+        out.append(run, p);
+        if (p == end) break;
+        const unsigned char c = static_cast<unsigned char>(*p++);
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(esc, sizeof(esc));
+                break;
+            }
+        }
+    }
+    out += '"';
+}
+
+// Shortest round-trip decimal digits of a finite, non-negative value and the
+// exponent of the first digit (value = d.ddd * 10^exp10)
+static void shortest_digits(double value, char* digits, int& ndigits, int& exp10) {
+    char buf[64];
+    const char* text = buf;
+    size_t len = 0;
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific);
+    len = static_cast<size_t>(res.ptr - buf);
+#else
+    // Smallest precision that round-trips is the shortest representation
+    for (int precision = 0; precision < 17; ++precision) {
+        int n = std::snprintf(buf, sizeof(buf), "%.*e", precision, value);
+        if (std::strtod(buf, nullptr) == value || precision == 16) {
+            len = static_cast<size_t>(n);
+            break;
+        }
+    }
+#endif
+    ndigits = 0;
+    size_t i = 0;
+    for (; i < len && text[i] != 'e'; ++i) {
+        if (text[i] != '.') digits[ndigits++] = text[i];
+    }
+    // to_chars does not NUL-terminate, so read the exponent within len
+    bool negative = false;
+    exp10 = 0;
+    for (++i; i < len; ++i) {
+        if (text[i] == '-') negative = true;
+        else if (text[i] >= '0' && text[i] <= '9') exp10 = exp10 * 10 + (text[i] - '0');
+    }
+    if (negative) exp10 = -exp10;
+    // Trailing zeros of the printf fallback are not significant
+    while (ndigits > 1 && digits[ndigits - 1] == '0') --ndigits;
+}
+
+void append_float(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "nan";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value < 0 ? "-inf" : "inf";
+        return;
+    }
+    if (std::signbit(value)) {
+        out += '-';
+        value = -value;
+    }
+    char digits[32];
+    int n = 0;
+    int exp10 = 0;
+    shortest_digits(value, digits, n, exp10);
+    if (exp10 < -4 || exp10 >= 16) {
+        // Exponent form as repr() writes it: 1e+16, 1.5e-07
+        out += digits[0];
+        if (n > 1) {
+            out += '.';
+            out.append(digits + 1, static_cast<size_t>(n - 1));
+        }
+        char exp[8];
+        int m = std::snprintf(exp, sizeof(exp), "e%c%02d", exp10 < 0 ? '-' : '+', exp10 < 0 ? -exp10 : exp10);
+        out.append(exp, static_cast<size_t>(m));
+    } else if (exp10 < 0) {
+        out += "0.";
+        out.append(static_cast<size_t>(-exp10 - 1), '0');
+        out.append(digits, static_cast<size_t>(n));
+    } else {
+        const int int_digits = exp10 + 1;
+        if (n <= int_digits) {
+            out.append(digits, static_cast<size_t>(n));
+            out.append(static_cast<size_t>(int_digits - n), '0');
+            out += ".0";
+        } else {
+            out.append(digits, static_cast<size_t>(int_digits));
+            out += '.';
+            out.append(digits + int_digits, static_cast<size_t>(n - int_digits));
+        }
+    }
+}
+
+void append_datetime(std::string& out, int year, int month, int day, int hour, int minute, int second,
+                     int microsecond) {
+    char buf[40];
+    int n = std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d", year, month, day, hour, minute, second);
+    out.append(buf, static_cast<size_t>(n));
+    if (microsecond) {
+        n = std::snprintf(buf, sizeof(buf), ".%06d", microsecond);
+        while (buf[n - 1] == '0') --n;
+        out.append(buf, static_cast<size_t>(n));
+    }
+}
+
+void append_offset(std::string& out, int offset_seconds) {
+    if (offset_seconds == 0) {
+        out += 'Z';
+        return;
+    }
+    const int total = offset_seconds < 0 ? -offset_seconds : offset_seconds;
+    char buf[16];
+    int n = std::snprintf(buf, sizeof(buf), "%c%02d:%02d", offset_seconds < 0 ? '-' : '+', total / 3600,
+                          (total % 3600) / 60);
+    out.append(buf, static_cast<size_t>(n));
+}
+
+size_t format_local(char* out, const LocalDate& date) {
+    return static_cast<size_t>(std::snprintf(out, kLocalSize, "%04d-%02d-%02d", date.year, date.month, date.day));
+}
+
+size_t format_local(char* out, const LocalTime& time) {
+    int n = std::snprintf(out, kLocalSize, "%02d:%02d:%02d", time.hour, time.minute, time.second);
+    if (time.precision > 0) {
+        char fraction[16];
+        std::snprintf(fraction, sizeof(fraction), "%09d", time.nanosecond);
+        n += std::snprintf(out + n, kLocalSize - static_cast<size_t>(n), ".%.*s", time.precision, fraction);
+    }
+    return static_cast<size_t>(n);
+}
+
+size_t format_local(char* out, const LocalDateTime& datetime) {
+    size_t n = format_local(out, datetime.date);
+    out[n++] = 'T';
+    return n + format_local(out + n, datetime.time);
+}
+
+} // namespace writer
+
+namespace {
+
+// UTF-8 text seen byte by byte for writer::classify_string
+struct ByteText {
+    std::string_view s;
+    size_t size() const { return s.size(); }
+    char at(size_t i) const { return s[i]; }
+    bool is_digit(size_t i) const { return s[i] >= '0' && s[i] <= '9'; }
+};
+
+const char* const kTableArrayInline = "List of tables must be emitted as [[section]]";
+
+bool is_table_array(const TomlValue& v) {
+    const auto* ap = std::get_if<ArrayPtr>(&v);
+    // Packed arrays hold numbers only
+    if (!ap || (*ap)->values().empty()) return false;
+    for (const auto& elem : (*ap)->values()) {
+        if (!std::holds_alternative<TablePtr>(elem)) return false;
+    }
+    return true;
+}
+
+void append_string_value(std::string& out, std::string_view s) {
+    switch (writer::classify_string(ByteText{s})) {
+        case writer::StringForm::Date:
+        case writer::StringForm::Time:
+            out.append(s.data(), s.size());
+            break;
+        case writer::StringForm::LocalDateTime: {
+            size_t start = out.size();
+            out.append(s.data(), s.size());
+            if (out[start + 10] == ' ') out[start + 10] = 'T';
+            break;
+        }
+        case writer::StringForm::Basic:
+            writer::append_basic_string(out, s);
+            break;
+    }
+}
+
+void append_time_point(std::string& out, DateTime utc, int offset_minutes) {
+    namespace sc = std::chrono;
+    // Local wall time at the offset, truncated to microseconds like Python datetime
+    int64_t us = sc::duration_cast<sc::microseconds>(utc.time_since_epoch()).count() +
+                 int64_t(offset_minutes) * 60 * 1000000;
+    int64_t secs = us >= 0 ? us / 1000000 : -((-us + 999999) / 1000000);
+    int micro = static_cast<int>(us - secs * 1000000);
+    int64_t days = secs >= 0 ? secs / 86400 : -((-secs + 86399) / 86400);
+    int sod = static_cast<int>(secs - days * 86400);
+    // Civil date from days since 1970-01-01 (H. Hinnant's algorithm)
+    int64_t z = days + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    int year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+    writer::append_datetime(out, year, month, day, sod / 3600, (sod / 60) % 60, sod % 60, micro);
+    writer::append_offset(out, offset_minutes * 60);
+}
+
+void append_value(std::string& out, const TomlValue& value);
+
+void append_inline_table(std::string& out, const Table& table) {
+    out += '{';
+    bool first = true;
+    for (const auto& [key, v] : table.values) {
+        if (!first) out += ',';
+        first = false;
+        writer::append_key(out, key);
+        out += " = ";
+        append_value(out, v);
+    }
+    out += '}';
+}
+
+void append_value(std::string& out, const TomlValue& value) {
+    std::visit([&](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, Boolean>) {
+            out += arg ? "true" : "false";
+        } else if constexpr (std::is_same_v<T, Integer>) {
+            char buf[24];
+            auto res = std::to_chars(buf, buf + sizeof(buf), arg);
+            out.append(buf, res.ptr);
+        } else if constexpr (std::is_same_v<T, Float>) {
+            writer::append_float(out, arg);
+        } else if constexpr (std::is_same_v<T, String> || std::is_same_v<T, StringView>) {
+            append_string_value(out, arg);
+        } else if constexpr (std::is_same_v<T, DateTime>) {
+            append_time_point(out, arg, 0);
+        } else if constexpr (std::is_same_v<T, DateTimeOffset>) {
+            append_time_point(out, arg.utc, arg.offset_minutes);
+        } else if constexpr (std::is_same_v<T, LocalDate> || std::is_same_v<T, LocalTime> ||
+                             std::is_same_v<T, LocalDateTime>) {
+            char buf[writer::kLocalSize];
+            out.append(buf, writer::format_local(buf, arg));
+        } else if constexpr (std::is_same_v<T, TablePtr>) {
+            append_inline_table(out, *arg);
+        } else if constexpr (std::is_same_v<T, ArrayPtr>) {
+            if (is_table_array(value)) throw std::invalid_argument(kTableArrayInline);
+            out += '[';
+            bool first = true;
+            arg->for_each([&](const TomlValue& elem) {
+                if (!first) out += ", ";
+                first = false;
+                append_value(out, elem);
+            });
+            out += ']';
+        }
+    }, value);
+}
+
+void append_table_body(std::string& out, const Table& table, const std::string& prefix) {
+    std::vector<const Table::Map::value_type*> entries;
+    entries.reserve(table.values.size());
+    for (const auto& kv : table.values) entries.push_back(&kv);
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    auto line = [&out]() {
+        if (!out.empty()) out += '\n';
+    };
+    auto path_of = [&prefix](const std::string& key) {
+        std::string path = prefix;
+        if (!path.empty()) path += '.';
+        writer::append_key(path, key);
+        return path;
+    };
+    for (const auto* kv : entries) {
+        if (std::holds_alternative<TablePtr>(kv->second) || is_table_array(kv->second)) continue;
+        line();
+        writer::append_key(out, kv->first);
+        out += " = ";
+        append_value(out, kv->second);
+    }
+    for (const auto* kv : entries) {
+        if (const auto* tp = std::get_if<TablePtr>(&kv->second)) {
+            std::string path = path_of(kv->first);
+            line();
+            out += '[';
+            out += path;
+            out += ']';
+            append_table_body(out, **tp, path);
+        }
+    }
+    for (const auto* kv : entries) {
+        if (!is_table_array(kv->second)) continue;
+        std::string path = path_of(kv->first);
+        for (const auto& elem : std::get<ArrayPtr>(kv->second)->values()) {
+            line();
+            out += "[[";
+            out += path;
+            out += "]]";
+            append_table_body(out, *std::get<TablePtr>(elem), path);
+        }
+    }
+}
+
+} // namespace
+
+std::string to_toml(const Table& table) {
+    std::string out;
+    append_table_body(out, table, "");
+    return out;
+}
+
+} // namespace fasttoml
@@ -0,0 +1,46 @@
+// Minimal test harness for the C++ tests: TEST(name) registers a case and
+// CHECK records a failure without stopping it. Run by ctest as fasttoml_tests.
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace fasttoml_test {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& registry();
+void fail(const char* file, int line, const std::string& what);
+
+struct Register {
+    Register(const char* name, void (*run)()) { registry().push_back({name, run}); }
+};
+
+} // namespace fasttoml_test
+
+#define TEST(name)                                                             \
+    static void name();                                                        \
+    static const ::fasttoml_test::Register name##_registered(#name, name);     \
+    static void name()
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) ::fasttoml_test::fail(__FILE__, __LINE__, #cond);         \
+    } while (0)
+
+// Checks that expr throws Exception, whose what() contains text
+#define CHECK_THROWS(expr, Exception, text)                                    \
+    do {                                                                       \
+        try {                                                                  \
+            (void)(expr);                                                      \
+            ::fasttoml_test::fail(__FILE__, __LINE__, #expr " did not throw"); \
+        } catch (const Exception& e) {                                         \
+            if (std::string(e.what()).find(text) == std::string::npos) {       \
+                ::fasttoml_test::fail(__FILE__, __LINE__,                      \
+                                      std::string("unexpected message: ") + e.what()); \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
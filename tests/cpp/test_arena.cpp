@@ -0,0 +1,133 @@
+#include "check.hpp"
+#include "bench_documents.hpp"
+#include "fasttoml/arena.hpp"
+#include "fasttoml/toml_parser.hpp"
+#include "fasttoml/toml_writer.hpp"
+#include <string>
+
+using namespace fasttoml;
+
+namespace {
+
+ParseOptions arena_options() {
+    ParseOptions options;
+    options.use_arena = true;
+    return options;
+}
+
+// Same document as a heap parse of text, key order included
+bool same_as_heap(const Table& document, const std::string& text) {
+    TablePtr heap = TomlParser().parse(text);
+    return heap && diff(document, *heap).empty() && to_toml(document) == to_toml(*heap);
+}
+
+// Every table and array below t allocates from arena
+bool all_in(const Table& t, const Arena* arena);
+
+bool all_in(const TomlValue& value, const Arena* arena) {
+    if (const auto* table = std::get_if<TablePtr>(&value)) return all_in(**table, arena);
+    const auto* array = std::get_if<ArrayPtr>(&value);
+    if (!array) return true;
+    if ((*array)->values().get_allocator().arena() != arena) return false;
+    for (const TomlValue& element : (*array)->values()) {
+        if (!all_in(element, arena)) return false;
+    }
+    return true;
+}
+
+bool all_in(const Table& t, const Arena* arena) {
+    if (t.values.get_allocator().arena() != arena) return false;
+    for (const auto& entry : t.values) {
+        if (!all_in(entry.second, arena)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(arena_matches_heap_on_benchmark_documents) {
+    for (const fasttoml_bench::Workload& workload : fasttoml_bench::kWorkloads) {
+        for (size_t size : {size_t(1024), size_t(64 * 1024), size_t(512 * 1024)}) {
+            const std::string text = fasttoml_bench::generate(workload, size);
+            TomlParser parser(arena_options());
+            TablePtr document = parser.parse(text);
+            CHECK(document != nullptr);
+            if (!document) continue;
+            const Arena* arena = document->values.get_allocator().arena();
+            CHECK(arena != nullptr && arena->bytes_used() > 0);
+            CHECK(all_in(*document, arena));
+            CHECK(same_as_heap(*document, text));
+        }
+    }
+}
+
+TEST(arena_with_threads_and_string_views) {
+    // Sections parsed on other threads come from arenas of their own
+    ParseOptions options = arena_options();
+    options.threads = 4;
+    options.string_views = true;
+    for (const fasttoml_bench::Workload& workload : fasttoml_bench::kWorkloads) {
+        const std::string text = fasttoml_bench::generate(workload, 2 * 1024 * 1024);
+        TablePtr document = TomlParser(options).parse(text);
+        CHECK(document != nullptr);
+        if (document) CHECK(same_as_heap(*document, text));
+    }
+}
+
+TEST(arena_reused_by_parser) {
+    TomlParser parser(arena_options());
+    const std::string first = fasttoml_bench::generate(fasttoml_bench::kWorkloads[0], 64 * 1024);
+    const std::string second = fasttoml_bench::generate(fasttoml_bench::kWorkloads[3], 64 * 1024);
+    TablePtr document = parser.parse(first);
+    CHECK(document && same_as_heap(*document, first));
+    // A document still referenced keeps its arena; the next one gets another
+    TablePtr next = parser.parse(second);
+    CHECK(next && next->values.get_allocator().arena() != document->values.get_allocator().arena());
+    CHECK(same_as_heap(*document, first) && same_as_heap(*next, second));
+    document.reset();
+    next.reset();
+    for (int i = 0; i < 3; ++i) {
+        document = parser.parse(i % 2 ? first : second);
+        CHECK(document && same_as_heap(*document, i % 2 ? first : second));
+    }
+}
+
+TEST(arena_growth_of_tables_and_arrays) {
+    // A table of scalars grows its entry buffer in place (Arena::extend), and
+    // arrays of scalars are sized once, so little arena memory is left unused
+    std::string text;
+    for (int i = 0; i < 5000; ++i) text += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+    text += "ints = [";
+    for (int i = 0; i < 100000; ++i) text += std::to_string(i) + ",";
+    text += "]\nstrings = [";
+    for (int i = 0; i < 20000; ++i) text += "\"element number " + std::to_string(i) + "\",";
+    text += "]\n";
+    TablePtr document = TomlParser(arena_options()).parse(text);
+    CHECK(document != nullptr);
+    if (!document) return;
+    CHECK(same_as_heap(*document, text));
+    const Arena* arena = document->values.get_allocator().arena();
+    const size_t needed = 5002 * sizeof(Table::Map::value_type) + 100000 * sizeof(Integer) +
+                          20000 * sizeof(TomlValue);
+    CHECK(4 * arena->bytes_used() < 7 * needed);
+}
+
+TEST(arena_extend_and_deallocate) {
+    Arena arena(4096);
+    void* first = arena.allocate(64, 8);
+    void* last = arena.allocate(64, 8);
+    const size_t used = arena.bytes_used();
+    // Only the latest allocation grows in place, and only within its block
+    CHECK(!arena.extend(first, 64, 128));
+    CHECK(arena.extend(last, 64, 256));
+    CHECK(arena.bytes_used() == used + 192);
+    CHECK(!arena.extend(last, 256, 1 << 20));
+    // Giving back the latest allocation makes its space the next one
+    arena.deallocate(last, 256);
+    CHECK(arena.allocate(32, 8) == last);
+    arena.deallocate(first, 64);  // not the latest: a no-op
+    CHECK(arena.bytes_used() == used - 64 + 32);
+    arena.reset();
+    CHECK(arena.bytes_used() == 0);
+    CHECK(arena.allocate(16, 16) != nullptr);
+}
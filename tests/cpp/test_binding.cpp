@@ -0,0 +1,218 @@
+#include "check.hpp"
+#include "fasttoml/binding.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace fasttoml;
+
+namespace {
+
+struct Route {
+    std::string path;
+    int weight = 1;
+    std::optional<double> timeout;
+};
+
+struct Health {
+    std::string path;
+    int64_t interval = 30;
+};
+
+struct Server {
+    std::string host;
+    uint16_t port = 8080;
+    std::vector<std::string> tags;
+    Health health;
+    std::vector<Route> routes;
+    std::optional<bool> debug;
+    std::vector<std::vector<int>> matrix;
+    float ratio = 0;
+    std::string since;
+    LocalDate released{};
+    DateTimeOffset started{};
+};
+
+// Refers to itself through the vector
+struct Node {
+    std::string name;
+    std::vector<Node> children;
+};
+
+} // namespace
+
+template<>
+struct fasttoml::Binding<Route> {
+    static void describe(Fields<Route>& f) {
+        f.required("path", &Route::path);
+        f.optional("weight", &Route::weight);
+        f.optional("timeout", &Route::timeout);
+    }
+};
+
+template<>
+struct fasttoml::Binding<Health> {
+    static void describe(Fields<Health>& f) {
+        f.required("path", &Health::path);
+        f.optional("interval", &Health::interval);
+    }
+};
+
+template<>
+struct fasttoml::Binding<Server> {
+    static void describe(Fields<Server>& f) {
+        f.required("host", &Server::host);
+        f.optional("port", &Server::port);
+        f.optional("tags", &Server::tags);
+        f.required("health", &Server::health);
+        f.optional("routes", &Server::routes);
+        f.required("debug", &Server::debug);  // std::optional, so never required
+        f.optional("matrix", &Server::matrix);
+        f.optional("ratio", &Server::ratio);
+        f.optional("since", &Server::since);
+        f.optional("released", &Server::released);
+        f.optional("started", &Server::started);
+    }
+};
+
+template<>
+struct fasttoml::Binding<Node> {
+    static void describe(Fields<Node>& f) {
+        f.required("name", &Node::name);
+        f.optional("children", &Node::children);
+    }
+};
+
+namespace {
+
+const char* const kMinimal = "host = \"example.org\"\n[health]\npath = \"/health\"\n";
+
+// Message of a failed parse_into, empty if it succeeded
+template<typename T>
+std::string bind_error(const std::string& text, T& out, const BindOptions& options = BindOptions()) {
+    TomlParser parser;
+    if (parser.parse_into(text, out, options)) return std::string();
+    return parser.get_error();
+}
+
+} // namespace
+
+TEST(binding_required_and_optional) {
+    Server server;
+    CHECK(bind_error(kMinimal, server).empty());
+    CHECK(server.host == "example.org");
+    CHECK(server.port == 8080);
+    CHECK(server.health.path == "/health");
+    CHECK(server.health.interval == 30);
+    CHECK(server.tags.empty() && server.routes.empty());
+    CHECK(!server.debug);
+
+    Server set;
+    CHECK(bind_error("host = \"h\"\nport = 443\ndebug = false\ntags = [\"a\", \"b\"]\n"
+                     "ratio = 2\nsince = 2024-05-01\nreleased = 2023-12-31\n"
+                     "started = 2024-01-02T03:04:05+02:00\nhealth = { path = \"/h\", interval = 5 }\n",
+                     set)
+              .empty());
+    CHECK(set.port == 443);
+    CHECK(set.debug && *set.debug == false);
+    CHECK((set.tags == std::vector<std::string>{"a", "b"}));
+    CHECK(set.ratio == 2.0f);  // integers convert to floats
+    CHECK(set.since == "2024-05-01");  // local dates convert to their text
+    CHECK(set.released.year == 2023 && set.released.month == 12 && set.released.day == 31);
+    CHECK(set.started.offset_minutes == 120);
+    CHECK(set.health.path == "/h" && set.health.interval == 5);
+}
+
+TEST(binding_missing_required_keys) {
+    Server server;
+    CHECK(bind_error("[health]\npath = \"/h\"\n", server) == "Missing required key 'host'");
+    CHECK(bind_error("host = \"h\"\n", server) == "Missing required key 'health'");
+    CHECK(bind_error("host = \"h\"\n[health]\ninterval = 1\n", server) == "Missing required key 'health.path'");
+    CHECK(bind_error(std::string(kMinimal) + "[[routes]]\npath = \"/a\"\n[[routes]]\nweight = 2\n", server) ==
+          "Missing required key 'routes[1].path'");
+}
+
+TEST(binding_type_mismatches) {
+    Server server;
+    CHECK(bind_error("host = 1\n", server) == "Key 'host': expected string, found integer");
+    CHECK(bind_error("port = 70000\n", server) == "Key 'port': integer 70000 out of range");
+    CHECK(bind_error("port = -1\n", server) == "Key 'port': integer -1 out of range");
+    CHECK(bind_error("port = 1.5\n", server) == "Key 'port': expected integer, found float");
+    CHECK(bind_error("debug = \"yes\"\n", server) == "Key 'debug': expected boolean, found string");
+    CHECK(bind_error("tags = \"a\"\n", server) == "Key 'tags': expected array, found string");
+    CHECK(bind_error("tags = [\"a\", 2]\n", server) == "Element 1 of 'tags': expected string, found integer");
+    CHECK(bind_error("health = 1\n", server) == "Key 'health': expected table, found integer");
+    CHECK(bind_error("[host]\n", server) == "Key 'host': expected string, found table");
+    CHECK(bind_error("[[health]]\n", server) == "Key 'health': expected table, found array of tables");
+    CHECK(bind_error("released = 12:00:00\n", server) == "Key 'released': expected local date, found local time");
+    CHECK(bind_error("matrix = [[1], [2, \"x\"]]\n", server) ==
+          "Element 1 of a nested array: expected integer, found string");
+    CHECK(bind_error("[health]\ninterval = true\n", server) ==
+          "Key 'health.interval': expected integer, found boolean");
+    CHECK(bind_error("[[routes]]\npath = \"/a\"\n[[routes]]\npath = \"/b\"\ntimeout = \"1s\"\n", server) ==
+          "Key 'routes[1].timeout': expected float, found string");
+}
+
+TEST(binding_unknown_and_duplicate_keys) {
+    Server server;
+    CHECK(bind_error(std::string(kMinimal) + "bogus = 1\n", server) == "Unknown key 'health.bogus'");
+    CHECK(bind_error("bogus = 1\n", server) == "Unknown key 'bogus'");
+    CHECK(bind_error(std::string(kMinimal) + "[x.y]\n", server) == "Unknown key 'x'");
+    CHECK(bind_error("routes = [{ path = \"/a\", bogus = 1 }]\n", server) == "Unknown key 'routes[0].bogus'");
+    CHECK(bind_error("host = \"a\"\nhost = \"b\"\n", server) == "Duplicate key 'host'");
+    CHECK(bind_error("host = \"a\"\nhost.x = 1\n", server) == "Key 'host' already defined as non-table");
+
+    BindOptions lenient;
+    lenient.allow_unknown_keys = true;
+    Server skipped;
+    CHECK(bind_error("bogus = 1\nextra = { a = [1, { b = 2 }] }\nhost = \"example.org\"\n[unknown.table]\n"
+                     "x = [1, 2]\n[[unknown_list]]\ny = 1\n[health]\npath = \"/health\"\nbogus = 'x'\n",
+                     skipped, lenient)
+              .empty());
+    CHECK(skipped.host == "example.org" && skipped.health.path == "/health");
+}
+
+TEST(binding_nested_tables_and_arrays) {
+    Server server;
+    const std::string text = std::string(kMinimal) +
+                             "[[routes]]\npath = \"/a\"\ntimeout = 1.5\n"
+                             "[[routes]]\npath = \"/b\"\nweight = 3\n";
+    CHECK(bind_error(text, server).empty());
+    CHECK(server.routes.size() == 2);
+    CHECK(server.routes[0].path == "/a" && server.routes[0].weight == 1 && server.routes[0].timeout == 1.5);
+    CHECK(server.routes[1].path == "/b" && server.routes[1].weight == 3 && !server.routes[1].timeout);
+
+    Server inline_form;
+    CHECK(bind_error("host = \"h\"\nhealth.path = \"/d\"\nroutes = [{ path = \"/x\" }, { path = \"/y\", weight = 2 }]\n"
+                     "matrix = [[1, 2], [], [3]]\n",
+                     inline_form)
+              .empty());
+    CHECK(inline_form.health.path == "/d");
+    CHECK(inline_form.routes.size() == 2 && inline_form.routes[1].weight == 2);
+    CHECK((inline_form.matrix == std::vector<std::vector<int>>{{1, 2}, {}, {3}}));
+
+    Node tree;
+    CHECK(bind_error("name = \"root\"\n[[children]]\nname = \"a\"\n[[children.children]]\nname = \"a1\"\n"
+                     "[[children]]\nname = \"b\"\nchildren = [{ name = \"b1\" }, { name = \"b2\" }]\n",
+                     tree)
+              .empty());
+    CHECK(tree.children.size() == 2);
+    CHECK(tree.children[0].children.size() == 1 && tree.children[0].children[0].name == "a1");
+    CHECK(tree.children[1].children.size() == 2 && tree.children[1].children[1].name == "b2");
+    Node broken;
+    CHECK(bind_error("name = \"root\"\n[[children]]\nname = \"a\"\n[[children.children]]\n", broken) ==
+          "Missing required key 'children[0].children[0].name'");
+}
+
+TEST(binding_reports_syntax_errors) {
+    Server server;
+    TomlParser parser;
+    CHECK(!parser.parse_into("host = \n", server));
+    CHECK(!parser.get_error().empty());
+    CHECK(parser.result().line == 1);
+    // The parser is usable again after a failed bind
+    Server again;
+    CHECK(parser.parse_into(kMinimal, again));
+    CHECK(again.host == "example.org");
+}
@@ -0,0 +1,228 @@
+#include "check.hpp"
+#include "fasttoml/toml_parser.hpp"
+#include "fasttoml/toml_writer.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace fasttoml;
+
+namespace {
+
+enum class Path { InPlace, FullParse };
+
+// The single edit that turns old_text into new_text: everything between
+// their common prefix and suffix
+TextEdit edit_between(const std::string& old_text, const std::string& new_text) {
+    size_t prefix = 0;
+    const size_t shorter = std::min(old_text.size(), new_text.size());
+    while (prefix < shorter && old_text[prefix] == new_text[prefix]) ++prefix;
+    size_t suffix = 0;
+    while (suffix < shorter - prefix && old_text[old_text.size() - 1 - suffix] == new_text[new_text.size() - 1 - suffix]) {
+        ++suffix;
+    }
+    return TextEdit{prefix, old_text.size() - prefix - suffix, new_text.size() - prefix - suffix};
+}
+
+std::string change_text(const KeyChange& change) {
+    std::string text = change.kind == KeyChange::Kind::Added ? "+" : change.kind == KeyChange::Kind::Removed ? "-" : "~";
+    for (size_t i = 0; i < change.path.size(); ++i) {
+        if (const auto* key = std::get_if<std::string>(&change.path[i])) {
+            text += (i ? "." : "") + *key;
+        } else {
+            text += "[" + std::to_string(std::get<size_t>(change.path[i])) + "]";
+        }
+    }
+    return text;
+}
+
+std::vector<std::string> changes_text(const std::vector<KeyChange>& changes) {
+    std::vector<std::string> texts;
+    for (const KeyChange& change : changes) texts.push_back(change_text(change));
+    return texts;
+}
+
+// Reparses old_text edited into new_text and checks the document against a
+// fresh parse of new_text, key order included, and the reported changes
+// against diff(); returns them as "+a.b", "-a[1]", "~c"
+std::vector<std::string> check_reparse(const std::string& old_text, const std::string& new_text, Path expected,
+                                       const ParseOptions& options = ParseOptions()) {
+    TomlParser parser(options);
+    TablePtr document = parser.parse(old_text);
+    CHECK(document != nullptr);
+    if (!document) return {};
+    const TablePtr before = document;
+    const TablePtr old_copy = TomlParser(options).parse(old_text);
+    std::vector<KeyChange> changes;
+    CHECK(parser.reparse(document, old_text, new_text, edit_between(old_text, new_text), &changes));
+    CHECK((document == before) == (expected == Path::InPlace));
+
+    const TablePtr fresh = TomlParser(options).parse(new_text);
+    CHECK(fresh != nullptr);
+    if (!fresh) return {};
+    CHECK(diff(*document, *fresh).empty());
+    CHECK(to_toml(*document) == to_toml(*fresh));
+    std::vector<std::string> texts = changes_text(changes);
+    std::vector<std::string> expected_changes = changes_text(diff(*old_copy, *fresh));
+    std::sort(texts.begin(), texts.end());
+    std::sort(expected_changes.begin(), expected_changes.end());
+    CHECK(texts == expected_changes);
+    return texts;
+}
+
+using Changes = std::vector<std::string>;
+
+const std::string kConfig =
+    "title = \"demo\"\n"
+    "\n"
+    "[server]\n"
+    "host = \"localhost\"\n"
+    "port = 8080\n"
+    "# listen on every interface\n"
+    "\n"
+    "[database]\n"
+    "name = \"main\"\n"
+    "replicas = [1, 2, 3]\n"
+    "notes = \"\"\"\n"
+    "[not_a_header]\n"
+    "\"\"\"\n"
+    "\n"
+    "[[plugin]]\n"
+    "name = \"auth\"\n"
+    "\n"
+    "[[plugin]]\n"
+    "name = \"cache\"\n";
+
+std::string replaced(std::string text, const std::string& from, const std::string& to) {
+    const size_t at = text.find(from);
+    CHECK(at != std::string::npos);
+    if (at != std::string::npos) text.replace(at, from.size(), to);
+    return text;
+}
+
+} // namespace
+
+TEST(reparse_splices_edited_values) {
+    CHECK((check_reparse(kConfig, replaced(kConfig, "port = 8080", "port = 9090"), Path::InPlace) ==
+           Changes{"~server.port"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "title = \"demo\"", "title = \"prod\""), Path::InPlace) ==
+           Changes{"~title"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[1, 2, 3]", "[1, 5, 3]"), Path::InPlace) ==
+           Changes{"~database.replicas[1]"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[1, 2, 3]", "[1, 2]"), Path::InPlace) ==
+           Changes{"~database.replicas"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "\"cache\"", "\"metrics\""), Path::InPlace) ==
+           Changes{"~plugin[1].name"}));
+    // Keys added, removed and renamed inside one section
+    CHECK((check_reparse(kConfig, replaced(kConfig, "port = 8080\n", "port = 8080\ndebug = true\n"), Path::InPlace) ==
+           Changes{"+server.debug"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "host = \"localhost\"\n", ""), Path::InPlace) ==
+           Changes{"-server.host"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "host =", "hostname ="), Path::InPlace) ==
+           Changes{"+server.hostname", "-server.host"}));
+    // Text inside a multiline string or a comment that is not a header
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[not_a_header]", "[still_not]"), Path::InPlace) ==
+           Changes{"~database.notes"}));
+    CHECK(check_reparse(kConfig, replaced(kConfig, "every interface", "all interfaces"), Path::InPlace).empty());
+    // An edit spanning two sections without changing their headers
+    CHECK((check_reparse(kConfig, replaced(kConfig, "8080\n# listen on every interface\n\n[database]\nname = \"main\"",
+                                           "1\n\n[database]\nname = \"other\""),
+                         Path::InPlace) == Changes{"~database.name", "~server.port"}));
+}
+
+TEST(reparse_in_arena) {
+    ParseOptions options;
+    options.use_arena = true;
+    CHECK((check_reparse(kConfig, replaced(kConfig, "name = \"main\"", "name = \"backup\""), Path::InPlace, options) ==
+           Changes{"~database.name"}));
+}
+
+TEST(reparse_falls_back_to_full_parse) {
+    // Headers renamed, added or removed
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[database]", "[db]"), Path::FullParse) ==
+           Changes{"+db", "-database"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "port = 8080\n", "port = 8080\n[extra]\n"), Path::FullParse) ==
+           Changes{"+extra"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[[plugin]]\nname = \"cache\"", "name2 = \"cache\""),
+                         Path::FullParse) == Changes{"~plugin"}));
+    // A comment that hides a header, or a header that was a comment
+    CHECK((check_reparse(kConfig, replaced(kConfig, "[database]", "# [database]"), Path::FullParse) ==
+           Changes{"+server.name", "+server.notes", "+server.replicas", "-database"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "# listen", "[listen]\n#"), Path::FullParse) == Changes{"+listen"}));
+    // A multiline string that now swallows a header, or no longer does
+    CHECK((check_reparse(kConfig, replaced(kConfig, "port = 8080\n# listen on every interface\n\n[database]\nname = \"main\"",
+                                           "port = \"\"\"8080\n[database]\nname = \"main\"\"\"\""),
+                         Path::FullParse) == Changes{"+server.notes", "+server.replicas", "-database", "~server.port"}));
+    // Header-like text in a new multiline string is not a header
+    CHECK((check_reparse(kConfig, replaced(kConfig, "port = 8080\n", "port = \"\"\"\n[database]\n\"\"\"\n"),
+                         Path::InPlace) == Changes{"~server.port"}));
+    CHECK((check_reparse(kConfig, replaced(kConfig, "notes = \"\"\"\n[not_a_header]\n\"\"\"", "notes = 1\n[now_a_header]"),
+                         Path::FullParse) == Changes{"+now_a_header", "~database.notes"}));
+    // Keys that another section's header also reaches: any edit of either
+    // section is parsed in full
+    const std::string dotted = "a.x = 1\nb = 2\n[a.y]\nz = 3\n";
+    CHECK((check_reparse(dotted, replaced(dotted, "a.x = 1", "a.x = 5"), Path::FullParse) == Changes{"~a.x"}));
+    CHECK((check_reparse(dotted, replaced(dotted, "b = 2", "b = 4"), Path::FullParse) == Changes{"~b"}));
+    CHECK((check_reparse(dotted, replaced(dotted, "z = 3", "z = 6"), Path::FullParse) == Changes{"~a.y.z"}));
+    // Views into the old input would outlive it
+    ParseOptions views;
+    views.string_views = true;
+    CHECK((check_reparse(kConfig, replaced(kConfig, "\"localhost\"", "\"example\""), Path::FullParse, views) ==
+           Changes{"~server.host"}));
+}
+
+TEST(reparse_errors_leave_document_unchanged) {
+    TomlParser parser;
+    TablePtr document = parser.parse(kConfig);
+    const std::string before = to_toml(*document);
+    std::vector<KeyChange> changes;
+
+    const std::string broken = replaced(kConfig, "port = 8080", "port = ");
+    CHECK(!parser.reparse(document, kConfig, broken, edit_between(kConfig, broken), &changes));
+    CHECK(parser.result().code == ParseErrorCode::Syntax);
+    CHECK(parser.result().line == 5);
+    CHECK(to_toml(*document) == before && changes.empty());
+
+    // Redefines the [server] table as an integer
+    const std::string conflict = replaced(kConfig, "title = \"demo\"", "server = 1");
+    CHECK(!parser.reparse(document, kConfig, conflict, edit_between(kConfig, conflict), &changes));
+    CHECK(to_toml(*document) == before);
+
+    CHECK(!parser.reparse(document, kConfig, kConfig, TextEdit{kConfig.size(), 1, 1}, &changes));
+    CHECK(parser.result().code == ParseErrorCode::InvalidEdit);
+    CHECK(parser.get_error() == "Edit does not fit the old and new input");
+    CHECK(to_toml(*document) == before);
+
+    // The parser still reparses after errors
+    const std::string edited = replaced(kConfig, "8080", "1");
+    CHECK(parser.reparse(document, kConfig, edited, edit_between(kConfig, edited), &changes));
+    CHECK(changes_text(changes) == Changes{"~server.port"});
+}
+
+TEST(diff_reports_added_removed_and_changed_keys) {
+    TomlParser parser;
+    TablePtr before = parser.parse(
+        "a = 1\nb = \"x\"\nf = nan\n[t]\nkeep = true\ngone = 1\nlist = [1, [2, 3]]\nsized = [1]\n"
+        "[t.inner]\nv = 1\n[[arr]]\nk = 1\n[[arr]]\nk = 2\n");
+    TablePtr after = parser.parse(
+        "a = 2\nb = \"x\"\nf = nan\nnew = 0\n[t]\nkeep = true\nlist = [1, [2, 4]]\nsized = [1, 2]\n"
+        "inner = 5\n[[arr]]\nk = 1\n[[arr]]\nk = 3\nextra = 1\n");
+    CHECK(before && after);
+    if (!before || !after) return;
+    // Per table: removed and changed keys in the old order, then added ones
+    CHECK((changes_text(diff(*before, *after)) ==
+           Changes{"~a", "-t.gone", "~t.list[1][1]", "~t.sized", "~t.inner", "~arr[1].k", "+arr[1].extra", "+new"}));
+    CHECK(diff(*before, *before).empty());
+    CHECK((changes_text(diff(*after, *before)) ==
+           Changes{"~a", "-new", "~t.list[1][1]", "~t.sized", "~t.inner", "+t.gone", "~arr[1].k", "-arr[1].extra"}));
+    // -0.0 and 0.0 differ; a string equals a view of the same text
+    TablePtr zero = parser.parse("z = 0.0\n");
+    TablePtr negative = parser.parse("z = -0.0\n");
+    CHECK(changes_text(diff(*zero, *negative)) == Changes{"~z"});
+    ParseOptions views;
+    views.string_views = true;
+    const std::string text = "s = \"same\"\n";
+    TablePtr owned = parser.parse(text);
+    TablePtr viewed = TomlParser(views).parse(text);
+    CHECK(diff(*owned, *viewed).empty());
+}
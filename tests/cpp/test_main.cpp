@@ -0,0 +1,47 @@
+// Runs every registered test, or those whose name contains an argument
+#include "check.hpp"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+namespace fasttoml_test {
+
+namespace {
+int failures = 0;
+}
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+void fail(const char* file, int line, const std::string& what) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what.c_str());
+    ++failures;
+}
+
+} // namespace fasttoml_test
+
+int main(int argc, char** argv) {
+    using namespace fasttoml_test;
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : registry()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) selected = selected || std::strstr(test.name, argv[i]);
+        if (!selected) continue;
+        const int before = failures;
+        try {
+            test.run();
+        } catch (const std::exception& e) {
+            fail(test.name, 0, std::string("uncaught exception: ") + e.what());
+        }
+        ++run;
+        if (failures != before) {
+            ++failed;
+            std::fprintf(stderr, "FAIL %s\n", test.name);
+        }
+    }
+    std::printf("%d tests, %d failed\n", run, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include "check.hpp"
+#include "fasttoml/table_map.hpp"
+#include <string>
+
+using fasttoml::Arena;
+using fasttoml::ArenaAllocator;
+using Map = fasttoml::TableMap<int>;
+
+namespace {
+
+std::string key(int i) { return "key" + std::to_string(i); }
+
+// Every key inserted so far is found with its value, in insertion order
+bool complete(const Map& map, int n) {
+    if (map.size() != static_cast<size_t>(n)) return false;
+    for (int i = 0; i < n; ++i) {
+        auto it = map.find(key(i));
+        if (it == map.end() || it->second != i || it - map.begin() != i) return false;
+    }
+    return !map.contains(key(n)) && !map.contains("");
+}
+
+void fill_and_check(Map& map, int n) {
+    for (int i = 0; i < n; ++i) {
+        CHECK(map.try_emplace(key(i), i).second);
+        CHECK(complete(map, i + 1));
+    }
+}
+
+} // namespace
+
+// 17 keys leave linear search; 33, 65, 129, ... grow the index
+TEST(table_map_lookup_across_index_growth) {
+    for (int n : {16, 17, 33, 65, 129, 1000}) {
+        Map map;
+        fill_and_check(map, n);
+        CHECK(!map.try_emplace(key(n - 1), -1).second);
+        CHECK(map.at(key(n - 1)) == n - 1);
+    }
+}
+
+TEST(table_map_lookup_in_arena) {
+    Arena arena;
+    for (int n : {17, 33, 65, 129, 1000}) {
+        Map map{ArenaAllocator<Map::value_type>(&arena)};
+        fill_and_check(map, n);
+    }
+}
+
+TEST(table_map_reserve_then_insert) {
+    Map map;
+    map.reserve(40);
+    fill_and_check(map, 200);
+}
+
+TEST(table_map_erase_keeps_index) {
+    Map map;
+    fill_and_check(map, 129);
+    CHECK(map.erase(key(0)) == 1);
+    CHECK(map.erase(key(0)) == 0);
+    CHECK(!map.contains(key(0)));
+    for (int i = 1; i < 129; ++i) CHECK(map.find(key(i))->second == i);
+    CHECK(map.try_emplace(key(0), 0).second);
+    CHECK(map.begin()[128].first == key(0));
+    CHECK(map.size() == 129);
+}
+
+TEST(table_map_copy_and_move) {
+    Arena arena;
+    Map map{ArenaAllocator<Map::value_type>(&arena)};
+    fill_and_check(map, 65);
+    Map copy(map);
+    CHECK(copy.get_allocator().arena() == nullptr);
+    CHECK(complete(copy, 65));
+    Map moved(std::move(map));
+    CHECK(complete(moved, 65));
+    CHECK(map.empty());
+}
@@ -0,0 +1,38 @@
+"""Tests for the deprecated arena= keyword of loads() and load().
+
+Arena mode itself (ParseOptions::use_arena) is covered by the C++ tests in tests/cpp.
+"""
+
+import warnings
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD
+
+
+@pytest.mark.parametrize("toml_str", [TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD])
+def test_arena_warns_and_matches_default(toml_str):
+    for arena in (True, False):
+        with pytest.warns(DeprecationWarning, match="arena="):
+            assert fasttoml.loads(toml_str, arena=arena) == fasttoml.loads(toml_str)
+
+
+def test_arena_invalid_raises():
+    with pytest.warns(DeprecationWarning):
+        with pytest.raises(fasttoml.TOMLDecodeError):
+            fasttoml.loads('key = "unclosed', arena=True)
+
+
+def test_load_arena(tmp_path):
+    path = tmp_path / "config.toml"
+    path.write_text('[owner]\nname = "Tom"\n', encoding="utf-8")
+    with pytest.warns(DeprecationWarning):
+        assert fasttoml.load(str(path), arena=True) == {"owner": {"name": "Tom"}}
+    with path.open("rb") as fp, pytest.warns(DeprecationWarning):
+        assert fasttoml.load(fp, arena=True) == {"owner": {"name": "Tom"}}
+
+
+def test_no_warning_without_arena():
+    with warnings.catch_warnings():
+        warnings.simplefilter("error")
+        assert fasttoml.loads("a = 1") == {"a": 1}
@@ -0,0 +1,125 @@
+"""Tests for arrays built by the native tree (packed integer/float arrays, numeric_arrays=)."""
+
+import array
+import io
+import math
+
+import pytest
+import fasttoml
+
+
+ARRAYS = {
+    "ints": "[1, -2, 0x10, 9223372036854775807, -9223372036854775808]",
+    "floats": "[1.5, -0.0, inf, 1e300, 3.0]",
+    "empty": "[]",
+    "int_then_float": "[1, 2.0]",
+    "float_then_int": "[1.0, 2]",
+    "int_then_str": '[1, 2, "x"]',
+    "int_then_bool": "[1, true]",
+    "int_then_array": "[1, [2, 3]]",
+    "nested": "[[1, 2], [3.5], []]",
+    "tables": "[{a = [1, 2]}, {a = [3.0]}]",
+    "strings": '["a", "b"]',
+}
+
+
+def _doc():
+    return "".join(f"{key} = {value}\n" for key, value in ARRAYS.items())
+
+
+def _native_results(doc):
+    # These entry points convert the C++ tree, unlike loads() of small inputs
+    big = doc + "".join(f"pad{i} = {i}\n" for i in range(8000))
+    return [fasttoml.loads_bytes(doc.encode("utf-8")), fasttoml.loads_many([doc])[0], fasttoml.loads(big)]
+
+
+def test_packed_arrays_match_loads():
+    expected = fasttoml.loads(_doc())
+    assert expected["ints"] == [1, -2, 16, 2**63 - 1, -2**63]
+    assert expected["int_then_str"] == [1, 2, "x"]
+    assert expected["int_then_array"] == [1, [2, 3]]
+    for result in _native_results(_doc()):
+        for key in ARRAYS:
+            assert result[key] == expected[key], key
+            assert [type(x) for x in result[key]] == [type(x) for x in expected[key]], key
+
+
+def test_element_types():
+    result = fasttoml.loads_bytes(_doc().encode("utf-8"))
+    assert math.copysign(1.0, result["floats"][1]) == -1.0
+    assert result["floats"][2] == math.inf
+    assert type(result["int_then_float"][0]) is int and type(result["int_then_float"][1]) is float
+    assert result["int_then_bool"] == [1, True] and type(result["int_then_bool"][1]) is bool
+
+
+def test_large_numeric_arrays():
+    ints = list(range(-5000, 5000, 3))
+    floats = [i / 8 for i in range(5000)]
+    doc = f"ints = {ints}\nfloats = {floats}\ntail = [{', '.join(map(str, ints))}, 'end']\n"
+    for result in _native_results(doc):
+        assert result["ints"] == ints
+        assert result["floats"] == floats
+        assert result["tail"] == ints + ["end"]
+
+
+def test_arrays_of_tables_after_numbers():
+    doc = "a = [1, 2]\n[[b]]\nx = [1.0]\n[[b]]\nx = [2, 3]\n"
+    assert fasttoml.loads_bytes(doc.encode("utf-8")) == {"a": [1, 2], "b": [{"x": [1.0]}, {"x": [2, 3]}]}
+    with pytest.raises(ValueError):
+        fasttoml.loads_bytes(b"a = [1, 2]\n[[a]]\n")
+
+
+def test_numeric_arrays_buffer():
+    doc = _doc()
+    expected = fasttoml.loads(doc)
+    result = fasttoml.loads(doc, numeric_arrays="buffer")
+    assert isinstance(result["ints"], array.array) and result["ints"].typecode == "q"
+    assert isinstance(result["floats"], array.array) and result["floats"].typecode == "d"
+    assert result["ints"].tolist() == expected["ints"]
+    assert result["floats"][:2].tolist() == expected["floats"][:2]
+    # Empty, mixed and non-numeric arrays stay lists; nesting is converted throughout
+    for key in ("empty", "int_then_float", "int_then_str", "int_then_bool", "strings"):
+        assert type(result[key]) is list and result[key] == expected[key], key
+    assert type(result["nested"]) is list
+    assert [x.tolist() for x in result["nested"][:2]] == [[1, 2], [3.5]] and result["nested"][2] == []
+    assert result["tables"][1]["a"].tolist() == [3.0]
+    assert result["int_then_array"][1].tolist() == [2, 3]
+    assert memoryview(result["ints"]).format == "q"
+
+
+def test_numeric_arrays_entry_points(tmp_path):
+    doc = "a = [1, 2, 3]\n[t]\nb = [0.5]\n"
+    path = tmp_path / "doc.toml"
+    path.write_bytes(doc.encode("utf-8"))
+    parser = fasttoml.Parser()
+    results = [
+        fasttoml.loads(doc, numeric_arrays="buffer"),
+        fasttoml.loads_bytes(doc.encode("utf-8"), numeric_arrays="buffer"),
+        fasttoml.load_path(path, numeric_arrays="buffer"),
+        fasttoml.load(path, numeric_arrays="buffer"),
+        fasttoml.load(io.BytesIO(doc.encode("utf-8")), numeric_arrays="buffer"),
+        fasttoml.loads(doc, select=["t.b"], numeric_arrays="buffer"),
+        parser.loads(doc, numeric_arrays="buffer"),
+        parser.load(io.StringIO(doc), numeric_arrays="buffer"),
+    ]
+    for result in results:
+        assert result["t"]["b"] == array.array("d", [0.5])
+    assert all(isinstance(r["a"], array.array) for r in results if "a" in r)
+    assert type(fasttoml.loads(doc, numeric_arrays="list")["a"]) is list
+    with pytest.raises(ValueError, match="numeric_arrays"):
+        fasttoml.loads(doc, numeric_arrays="numpy")
+    with pytest.raises(ValueError):
+        fasttoml.loads("a = [1, 2\n", numeric_arrays="buffer")
+
+
+def test_numeric_arrays_numpy():
+    np = pytest.importorskip("numpy")
+    values = [i * 0.25 for i in range(1000)]
+    result = fasttoml.loads(f"w = {values}\n", numeric_arrays="buffer")
+    weights = np.asarray(result["w"])
+    assert weights.dtype == np.float64 and weights.tolist() == values
+    assert np.shares_memory(weights, np.frombuffer(result["w"], dtype=np.float64))
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
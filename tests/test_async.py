@@ -0,0 +1,178 @@
+"""Tests for aload, aload_many and aloads_many (asyncio)."""
+
+import asyncio
+import gc
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+import pytest
+import fasttoml
+
+
+DOC = '''
+title = "routes"
+[[route]]
+path = "/api"
+upstream = ["a", "b"]
+[[route]]
+path = "/health"
+timeout = 1.5
+'''
+
+
+def _big_doc(routes=20000):
+    return "".join(f'[[route]]\npath = "/r{i}"\nweight = {i}\nupstream = ["a{i}", "b"]\n' for i in range(routes))
+
+
+def _run(coro):
+    return asyncio.run(coro)
+
+
+def test_aload(tmp_path):
+    path = tmp_path / "routes.toml"
+    path.write_text(DOC, encoding="utf-8")
+    expected = fasttoml.load_path(path)
+    assert _run(fasttoml.aload(path)) == expected
+    assert _run(fasttoml.aload(str(path))) == expected
+    assert _run(fasttoml.aload(bytes(path))) == expected
+
+
+def test_aload_many(tmp_path):
+    paths = []
+    for i in range(12):
+        path = tmp_path / f"c{i}.toml"
+        path.write_text(f"id = {i}\n" + DOC, encoding="utf-8")
+        paths.append(path)
+    for threads in (None, 1, 3):
+        result = _run(fasttoml.aload_many(paths, threads=threads))
+        assert [r["id"] for r in result] == list(range(12))
+        assert result[0]["route"][1] == {"path": "/health", "timeout": 1.5}
+    assert _run(fasttoml.aload_many([])) == []
+
+
+def test_aloads_many():
+    docs = [f"n = {i}\n" for i in range(50)] + [DOC.encode(), bytearray(b"x = 1"), memoryview(b"y = 2")]
+    result = _run(fasttoml.aloads_many(docs, threads=4))
+    assert result == fasttoml.loads_many(docs)
+    assert result[-1] == {"y": 2}
+    assert _run(fasttoml.aloads_many([])) == []
+
+
+def test_concurrent_loads(tmp_path):
+    path = tmp_path / "routes.toml"
+    path.write_text(DOC, encoding="utf-8")
+
+    async def main():
+        return await asyncio.gather(*(fasttoml.aload(path) for _ in range(40)))
+
+    results = _run(main())
+    assert len(results) == 40 and all(r == results[0] for r in results)
+
+
+def test_loop_runs_while_parsing():
+    doc = _big_doc()
+    ticks = 0
+
+    async def ticker():
+        nonlocal ticks
+        while True:
+            ticks += 1
+            await asyncio.sleep(0)
+
+    async def main():
+        task = asyncio.ensure_future(ticker())
+        result = await fasttoml.aloads_many([doc])
+        task.cancel()
+        return result
+
+    result = _run(main())
+    assert len(result[0]["route"]) == 20000
+    assert ticks >= 1
+
+
+def test_errors(tmp_path):
+    bad = tmp_path / "bad.toml"
+    bad.write_text("a = 1\nb = \n", encoding="utf-8")
+    with pytest.raises(fasttoml.TOMLDecodeError) as info:
+        _run(fasttoml.aload(bad))
+    assert info.value.lineno == 2
+    assert "document" not in str(info.value)
+    with pytest.raises(FileNotFoundError):
+        _run(fasttoml.aload(tmp_path / "missing.toml"))
+    # The first failing input, in order, is raised
+    with pytest.raises(fasttoml.TOMLDecodeError) as info:
+        _run(fasttoml.aload_many([bad, tmp_path / "missing.toml"]))
+    assert "document 0" in str(info.value)
+    with pytest.raises(FileNotFoundError):
+        _run(fasttoml.aload_many([tmp_path / "missing.toml", bad]))
+    with pytest.raises(fasttoml.TOMLDecodeError) as info:
+        _run(fasttoml.aloads_many(["a = 1", "b = ", "c = 3"]))
+    assert "document 1" in str(info.value)
+    with pytest.raises(TypeError):
+        _run(fasttoml.aloads_many([1]))
+
+
+def test_cancel():
+    docs = [_big_doc(2000)] * 64
+
+    async def main():
+        task = asyncio.ensure_future(fasttoml.aloads_many(docs, threads=2))
+        await asyncio.sleep(0)
+        task.cancel()
+        with pytest.raises(asyncio.CancelledError):
+            await task
+        # The loop and the module keep working after a cancelled batch
+        return await fasttoml.aloads_many(["a = 1"])
+
+    assert _run(main()) == [{"a": 1}]
+    gc.collect()
+
+
+def test_cancel_does_not_block_loop(tmp_path):
+    # A cancelled aload of a large file finishes parsing in the background:
+    # the loop goes on right away instead of waiting for the parse
+    path = tmp_path / "big.toml"
+    path.write_text(_big_doc(200000), encoding="utf-8")
+    start = time.perf_counter()
+    fasttoml.load_path(path)
+    parse_time = time.perf_counter() - start
+
+    async def main():
+        task = asyncio.ensure_future(fasttoml.aload(path))
+        await asyncio.sleep(0.01)
+        start = time.perf_counter()
+        task.cancel()
+        with pytest.raises(asyncio.CancelledError):
+            await task
+        del task
+        gc.collect()
+        ticks = 0
+        while ticks < 10:
+            await asyncio.sleep(0)
+            ticks += 1
+        return time.perf_counter() - start
+
+    assert _run(main()) < parse_time / 4
+    gc.collect()
+
+
+def test_requires_running_loop(tmp_path):
+    coro = fasttoml.aload(Path(tmp_path) / "x.toml")
+    with pytest.raises(RuntimeError):
+        coro.send(None)
+    coro.close()
+
+
+def test_import_does_not_load_asyncio():
+    code = "import sys, fasttoml; print('asyncio' in sys.modules)"
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+    result = subprocess.run([sys.executable, "-c", code], cwd=Path(__file__).parent, env=env,
+                            capture_output=True, text=True, check=True)
+    assert result.stdout.strip() == "False"
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
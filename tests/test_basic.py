@@ -93,6 +93,30 @@ def test_loads_empty_string():
     assert result == {}
 
 
+@pytest.mark.parametrize("literal,expected", [
+    ("1_000_000", 1000000),
+    ("-17", -17),
+    ("+99", 99),
+    ("9223372036854775807", 9223372036854775807),
+    ("-9223372036854775808", -9223372036854775808),
+    ("0xDEAD_beef", 0xDEADBEEF),
+    ("0o755", 0o755),
+    ("0b1101_0101", 0b11010101),
+    ("6.626e-34", 6.626e-34),
+    ("1e1_0", 1e10),
+    ("-0.0", -0.0),
+    ("224_617.445_991", 224617.445991),
+    ("0.1", 0.1),
+    ("3.141592653589793238462643383279", 3.141592653589793),
+    ("1.7976931348623157e308", 1.7976931348623157e308),
+])
+def test_loads_number_literals(literal, expected):
+    """Integers and floats are parsed exactly (correctly rounded floats)."""
+    value = fasttoml.loads(f"v = {literal}")["v"]
+    assert type(value) is type(expected)
+    assert value == expected
+
+
 def test_loads_error():
     """Test error handling for invalid TOML."""
     with pytest.raises(ValueError):
@@ -0,0 +1,61 @@
+"""Tests for building dicts/lists directly while parsing (no intermediate C++ tree)."""
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD
+
+
+@pytest.mark.parametrize("toml_str", [TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD])
+def test_builder_returns_plain_containers(toml_str):
+    """Every table is a plain dict and every array a plain list."""
+    def walk(obj):
+        if isinstance(obj, dict):
+            assert type(obj) is dict
+            for value in obj.values():
+                walk(value)
+        elif isinstance(obj, list):
+            assert type(obj) is list
+            for value in obj:
+                walk(value)
+    walk(fasttoml.loads(toml_str))
+
+
+def test_keys_in_document_order():
+    toml_str = 'zeta = 1\nalpha = 2\nmid = { y = 1, b = 2 }\n[z]\n[a]\n'
+    result = fasttoml.loads(toml_str)
+    assert list(result) == ["zeta", "alpha", "mid", "z", "a"]
+    assert list(result["mid"]) == ["y", "b"]
+
+
+def test_array_of_tables_with_subtables():
+    """Many [[x]] entries, each extended by [x.sub], land in the last element."""
+    toml_str = "\n".join(f'[[servers]]\nname = "s{i}"\n[servers.meta]\nid = {i}\n' for i in range(500))
+    result = fasttoml.loads(toml_str)
+    assert len(result["servers"]) == 500
+    assert result["servers"][499] == {"name": "s499", "meta": {"id": 499}}
+
+
+def test_nested_inline_tables_and_arrays():
+    toml_str = 'a = [[1, 2], [3, 4]]\nb = { c = { d = [5, 6] } }\nc = [{ x = 1 }, { y = [{}] }]\n'
+    assert fasttoml.loads(toml_str) == {
+        "a": [[1, 2], [3, 4]],
+        "b": {"c": {"d": [5, 6]}},
+        "c": [{"x": 1}, {"y": [{}]}],
+    }
+
+
+def test_dotted_keys_extend_tables():
+    toml_str = 'a.b.c = 1\na.b.d = 2\n[x]\ny.z = 3\n'
+    assert fasttoml.loads(toml_str) == {"a": {"b": {"c": 1, "d": 2}}, "x": {"y": {"z": 3}}}
+
+
+@pytest.mark.parametrize("toml_str", [
+    'a = [1]\n[[a]]\n',       # static array cannot become an array of tables
+    'a = [1]\n[a.b]\n',       # nor be extended by a table header
+    'a = 1\n[a]\n',           # scalar used as a table
+    'a = 1\na.b = 2\n',       # scalar used as a dotted-key prefix
+    'key = "unclosed',
+])
+def test_builder_invalid_raises(toml_str):
+    with pytest.raises(ValueError):
+        fasttoml.loads(toml_str)
@@ -2,7 +2,7 @@
 
 import io
 import tempfile
-from datetime import datetime, timezone
+from datetime import datetime, timedelta, timezone
 
 import pytest
 import fasttoml
@@ -147,3 +147,80 @@ def test_dumps_not_dict_raises():
         fasttoml.dumps([1, 2, 3])
     with pytest.raises(TypeError, match="dict"):
         fasttoml.dumps("x")
+
+
+def test_dumps_unsupported_types_raise():
+    with pytest.raises(TypeError, match="None"):
+        fasttoml.dumps({"a": None})
+    with pytest.raises(TypeError, match="set"):
+        fasttoml.dumps({"a": {1, 2}})
+    with pytest.raises(TypeError, match="keys must be str"):
+        fasttoml.dumps({1: "x"})
+    with pytest.raises(TypeError, match=r"\[\[section\]\]"):
+        fasttoml.dumps({"a": [[{"b": 1}]]})
+
+
+def test_dumps_escapes():
+    s = 'q" b\\ \n\r\t \x00\x1f\x7f é ✓ \U0001F600'
+    out = fasttoml.dumps({"s": s})
+    assert out == 's = "q\\" b\\\\ \\n\\r\\t \\u0000\\u001f\\u007f é ✓ \U0001F600"'
+    assert fasttoml.loads(out)["s"] == s
+
+
+@pytest.mark.parametrize("pos", [0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 100])
+def test_dumps_long_string_escape_position(pos):
+    body = "x" * 120
+    s = body[:pos] + "\t" + body[pos:]
+    assert fasttoml.dumps({"s": s}) == 's = "' + body[:pos] + "\\t" + body[pos:] + '"'
+
+
+def test_dumps_quoted_keys_in_headers():
+    data = {"a.b": {"c d": {"x": 1}}, "é": [{"y": 2}]}
+    out = fasttoml.dumps(data)
+    assert '["a.b"."c d"]' in out
+    assert '[["é"]]' in out
+    assert fasttoml.loads(out) == data
+
+
+@pytest.mark.parametrize("value", [0.1, 1e16, 1e-5, 1.5e-7, 123456.789, -0.0, 5e-324, 1.7976931348623157e308])
+def test_dumps_float_matches_repr(value):
+    assert fasttoml.dumps({"f": value}) == "f = " + repr(value)
+
+
+def test_dumps_datetime_offsets():
+    tz = timezone(timedelta(hours=-5, minutes=-30))
+    data = {
+        "a": datetime(2024, 1, 2, 3, 4, 5, 250000, tzinfo=tz),
+        "b": datetime(999, 1, 2, 3, 4, 5, tzinfo=timezone.utc),
+    }
+    assert fasttoml.dumps(data) == "a = 2024-01-02T03:04:05.25-05:30\nb = 0999-01-02T03:04:05Z"
+
+
+def test_dumps_big_int():
+    assert fasttoml.dumps({"n": 2 ** 70, "m": -(2 ** 63)}) == f"m = {-(2 ** 63)}\nn = {2 ** 70}"
+
+
+def test_dumps_matches_reference_implementation():
+    from fasttoml import _dumps as reference
+
+    data = {
+        "title": "x",
+        "when": datetime(2024, 5, 6, 7, 8, 9, tzinfo=timezone.utc),
+        "day": "2024-05-06",
+        "local": "2024-05-06 07:08:09",
+        "mixed": [1, 2.5, "s", True, {"k": [1, {"z": "w"}]}],
+        "owner": {"name": "n", "dob": "1979-05-27T07:32:00", "deep": {"x": [1, 2]}},
+        "products": [{"name": "a", "sku": 1}, {"name": "b", "tags": {"t": 1}, "parts": [{"p": 1}]}],
+        "ctl": "\x01\x7f\\",
+    }
+    assert fasttoml.dumps(data) == reference.dumps(data)
+
+
+def test_dump_path_non_utf8_encoding(tmp_path):
+    path = str(tmp_path / "latin.toml")
+    fasttoml.dump({"k": "é"}, path, encoding="latin-1")
+    with open(path, "rb") as f:
+        assert f.read() == 'k = "é"'.encode("latin-1")
+    fasttoml.dump({"k": "é"}, path)
+    with open(path, "rb") as f:
+        assert f.read() == 'k = "é"'.encode("utf-8")
@@ -63,3 +63,117 @@ def test_invalid_date_time_raises(invalid_toml, substring):
     msg = str(exc_info.value).lower()
     if substring:
         assert substring.lower() in msg
+
+
+# Input validation: control characters (except tab, LF, CR in CRLF) are rejected anywhere
+@pytest.mark.parametrize("invalid_toml", [
+    'a = "x\x00y"',
+    'a = 1 # bell \x07',
+    'a = \'del \x7f\'',
+    'a = 1\rb = 2',
+    'a = 1\r',
+    "x" * 40 + ' = "' + "y" * 40 + '\x1f"',
+])
+def test_control_characters_rejected(invalid_toml):
+    with pytest.raises(ValueError) as exc_info:
+        fasttoml.loads(invalid_toml)
+    assert "control" in str(exc_info.value).lower()
+
+
+def test_crlf_and_tab_accepted():
+    toml_str = "a = 1\r\nb = \"\tx\"\r\n" + "# " + "é" * 40 + "\r\n"
+    assert fasttoml.loads(toml_str) == {"a": 1, "b": "\tx"}
+
+
+@pytest.mark.parametrize("invalid_toml", [
+    "n = 9223372036854775808",
+    "n = -9223372036854775809",
+    "n = 0x1_0000_0000_0000_0000",
+    "n = 1__000",
+    "n = 1_",
+    "n = _1",
+    "n = 1_.5",
+    "n = 1.2.3",
+    "n = 1e",
+    "n = 1e5e",
+    "n = 1.e5",
+    "n = +.5",
+    "n = -01",
+    "n = 1-2",
+    "n = 0b102",
+    "n = 1e400",
+])
+def test_invalid_numbers_raise(invalid_toml):
+    with pytest.raises(ValueError):
+        fasttoml.loads(invalid_toml)
+
+
+@pytest.mark.parametrize("doc,lineno,colno,fragment", [
+    ("a = 1\nb = [1, 2, x]\n", 2, 12, "Unexpected character"),
+    ("a = 1\nn = 99999999999999999999\n", 2, 5, "out of range"),
+    ("[a]\nb = 1\n[a.b]\nc = 2\n", 3, 1, "already defined"),
+    ("a = 1\nd = 1979-13-01\n", 2, 5, "month"),
+    ("a = 1 b\n", 1, 7, "after value"),
+    ("a = 1\r\nb = \x01\n", 2, 5, "Control characters"),
+])
+def test_error_position(doc, lineno, colno, fragment):
+    parsers = [
+        fasttoml.loads,
+        lambda s: fasttoml.loads_bytes(s.encode("utf-8")),
+        # Structural errors are raised by loads_lazy, others when the value is parsed
+        lambda s: fasttoml.loads_lazy(s).to_dict(),
+    ]
+    if fragment != "already defined":
+        # One line per chunk, so that statements before the error are dropped
+        parsers.append(lambda s: list(fasttoml.iter_events(s.splitlines(keepends=True))))
+        parsers.append(lambda s: list(fasttoml.iter_events([s.encode("utf-8")])))
+    for parse in parsers:
+        with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+            parse(doc)
+        e = exc_info.value
+        assert isinstance(e, ValueError)
+        assert fragment in e.msg and (e.lineno, e.colno) == (lineno, colno)
+        assert doc[:e.pos].count("\n") == lineno - 1
+        assert f"(line {lineno}, column {colno})" in str(e)
+
+
+def test_error_position_counts_characters_in_str():
+    doc = 'k = "éé"\nv = "é\\q"\n'
+    with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+        fasttoml.loads(doc)
+    assert (exc_info.value.lineno, exc_info.value.colno) == (2, 7)
+    assert doc[exc_info.value.pos] == "\\"
+    # Bytes input is located in bytes
+    data = doc.encode("utf-8")
+    with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+        fasttoml.loads_bytes(data)
+    assert exc_info.value.colno == 8 and data[exc_info.value.pos:exc_info.value.pos + 1] == b"\\"
+    # Lazily parsed values and str chunks of a stream count characters too
+    for parse in (lambda s: fasttoml.loads_lazy(s)["v"], lambda s: list(fasttoml.iter_events(["k = \"é", s[6:]]))):
+        with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+            parse(doc)
+        assert (exc_info.value.lineno, exc_info.value.colno) == (2, 7)
+        assert doc[exc_info.value.pos] == "\\"
+    with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+        list(fasttoml.iter_events([data[:7], data[7:]]))
+    assert exc_info.value.colno == 8 and data[exc_info.value.pos:exc_info.value.pos + 1] == b"\\"
+
+
+def test_error_position_in_batches(tmp_path):
+    docs = ["a = 1\n", "a = 1\nb = [1, x]\n"]
+    with pytest.raises(fasttoml.TOMLDecodeError, match="document 1") as exc_info:
+        fasttoml.loads_many(docs)
+    assert (exc_info.value.lineno, exc_info.value.colno) == (2, 9)
+    paths = []
+    for i, doc in enumerate(docs):
+        paths.append(tmp_path / f"{i}.toml")
+        paths[-1].write_text(doc, encoding="utf-8")
+    with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+        fasttoml.load_many(paths)
+    assert exc_info.value.lineno == 2
+    # Errors in lazily parsed values are located in the document
+    doc = fasttoml.loads_lazy("b = 1\n[t]\na = [1,\n  x]\n")
+    with pytest.raises(fasttoml.TOMLDecodeError) as exc_info:
+        doc["t"]["a"]
+    e = exc_info.value
+    assert (e.lineno, e.colno, e.pos) == (4, 3, 20) and "Unexpected character" in e.msg
@@ -91,6 +91,55 @@ def test_datetime_with_fraction():
     assert result["ts"].microsecond == 999999
 
 
+@pytest.mark.parametrize("frac,micro", [("1", 100000), ("123456", 123456), ("000001", 1), ("1234567891", 123456)])
+def test_datetime_fraction_exact_microseconds(frac, micro):
+    """Fractions are not rounded through a float; extra digits are truncated."""
+    result = fasttoml.loads(f"ts = 2021-03-04T05:06:07.{frac}+05:30")
+    assert result["ts"].microsecond == micro
+    assert (result["ts"].hour, result["ts"].minute, result["ts"].second) == (5, 6, 7)
+
+
+@pytest.mark.parametrize("text,expected", [
+    ("1969-07-20T20:17:40Z", datetime(1969, 7, 20, 20, 17, 40, tzinfo=timezone.utc)),
+    ("1900-01-01T00:00:00Z", datetime(1900, 1, 1, tzinfo=timezone.utc)),
+    ("2099-12-31T23:59:59.5Z", datetime(2099, 12, 31, 23, 59, 59, 500000, tzinfo=timezone.utc)),
+    ("2100-02-28 12:00:00+01:00", datetime(2100, 2, 28, 11, tzinfo=timezone.utc)),
+])
+def test_offset_datetime_outside_1970_2037(text, expected):
+    result = fasttoml.loads(f"ts = {text}")["ts"]
+    assert isinstance(result, datetime)
+    assert result == expected
+
+
+def test_offset_datetime_outside_clock_range_is_text():
+    """Instants the 64-bit nanosecond clock cannot hold (before 1678, after 2262) keep their text."""
+    result = fasttoml.loads("a = 0001-01-01T00:00:00Z\nb = 9999-12-31 23:59:59+01:00")
+    assert result == {"a": "0001-01-01T00:00:00Z", "b": "9999-12-31T23:59:59+01:00"}
+
+
+def test_local_values_normalized():
+    result = fasttoml.loads("a = 1979-05-27 07:32:00\nb = 1979-05-27t07:32:00.5\nc = 07:32:00.123456789123")
+    assert result == {"a": "1979-05-27T07:32:00", "b": "1979-05-27T07:32:00.5", "c": "07:32:00.123456789"}
+
+
+def test_local_values_in_arrays():
+    result = fasttoml.loads("a = [1979-05-27, 07:32:00.250, 1979-05-27T00:00:00]")
+    assert result["a"] == ["1979-05-27", "07:32:00.250", "1979-05-27T00:00:00"]
+
+
+@pytest.mark.parametrize("text", ["07:32:00.", "1979-05-27T07:32:00.", "1979-02-29", "24:00:00", "07:60:00"])
+def test_invalid_date_time(text):
+    with pytest.raises(fasttoml.TOMLDecodeError):
+        fasttoml.loads(f"a = {text}")
+
+
+def test_datetime_offsets_share_tzinfo():
+    toml_str = "a = 1979-05-27T00:32:00-07:00\nb = 2020-01-01T00:00:00-07:00\nc = 2020-01-01T00:00:00Z"
+    result = fasttoml.loads(toml_str)
+    assert result["a"].tzinfo is result["b"].tzinfo
+    assert result["c"].tzinfo is timezone.utc
+
+
 def test_full_example_with_inline_and_datetime():
     toml_str = """
 [owner]
@@ -0,0 +1,148 @@
+"""Tests for the on-demand document mode (loads_lazy, load_lazy, LazyTable)."""
+
+from collections.abc import Mapping
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD
+
+
+DOC = '''
+title = "demo"
+ports = [8000, 8001]
+owner.name = "Tom"
+
+[server]
+host = "localhost"
+limits = { cpu = 2, mem = "1G" }
+
+[[jobs]]
+name = "a"
+[[jobs]]
+name = "b"
+[jobs.retry]
+count = 3
+'''
+
+
+def test_mapping_protocol():
+    doc = fasttoml.loads_lazy(DOC)
+    assert isinstance(doc, fasttoml.LazyTable)
+    assert isinstance(doc, Mapping)
+    assert len(doc) == 5
+    assert list(doc) == ["title", "ports", "owner", "server", "jobs"]
+    assert list(doc.keys()) == list(doc)
+    assert "server" in doc and "missing" not in doc and 1 not in doc
+    assert doc["title"] == "demo"
+    assert doc.get("missing") is None
+    assert doc.get("missing", 5) == 5
+    assert [k for k, _ in doc.items()] == list(doc)
+    assert len(doc.values()) == 5
+    with pytest.raises(KeyError):
+        doc["missing"]
+    assert repr(doc) == "<fasttoml.LazyTable with 5 keys>"
+
+
+def test_nested_tables_and_arrays_of_tables():
+    doc = fasttoml.loads_lazy(DOC)
+    server = doc["server"]
+    assert isinstance(server, fasttoml.LazyTable)
+    assert server["host"] == "localhost"
+    assert server["limits"] == {"cpu": 2, "mem": "1G"}
+    assert doc["owner"]["name"] == "Tom"
+    jobs = doc["jobs"]
+    assert isinstance(jobs, list) and len(jobs) == 2
+    assert all(isinstance(job, fasttoml.LazyTable) for job in jobs)
+    assert jobs[1]["name"] == "b"
+    assert jobs[1]["retry"]["count"] == 3
+
+
+def test_values_are_cached():
+    doc = fasttoml.loads_lazy(DOC)
+    assert doc["server"] is doc["server"]
+    assert doc["ports"] is doc["ports"]
+    assert doc["jobs"] is doc["jobs"]
+
+
+def test_to_dict():
+    doc = fasttoml.loads_lazy(DOC)
+    result = doc.to_dict()
+    assert result == fasttoml.loads(DOC)
+    assert type(result["server"]) is dict
+    assert type(result["jobs"][0]) is dict
+    assert result is not doc.to_dict()
+
+
+@pytest.mark.parametrize("text", [TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD])
+def test_to_dict_matches_loads(text):
+    assert fasttoml.loads_lazy(text).to_dict() == fasttoml.loads(text)
+
+
+def test_large_table():
+    text = "".join(f"k{i} = {i}\n" for i in range(100)) + "k7 = 70\n"
+    doc = fasttoml.loads_lazy(text)
+    assert len(doc) == 100
+    assert doc["k99"] == 99
+    assert doc["k7"] == 70
+    assert "k100" not in doc
+
+
+def test_value_errors_are_deferred():
+    doc = fasttoml.loads_lazy('good = 1\nbad = [1, 2, "x\\q"]\n')
+    assert doc["good"] == 1
+    with pytest.raises(ValueError, match="bad"):
+        doc["bad"]
+    with pytest.raises(ValueError):
+        doc.to_dict()
+
+
+@pytest.mark.parametrize("text", [
+    "a = ",
+    'a = "unterminated',
+    "a = [1, 2",
+    "a = { b = 1",
+    "[t]\nx = 1\n[[t]]",
+    "x = 1\nx.y = 2",
+])
+def test_structural_errors_raised_at_load(text):
+    with pytest.raises(ValueError):
+        fasttoml.loads_lazy(text)
+
+
+@pytest.mark.parametrize("text", ["a = 1 b = 2", "a = 'x' 'y'", "x = 1979-05-27T"])
+def test_text_after_value_rejected(text):
+    with pytest.raises(ValueError):
+        fasttoml.loads(text)
+    with pytest.raises(ValueError):
+        fasttoml.loads_lazy(text).to_dict()
+
+
+def test_input_types():
+    expected = fasttoml.loads(DOC)
+    data = DOC.encode("utf-8")
+    assert fasttoml.loads_lazy(data).to_dict() == expected
+    assert fasttoml.loads_lazy(bytearray(data)).to_dict() == expected
+    assert fasttoml.loads_lazy(memoryview(data)).to_dict() == expected
+    with pytest.raises(TypeError):
+        fasttoml.loads_lazy(1)
+
+
+def test_outlives_input():
+    buf = bytearray(DOC.encode("utf-8"))
+    doc = fasttoml.loads_lazy(buf)
+    buf[:] = b"#" * len(buf)
+    assert doc["server"]["host"] == "localhost"
+
+
+def test_load_lazy(tmp_path):
+    path = tmp_path / "config.toml"
+    path.write_bytes(TOML_REALWORLD.encode("utf-8"))
+    doc = fasttoml.load_lazy(path)
+    assert doc.to_dict() == fasttoml.loads(TOML_REALWORLD)
+    assert fasttoml.load_lazy(str(path)).to_dict() == doc.to_dict()
+    with pytest.raises(FileNotFoundError):
+        fasttoml.load_lazy(tmp_path / "missing.toml")
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
@@ -0,0 +1,112 @@
+"""Tests for the native file/bytes entry points (load_path, loads_bytes, load, loads_many, load_many)."""
+
+import io
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_REALWORLD
+
+
+DOC = '[owner]\nname = "Tom"\nbio = """\nline 1\nline 2"""\n[[servers]]\nip = "10.0.0.1"\n'
+EXPECTED = {"owner": {"name": "Tom", "bio": "line 1\nline 2"}, "servers": [{"ip": "10.0.0.1"}]}
+
+
+def test_load_path_str_and_pathlike(tmp_path):
+    path = tmp_path / "config.toml"
+    path.write_bytes(DOC.encode("utf-8"))
+    assert fasttoml.load_path(str(path)) == EXPECTED
+    assert fasttoml.load_path(path) == EXPECTED
+    assert fasttoml.load(path) == EXPECTED
+
+
+def test_load_path_matches_loads(tmp_path):
+    path = tmp_path / "realworld.toml"
+    path.write_bytes(TOML_REALWORLD.encode("utf-8"))
+    assert fasttoml.load_path(path) == fasttoml.loads(TOML_REALWORLD)
+
+
+def test_load_path_empty_file(tmp_path):
+    path = tmp_path / "empty.toml"
+    path.write_bytes(b"")
+    assert fasttoml.load_path(path) == {}
+
+
+def test_load_path_errors(tmp_path):
+    with pytest.raises(FileNotFoundError):
+        fasttoml.load_path(tmp_path / "missing.toml")
+    with pytest.raises(OSError):
+        fasttoml.load_path(tmp_path)
+    bad = tmp_path / "bad.toml"
+    bad.write_bytes(b'a = "\xff"\n')
+    with pytest.raises(ValueError):
+        fasttoml.load_path(bad)
+
+
+@pytest.mark.parametrize("wrap", [bytes, bytearray, memoryview])
+def test_loads_bytes(wrap):
+    assert fasttoml.loads_bytes(wrap(DOC.encode("utf-8"))) == EXPECTED
+
+
+def test_loads_bytes_invalid():
+    with pytest.raises(ValueError):
+        fasttoml.loads_bytes(b"key = ")
+    with pytest.raises(ValueError):
+        fasttoml.loads_bytes(b'a = "\xc3\x28"')
+    with pytest.raises((TypeError, BufferError)):
+        fasttoml.loads_bytes(memoryview(b"a = 1\n" * 4)[::2])
+
+
+def test_load_binary_and_text_file_objects():
+    assert fasttoml.load(io.BytesIO(DOC.encode("utf-8"))) == EXPECTED
+    assert fasttoml.load(io.StringIO(DOC)) == EXPECTED
+
+
+def test_crlf_file_matches_lf():
+    """CRLF line endings (also inside multiline strings) parse like LF."""
+    crlf = DOC.replace("\n", "\r\n").encode("utf-8")
+    assert fasttoml.loads_bytes(crlf) == EXPECTED
+    assert fasttoml.loads("a = '''\r\nx\r\ny'''\r\n") == {"a": "x\ny"}
+
+
+# --- Batch API (parsed on native threads without the GIL) ---
+
+def test_loads_many_matches_loads():
+    docs = [DOC, TOML_REALWORLD, DOC.encode("utf-8"), bytearray(b"a = 1\n"), memoryview(b"b = 'x'\n")] * 50
+    expected = [fasttoml.loads(d) if isinstance(d, str) else fasttoml.loads_bytes(d) for d in docs]
+    assert fasttoml.loads_many(docs, threads=4) == expected
+    assert fasttoml.loads_many(iter(docs[:5])) == expected[:5]
+    assert fasttoml.loads_many([]) == []
+
+
+def test_loads_many_reports_failing_index():
+    with pytest.raises(ValueError, match="document 2"):
+        fasttoml.loads_many(["a = 1", "b = 2", "c = ", "d = 4"], threads=2)
+    with pytest.raises(TypeError):
+        fasttoml.loads_many(["a = 1", 42])
+
+
+def test_load_many(tmp_path):
+    paths = []
+    for i in range(100):
+        path = tmp_path / f"svc{i}.toml"
+        path.write_text(f'id = {i}\n[service]\nname = "svc{i}"\n', encoding="utf-8")
+        paths.append(path)
+    result = fasttoml.load_many(paths, threads=3)
+    assert [r["id"] for r in result] == list(range(100))
+    assert result[42]["service"] == {"name": "svc42"}
+    with pytest.raises(FileNotFoundError):
+        fasttoml.load_many(paths + [tmp_path / "missing.toml"])
+
+
+def test_large_loads_from_threads():
+    """Large inputs are parsed without the GIL; results are unaffected."""
+    import threading
+    big = "\n".join(f"[t{i}]\nv = {i}\ns = \"{'x' * 50}\"" for i in range(5000))
+    expected = {f"t{i}": {"v": i, "s": "x" * 50} for i in range(5000)}
+    results = []
+    threads = [threading.Thread(target=lambda: results.append(fasttoml.loads(big))) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert results == [expected] * 4
@@ -36,6 +36,26 @@ Say \\"hello\\" """'''
     assert "hello" in result["key"]
 
 
+def test_multiline_basic_trailing_quotes():
+    """One or two quotes right before the closing delimiter belong to the content."""
+    assert fasttoml.loads('key = """a""""')["key"] == 'a"'
+    assert fasttoml.loads('key = """a"""""')["key"] == 'a""'
+    assert fasttoml.loads('key = """a "" b"""')["key"] == 'a "" b'
+
+
+def test_unescaped_strings_in_arrays_and_tables():
+    """Strings without escapes (zero-copy path) mixed with escaped ones."""
+    toml_str = r'''
+hosts = ["db1.example.com", 'C:\data', "tab\there"]
+[paths]
+root = "/var/lib/app"
+logs = '/var/log/app'
+'''
+    result = fasttoml.loads(toml_str)
+    assert result["hosts"] == ["db1.example.com", "C:\\data", "tab\there"]
+    assert result["paths"] == {"root": "/var/lib/app", "logs": "/var/log/app"}
+
+
 # --- Multiline literal string ''' ---
 
 def test_multiline_literal_simple():
@@ -53,6 +73,11 @@ C:\\\\path\\\\to\\\\file'''"""
     assert result["key"] == "C:\\\\path\\\\to\\\\file"
 
 
+def test_multiline_literal_trailing_quotes():
+    assert fasttoml.loads("key = '''it''''")["key"] == "it'"
+    assert fasttoml.loads("key = '''it'''''")["key"] == "it''"
+
+
 def test_multiline_literal_first_newline_trimmed():
     toml_str = """key = '''
 first line'''"""
@@ -94,5 +119,28 @@ def test_unicode_escape_ascii():
     assert result["key"] == "AB"
 
 
+# --- Long string bodies (bulk-scanned 16/32 bytes at a time) ---
+
+@pytest.mark.parametrize("pos", [0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 100])
+def test_long_basic_string_escape_position(pos):
+    body = "x" * 120
+    toml_str = 'key = "' + body[:pos] + '\\n' + body[pos:] + '"'
+    assert fasttoml.loads(toml_str)["key"] == body[:pos] + "\n" + body[pos:]
+
+
+def test_long_multiline_strings():
+    cert = "\n".join("MIIB" + "A" * 60 for _ in range(40))
+    toml_str = f'basic = """\n{cert}\n"""\nliteral = \'\'\'\n{cert}\n\'\'\'\nesc = """\n{cert}\\t\n"""\n'
+    result = fasttoml.loads(toml_str)
+    assert result["basic"] == cert + "\n"
+    assert result["literal"] == cert + "\n"
+    assert result["esc"] == cert + "\t\n"
+
+
+def test_long_string_utf8():
+    text = "héllo wörld ✓ " * 20
+    assert fasttoml.loads(f'a = "{text}"\nb = \'{text}\'')["b"] == text
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])
@@ -0,0 +1,96 @@
+"""Tests for parsing large documents on several threads (threads=)."""
+
+import datetime
+
+import pytest
+import fasttoml
+
+
+def _big_doc(packages=10000):
+    # Well over the 1 MiB threshold, with sections of every kind
+    parts = ['title = "big"\nlimits.cpu = 2\n[server.tls]\nport = 443\n']
+    for i in range(packages):
+        parts.append(
+            f'[[package]]\nname = "pkg{i}"\nversion = "1.{i % 10}.0"\n'
+            f'deps = [\n  "a{i % 7}",  # [not a header]\n  "b",\n]\nmeta = {{ id = {i}, ok = true }}\n'
+            f"text = '''\n[not.a.header]\n'''\n"
+        )
+        if i % 1000 == 0:
+            parts.append(f"[package.extra]\nn = {i}\n[group{i}]\nlimits.mem = {i}\n")
+    # server already exists (created by [server.tls]), so this section is merged into it
+    parts.append('[server]\nhost = "a"\nborn = 1979-05-27T07:32:00Z\n')
+    return "".join(parts)
+
+
+def _ordered(value):
+    # dict equality ignores order; compare key order too
+    if isinstance(value, dict):
+        return [(k, _ordered(v)) for k, v in value.items()]
+    if isinstance(value, list):
+        return [_ordered(v) for v in value]
+    return value
+
+
+def test_threads_match_one_thread():
+    doc = _big_doc()
+    assert len(doc) > 1024 * 1024
+    expected = fasttoml.loads(doc)
+    assert expected["package"][1000]["extra"] == {"n": 1000}
+    assert expected["group5000"] == {"limits": {"mem": 5000}}
+    assert list(expected["server"]) == ["tls", "host", "born"]
+    assert expected["server"]["born"] == datetime.datetime(1979, 5, 27, 7, 32, tzinfo=datetime.timezone.utc)
+    for threads in (2, 4, 0):
+        assert _ordered(fasttoml.loads(doc, threads=threads)) == _ordered(expected)
+        assert _ordered(fasttoml.loads_bytes(doc.encode("utf-8"), threads=threads)) == _ordered(expected)
+
+
+def test_threads_entry_points(tmp_path):
+    doc = _big_doc()
+    path = tmp_path / "big.toml"
+    path.write_bytes(doc.encode("utf-8"))
+    expected = _ordered(fasttoml.loads(doc))
+    assert _ordered(fasttoml.load_path(path, threads=4)) == expected
+    assert _ordered(fasttoml.load(path, threads=4)) == expected
+    with open(path, "rb") as f:
+        assert _ordered(fasttoml.load(f, threads=4)) == expected
+    result = fasttoml.loads(doc, threads=4, numeric_arrays="buffer")
+    assert result["package"][3]["meta"] == {"id": 3, "ok": True}
+    assert fasttoml.loads(doc, threads=4, select=["package[*].name"])["package"][2] == {"name": "pkg2"}
+
+
+def test_threads_arrays_counted_ahead():
+    # Sections go through the C++ tree, which sizes arrays of scalars from a
+    # count of their commas; strings with commas and brackets must not fool it
+    rows = [
+        "a = [1, 2, 3]", "b = [1, 2, 3,]", "c = [\n  1,\n  2,\n]", 'd = ["x,y", "]", \'z,]\', "\\"", "\\",]", ""]',
+        "e = [1, [2, 3], { f = [4, 5] }]", 'g = ["""a,\n]""", 1]', "h = [1, # 2, 3]\n 4]", "i = [1.5, 2, true]",
+    ]
+    doc = "".join(f"[s{i}]\n" + "\n".join(rows) + "\n" for i in range(20000))
+    assert len(doc) > 1024 * 1024
+    expected = fasttoml.loads(doc)
+    assert expected["s0"]["d"] == ["x,y", "]", "z,]", '"', '",]', ""]
+    assert expected["s0"]["h"] == [1, 4]
+    assert fasttoml.loads(doc, threads=4) == expected
+
+
+@pytest.mark.parametrize("tail", [
+    "[title]\n",                         # redefines a string as a table
+    "[server]\nhost.x = 1\n",            # dotted key through a string
+    "[server]\ntls.port.x = 1\n",        # and through a table's integer
+    "[group0.limits]\n[group0.limits.mem]\n",
+    "[x]\nv = [1,\n",                    # unterminated array runs to the end
+    "[x]\ns = \"unterminated\n",
+    "[x]\n[y] z = 1\nbad = \n",
+])
+def test_threads_report_the_same_error(tail):
+    doc = _big_doc() + tail
+    with pytest.raises(fasttoml.TOMLDecodeError) as expected:
+        fasttoml.loads_bytes(doc.encode("utf-8"))
+    with pytest.raises(fasttoml.TOMLDecodeError) as error:
+        fasttoml.loads_bytes(doc.encode("utf-8"), threads=4)
+    assert str(error.value) == str(expected.value)
+    assert (error.value.lineno, error.value.colno) == (expected.value.lineno, expected.value.colno)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
@@ -0,0 +1,92 @@
+"""Tests for the reusable Parser object."""
+
+import io
+import threading
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD
+
+
+DOCS = [TOML_SMALL, TOML_MEDIUM, TOML_REALWORLD, TOML_LARGE]
+
+
+def test_matches_module_functions():
+    parser = fasttoml.Parser()
+    for _ in range(3):
+        for doc in DOCS:
+            assert parser.loads(doc) == fasttoml.loads(doc)
+            assert parser.loads_bytes(doc.encode("utf-8")) == fasttoml.loads(doc)
+
+
+def test_large_documents_stay_valid():
+    # Inputs of 64 KiB or more go through the recycled arena
+    texts = ["".join(f'[t{i}]\nv = {i + n}\ns = "{"x" * 40}"\n' for i in range(2000)) for n in range(3)]
+    assert len(texts[0]) > 64 * 1024
+    parser = fasttoml.Parser()
+    results = [parser.loads(t) for t in texts]
+    results += [parser.loads_bytes(t.encode("utf-8")) for t in texts]
+    for text, result in zip(texts * 2, results):
+        assert result == fasttoml.loads(text)
+
+
+def test_no_state_between_documents():
+    parser = fasttoml.Parser()
+    assert parser.loads("[[a]]\nx = 1\n") == {"a": [{"x": 1}]}
+    # [[a]] of the previous document does not make a static array extensible
+    with pytest.raises(ValueError):
+        parser.loads("a = []\n[[a]]\n")
+    with pytest.raises(ValueError):
+        parser.loads("a = [{}]\n[a.b]\n")
+    assert parser.loads("[[a]]\n[a.b]\ny = 2\n") == {"a": [{"b": {"y": 2}}]}
+
+
+def test_errors_do_not_stick():
+    parser = fasttoml.Parser()
+    with pytest.raises(ValueError):
+        parser.loads("a = { b = 1 c = 2 }\n")
+    assert parser.loads("a = { b = { c = 1 }, d = 2 }\n") == {"a": {"b": {"c": 1}, "d": 2}}
+    with pytest.raises(ValueError):
+        parser.loads("a.b = 1\na.b.c = 2\n")
+    assert parser.loads("x = 1") == {"x": 1}
+    parser.reset()
+    assert parser.loads("x = 2") == {"x": 2}
+
+
+def test_select_and_files(tmp_path):
+    parser = fasttoml.Parser()
+    full = fasttoml.loads(TOML_REALWORLD)
+    key = next(iter(full))
+    assert parser.loads(TOML_REALWORLD, select=[key]) == {key: full[key]}
+    path = tmp_path / "doc.toml"
+    path.write_bytes(TOML_REALWORLD.encode("utf-8"))
+    assert parser.load_path(path) == full
+    assert parser.load(str(path), select=[key]) == {key: full[key]}
+    with open(path, "rb") as f:
+        assert parser.load(f) == full
+    assert parser.load(io.StringIO(TOML_REALWORLD)) == full
+    with pytest.raises(FileNotFoundError):
+        parser.load_path(tmp_path / "missing.toml")
+
+
+def test_shared_between_threads():
+    parser = fasttoml.Parser()
+    expected = [fasttoml.loads(doc) for doc in DOCS]
+    failures = []
+
+    def work():
+        for _ in range(5):
+            for doc, result in zip(DOCS, expected):
+                if parser.loads(doc) != result:
+                    failures.append(doc[:20])
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert failures == []
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
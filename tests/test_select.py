@@ -0,0 +1,109 @@
+"""Tests for projection parsing (select= on loads, loads_bytes, load_path, load)."""
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_REALWORLD
+
+
+DOC = '''
+title = "demo"
+[database]
+name = "db"
+pool = { size = 5, max = [1, { a = 2 }], "q.k" = 'v' }
+[[servers]]
+host = "a"
+port = 1
+[[servers]]
+host = "b"
+tags = ["x", "]", "#"]  # comment
+[servers.meta]
+host = "nested"
+[other]
+big = [[1, 2], { x = "}" }, """
+multi ] }
+"""]
+'''
+
+
+def test_select_nested_key():
+    assert fasttoml.loads(DOC, select=["database.pool.size"]) == {"database": {"pool": {"size": 5}}}
+
+
+def test_select_array_of_tables():
+    expected = {"servers": [{"host": "a"}, {"host": "b"}]}
+    assert fasttoml.loads(DOC, select=["servers[*].host"]) == expected
+    # Arrays are looked through, [*] is optional
+    assert fasttoml.loads(DOC, select=["servers.host"]) == expected
+    assert fasttoml.loads(DOC, select=["servers[*].meta.host"]) == {"servers": [{}, {"meta": {"host": "nested"}}]}
+
+
+def test_select_whole_subtrees():
+    full = fasttoml.loads(DOC)
+    assert fasttoml.loads(DOC, select=["database"]) == {"database": full["database"]}
+    assert fasttoml.loads(DOC, select=["title", "other"]) == {"title": "demo", "other": full["other"]}
+    # A shorter path covers longer ones, in either order
+    assert fasttoml.loads(DOC, select=["database.name", "database"]) == {"database": full["database"]}
+    assert fasttoml.loads(DOC, select=["database", "database.name"]) == {"database": full["database"]}
+
+
+def test_select_inside_inline_values():
+    assert fasttoml.loads(DOC, select=["database.pool.max"]) == {"database": {"pool": {"max": [1, {"a": 2}]}}}
+    assert fasttoml.loads(DOC, select=["database.pool.max.a"]) == {"database": {"pool": {"max": [1, {"a": 2}]}}}
+    assert fasttoml.loads(DOC, select=['database.pool."q.k"']) == {"database": {"pool": {"q.k": "v"}}}
+    assert fasttoml.loads("a = { b = { c = 1, d = 2 }, e = 3 }", select=["a.b.d"]) == {"a": {"b": {"d": 2}}}
+
+
+def test_select_missing_and_empty():
+    assert fasttoml.loads(DOC, select=["missing"]) == {}
+    # Tables on the way to a selected key are kept
+    assert fasttoml.loads(DOC, select=["database.missing"]) == {"database": {}}
+    assert fasttoml.loads(DOC, select=[]) == {}
+    assert fasttoml.loads(DOC, select=None) == fasttoml.loads(DOC)
+
+
+def test_select_matches_full_parse():
+    full = fasttoml.loads(TOML_REALWORLD)
+    for key in full:
+        assert fasttoml.loads(TOML_REALWORLD, select=[key]) == {key: full[key]}
+
+
+def test_select_large_document():
+    text = "".join(f'[t{i}]\nv = {i}\ns = "{"x" * 40}"\n' for i in range(3000))
+    assert len(text) > 64 * 1024
+    assert fasttoml.loads(text, select=["t1234.v", "t7"]) == {"t1234": {"v": 1234}, "t7": {"v": 7, "s": "x" * 40}}
+
+
+def test_select_other_entry_points(tmp_path):
+    expected = {"servers": [{"host": "a"}, {"host": "b"}]}
+    assert fasttoml.loads_bytes(DOC.encode("utf-8"), select=["servers.host"]) == expected
+    path = tmp_path / "doc.toml"
+    path.write_bytes(DOC.encode("utf-8"))
+    assert fasttoml.load_path(path, select=["servers.host"]) == expected
+    assert fasttoml.load(path, select=("servers.host",)) == expected
+    with open(path, "rb") as f:
+        assert fasttoml.load(f, select=iter(["servers.host"])) == expected
+
+
+def test_select_invalid_paths():
+    for path in ["", "a..b", "a.", "a[0]", "a b"]:
+        with pytest.raises(ValueError, match="Invalid select path"):
+            fasttoml.loads(DOC, select=[path])
+    with pytest.raises(TypeError):
+        fasttoml.loads(DOC, select="title")
+    with pytest.raises(TypeError):
+        fasttoml.loads(DOC, select=[1])
+
+
+def test_select_syntax_errors_still_reported():
+    with pytest.raises(ValueError):
+        fasttoml.loads('a = 1\nb = "unterminated\n', select=["a"])
+    with pytest.raises(ValueError):
+        fasttoml.loads("a = 1\nb = [1, 2\n", select=["a"])
+    with pytest.raises(ValueError):
+        fasttoml.loads("a = 1\n[t\nb = 2\n", select=["a"])
+    with pytest.raises(ValueError):
+        fasttoml.loads("a = { b = 1 c = 2 }\n", select=["a.b"])
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
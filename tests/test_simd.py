@@ -0,0 +1,88 @@
+"""Tests for the runtime-selected SIMD kernels (simd_isa, FASTTOML_SIMD)."""
+
+import json
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+import fasttoml
+
+
+def _cases():
+    # Runs around the 16- and 32-byte block sizes, with the interesting byte at every offset
+    docs = []
+    for n in (0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65):
+        pad = "x" * n
+        docs.append(f'a = "{pad}"\n')
+        docs.append(f'a = "{pad}\\n{pad}"\n')
+        docs.append(f"a = '{pad}\\'\n")
+        docs.append(f'a = """{pad}\n{pad}"""\n')
+        docs.append(" " * n + "\t" * n + f"a = 1{' ' * n}# {pad}\n" + "\n" * n + "b = 2\n")
+        docs.append(f'a = "{pad}é€😀{pad}"\n')
+        docs.append(f'[t]\nk = ["{pad}", {{ x = 1 }}]\n')
+        # Errors: control bytes, bad UTF-8, lone CR, unterminated string
+        docs.append(f'a = "{pad}\x01"\n')
+        docs.append(f"a = 1 # {pad}\x7f\n")
+        docs.append(f"a = 1\r{pad}\n")
+        docs.append(f'a = "{pad}')
+        docs.append(f'a = "{pad}\x1f{pad}"\n')
+    return docs
+
+
+def _bad_utf8():
+    docs = []
+    for n in (0, 15, 16, 29, 30, 31, 32, 33, 61, 62, 63):
+        pad = b"x" * n
+        for seq in (b"\xc0\x80", b"\xed\xa0\x80", b"\xf4\x90\x80\x80", b"\xe2\x82", b"\x80", b"\xff"):
+            docs.append(b'a = "' + pad + seq + b'"\n')
+    return docs
+
+
+def _outcomes():
+    out = []
+    for doc in _cases():
+        try:
+            out.append(["ok", json.dumps(fasttoml.loads(doc))])
+        except fasttoml.TOMLDecodeError as e:
+            out.append(["error", str(e)])
+    for doc in _bad_utf8():
+        try:
+            fasttoml.loads_bytes(doc)
+            out.append(["ok"])
+        except fasttoml.TOMLDecodeError as e:
+            out.append(["error", str(e)])
+    for doc in _cases()[:40]:
+        try:
+            out.append(["ok", fasttoml.dumps(fasttoml.loads(doc))])
+        except fasttoml.TOMLDecodeError:
+            out.append(["error"])
+    return out
+
+
+def test_simd_isa():
+    assert fasttoml.simd_isa() in ("avx2", "sse2", "neon", "scalar")
+
+
+def test_bad_utf8_is_rejected():
+    for doc in _bad_utf8():
+        with pytest.raises(fasttoml.TOMLDecodeError):
+            fasttoml.loads_bytes(doc)
+
+
+def test_forced_sse2_kernels_agree():
+    # The kernel set is chosen at import, so run the SSE2 one in a child process
+    if fasttoml.simd_isa() not in ("avx2", "sse2"):
+        pytest.skip("x86 only")
+    code = "import json, fasttoml, test_simd; print(json.dumps([fasttoml.simd_isa(), test_simd._outcomes()]))"
+    env = dict(os.environ, FASTTOML_SIMD="sse2", PYTHONPATH=os.pathsep.join(sys.path))
+    result = subprocess.run([sys.executable, "-c", code], cwd=Path(__file__).parent, env=env,
+                            capture_output=True, text=True, check=True)
+    isa, outcomes = json.loads(result.stdout)
+    assert isa == "sse2"
+    assert outcomes == _outcomes()
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
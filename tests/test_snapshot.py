@@ -0,0 +1,184 @@
+"""Tests for load_cached() and its binary snapshots."""
+
+import os
+import struct
+from datetime import datetime, timedelta, timezone
+
+import pytest
+import fasttoml
+
+
+DOC = '''
+title = "snapshot"
+int = -42
+big = 9223372036854775807
+float = 3.5
+inf = inf
+flag = true
+utc = 1979-05-27T07:32:00Z
+offset = 1979-05-27T00:32:00.999-07:00
+local = 1979-05-27T07:32:00
+date = 1979-05-27
+time = 07:32:00
+fraction = 1979-05-27 07:32:00.000001250
+empty = []
+ints = [1, 2, 3]
+floats = [1.5, 2.5]
+mixed = [1, "two", [3.0, {x = 4}], []]
+inline = { a = { b = "c" }, "quoted key" = "é€😀" }
+
+[server]
+host = "localhost"
+ports = [8000, 8001]
+
+[[products]]
+name = "Hammer"
+
+[[products]]
+name = "Nail"
+sizes = [[1, 2], [3]]
+
+[server.extra]
+nested.key = 1
+'''
+
+
+def _write(path, text):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def _snapshot(path):
+    return path.parent / f".{path.name}.ftsnap"
+
+
+def test_roundtrip(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, DOC)
+    first = fasttoml.load_cached(path)
+    assert _snapshot(path).exists()
+    second = fasttoml.load_cached(path)
+    assert first == second == fasttoml.load_path(path)
+    assert second["offset"] == datetime(1979, 5, 27, 0, 32, 0, 999000, tzinfo=timezone(timedelta(hours=-7)))
+    assert second["products"][1]["sizes"] == [[1, 2], [3]]
+    assert list(second) == list(first)
+
+
+def test_large_table(tmp_path):
+    path = tmp_path / "big.toml"
+    _write(path, "".join(f"key{i} = {i}\n" for i in range(1000)) + "[t]\n" + "z = 1\n")
+    fasttoml.load_cached(path)
+    data = fasttoml.load_cached(path)
+    assert data == fasttoml.load_path(path)
+    assert list(data)[:3] == ["key0", "key1", "key2"]
+
+
+def test_snapshot_path(tmp_path):
+    path = tmp_path / "config.toml"
+    snap = tmp_path / "cache" / "config.snap"
+    snap.parent.mkdir()
+    _write(path, DOC)
+    fasttoml.load_cached(path, snapshot=snap)
+    assert snap.exists() and not _snapshot(path).exists()
+    assert fasttoml.load_cached(str(path), snapshot=str(snap)) == fasttoml.load_path(path)
+
+
+def test_mtime_change_rebuilds(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, "a = 1\n")
+    assert fasttoml.load_cached(path) == {"a": 1}
+    _write(path, "a = 2\n")
+    st = os.stat(path)
+    os.utime(path, ns=(st.st_atime_ns, st.st_mtime_ns + 10**9))
+    assert fasttoml.load_cached(path) == {"a": 2}
+    assert fasttoml.load_cached(path) == {"a": 2}
+
+
+def test_hash_check_sees_same_mtime_edit(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, "a = 1\n")
+    fasttoml.load_cached(path)
+    st = os.stat(path)
+    # Same size and mtime: the mtime check cannot tell, the hash check can
+    _write(path, "a = 2\n")
+    os.utime(path, ns=(st.st_atime_ns, st.st_mtime_ns))
+    assert fasttoml.load_cached(path) == {"a": 1}
+    assert fasttoml.load_cached(path, check="hash") == {"a": 2}
+    assert fasttoml.load_cached(path, check="hash") == {"a": 2}
+
+
+def test_damaged_snapshot_rebuilds(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, DOC)
+    expected = fasttoml.load_cached(path)
+    snap = _snapshot(path)
+    blob = snap.read_bytes()
+    for damaged in (b"", blob[:40], blob[:len(blob) // 2], b"x" * len(blob), blob[:8] + b"\xff" * 8 + blob[16:]):
+        snap.write_bytes(damaged)
+        assert fasttoml.load_cached(path) == expected
+        assert snap.read_bytes() == blob
+    # Any changed byte, including a number or string in the body
+    for i in range(0, len(blob), 7):
+        snap.write_bytes(blob[:i] + bytes([blob[i] ^ 0xA5]) + blob[i + 1:])
+        assert fasttoml.load_cached(path) == expected
+
+
+
+def test_damaged_root_record_rebuilds(tmp_path):
+    # The root table's record is the header's last 16 bytes: {type, 3 unused,
+    # a, b = offset of the root block}
+    path = tmp_path / "config.toml"
+    _write(path, DOC)
+    expected = fasttoml.load_cached(path)
+    snap = _snapshot(path)
+    blob = snap.read_bytes()
+    root = 64
+    (root_block,) = struct.unpack_from("=Q", blob, root + 8)
+    (entries,) = struct.unpack_from("=Q", blob, root_block)
+    # Point the root record at the [server] table's block instead
+    for i in range(entries):
+        at = root_block + 8 + i * 24
+        key_at, key_size = struct.unpack_from("=II", blob, at)
+        if blob[key_at:key_at + key_size] == b"server":
+            (server_block,) = struct.unpack_from("=Q", blob, at + 16)
+    redirected = bytearray(blob)
+    struct.pack_into("=Q", redirected, root + 8, server_block)
+    retyped = bytearray(blob)
+    retyped[root] = 0  # another type, here an integer
+    for damaged in (redirected, retyped):
+        snap.write_bytes(bytes(damaged))
+        assert fasttoml.load_cached(path) == expected
+        assert fasttoml.load_cached(path, check="hash") == expected
+        assert snap.read_bytes() == blob
+
+def test_invalid_toml(tmp_path):
+    path = tmp_path / "bad.toml"
+    _write(path, "a = \n")
+    with pytest.raises(fasttoml.TOMLDecodeError):
+        fasttoml.load_cached(path)
+    assert not _snapshot(path).exists()
+
+
+def test_missing_file(tmp_path):
+    with pytest.raises(FileNotFoundError):
+        fasttoml.load_cached(tmp_path / "missing.toml")
+
+
+def test_unwritable_snapshot(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, "a = 1\n")
+    snap = tmp_path / "no-such-dir" / "config.snap"
+    assert fasttoml.load_cached(path, snapshot=snap) == {"a": 1}
+    assert not snap.exists()
+    assert os.listdir(tmp_path) == ["config.toml"]
+
+
+def test_invalid_check(tmp_path):
+    path = tmp_path / "config.toml"
+    _write(path, "a = 1\n")
+    with pytest.raises(ValueError):
+        fasttoml.load_cached(path, check="size")
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
@@ -0,0 +1,86 @@
+"""Tests for stats=True parse profiles."""
+
+import io
+
+import pytest
+import fasttoml
+
+
+DOC = '''
+a = 1
+b = "x"
+c = [1.5, { d = 1979-05-27T07:32:00Z }]
+flag = true
+
+[x.y]
+z = [[1]]
+
+[[p]]
+t = 07:32:00
+'''
+
+COUNTS = {
+    "integers": 2, "floats": 1, "booleans": 1, "strings": 1, "datetimes": 2, "arrays": 3, "inline_tables": 1,
+    "tables": 1, "array_tables": 1, "keys": 6, "max_depth": 5,
+}
+
+TIMES = ("validate_ns", "strings_ns", "numbers_ns", "datetimes_ns", "tables_ns", "parse_ns", "convert_ns")
+
+
+def _check(result):
+    data, stats = result
+    assert data == fasttoml.loads(DOC)
+    assert {k: stats[k] for k in COUNTS} == COUNTS
+    assert stats["bytes"] == len(DOC.encode())
+    assert all(isinstance(stats[k], int) and stats[k] >= 0 for k in TIMES)
+    assert stats["parse_ns"] >= stats["validate_ns"] + stats["tables_ns"]
+    assert stats["arena_bytes"] > 0 and stats["arena_blocks"] >= 1
+    assert stats["arena_reserved"] >= stats["arena_bytes"]
+
+
+def test_loads_stats():
+    _check(fasttoml.loads(DOC, stats=True))
+
+
+def test_loads_bytes_stats():
+    _check(fasttoml.loads_bytes(DOC.encode(), stats=True))
+
+
+def test_load_stats(tmp_path):
+    path = tmp_path / "doc.toml"
+    path.write_bytes(DOC.encode())
+    _check(fasttoml.load_path(path, stats=True))
+    _check(fasttoml.load(path, stats=True))
+    _check(fasttoml.load(io.BytesIO(DOC.encode()), stats=True))
+
+
+def test_stats_off_returns_dict():
+    assert isinstance(fasttoml.loads(DOC), dict)
+    assert isinstance(fasttoml.loads(DOC, stats=False), dict)
+
+
+def test_depth():
+    assert fasttoml.loads("", stats=True)[1]["max_depth"] == 0
+    assert fasttoml.loads("a = 1", stats=True)[1]["max_depth"] == 1
+    assert fasttoml.loads("a.b.c = 1", stats=True)[1]["max_depth"] == 3
+    assert fasttoml.loads("a = { b.c = { d = [1] } }", stats=True)[1]["max_depth"] == 5
+    assert fasttoml.loads("[a.b.c.d]", stats=True)[1]["max_depth"] == 4
+
+
+def test_large_document_counts():
+    doc = "".join(f'[t{i}]\nn = {i}\ns = "v{i}"\nf = {i}.5\n' for i in range(5000))
+    data, stats = fasttoml.loads(doc, numeric_arrays="buffer", stats=True, threads=4)
+    assert len(data) == 5000
+    assert (stats["tables"], stats["integers"], stats["strings"], stats["floats"]) == (5000, 5000, 5000, 5000)
+
+
+def test_stats_errors():
+    with pytest.raises(fasttoml.TOMLDecodeError) as info:
+        fasttoml.loads("a = 1\nb = \n", stats=True)
+    assert info.value.lineno == 2
+    with pytest.raises(ValueError):
+        fasttoml.loads(DOC, select=["a"], stats=True)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
@@ -0,0 +1,145 @@
+"""Tests for incremental event parsing (EventParser, iter_events)."""
+
+import io
+
+import pytest
+import fasttoml
+from tests.benchmark_data import TOML_SMALL, TOML_MEDIUM, TOML_LARGE, TOML_REALWORLD
+
+
+# Statements that span lines, and brackets, quotes and '#' where they do not count
+TRICKY = (
+    '# header [comment] "x\n'
+    'a = 1\n'
+    '"q k" = \'lit "\'\n'
+    '[t.x]  # c ]]\n'
+    'b = [1, [2, "]"], {c = "x"},\n'
+    '  # inner comment ]\n'
+    '  3]\n'
+    's = """\n'
+    'q""""\n'
+    "s2 = '''a''''\n"
+    's3 = """ \\""" \\\\"""\n'
+    'esc = "a\\"b\\\\"\n'
+    '[[arr]]\n'
+    'k.j = {p = 1, q = [1, 2]}\n'
+    'dt = 1979-05-27T07:32:00Z\n'
+    '[[arr]]\n'
+    'x = 2\r\n'
+    'y = "é"\r\n'
+)
+
+
+def rebuild(events):
+    """Build the document from its events, as a consumer would."""
+    root = {}
+
+    def walk(table, parts):
+        for part in parts:
+            table = table.setdefault(part, {})
+            if isinstance(table, list):
+                table = table[-1]
+        return table
+
+    frames = [[root, None]]  # open table, array or inline table; key awaiting its value
+    for kind, payload in events:
+        if kind == "table":
+            frames = [[walk(root, payload), None]]
+        elif kind == "array_table":
+            table = {}
+            walk(root, payload[:-1]).setdefault(payload[-1], []).append(table)
+            frames = [[table, None]]
+        elif kind == "key":
+            frames[-1][1] = payload
+        elif kind == "end":
+            frames.pop()
+        else:
+            value = {} if kind == "begin_inline_table" else [] if kind == "begin_array" else payload
+            container, key = frames[-1]
+            if isinstance(container, list):
+                container.append(value)
+            else:
+                walk(container, key[:-1])[key[-1]] = value
+            if kind != "scalar":
+                frames.append([value, None])
+    assert len(frames) == 1
+    return root
+
+
+def test_event_sequence():
+    events = list(fasttoml.iter_events([TRICKY]))
+    assert events[:4] == [("key", ("a",)), ("scalar", 1), ("key", ("q k",)), ("scalar", 'lit "')]
+    assert events[4:16] == [
+        ("table", ("t", "x")), ("key", ("b",)), ("begin_array", None), ("scalar", 1),
+        ("begin_array", None), ("scalar", 2), ("scalar", "]"), ("end", None),
+        ("begin_inline_table", None), ("key", ("c",)), ("scalar", "x"), ("end", None),
+    ]
+    assert ("array_table", ("arr",)) in events
+    assert ("key", ("k", "j")) in events
+    assert rebuild(events) == fasttoml.loads(TRICKY)
+
+
+def test_every_split_point():
+    expected = list(fasttoml.iter_events([TRICKY]))
+    data = TRICKY.encode("utf-8")
+    for i in range(len(data) + 1):
+        assert list(fasttoml.iter_events([data[:i], data[i:]])) == expected, i
+
+
+def test_small_chunks():
+    for doc in (TOML_SMALL, TOML_MEDIUM, TOML_REALWORLD, TRICKY):
+        expected = fasttoml.loads(doc)
+        for size in (1, 2, 3, 7, 64, 4096):
+            assert rebuild(fasttoml.iter_events(io.StringIO(doc), chunk_size=size)) == expected, size
+
+
+def test_large_document():
+    text = TOML_LARGE + "\n" + "".join(f'[t{i}]\nv = [{i}, "{"x" * 40}"]\n' for i in range(2000))
+    assert len(text) > 64 * 1024
+    expected = fasttoml.loads(text)
+    # One chunk parsed without the GIL, and many statements per chunk
+    assert rebuild(fasttoml.iter_events(text.encode("utf-8"))) == expected
+    assert rebuild(fasttoml.iter_events(io.BytesIO(text.encode("utf-8")), chunk_size=1000)) == expected
+
+
+def test_sources(tmp_path):
+    expected = fasttoml.loads(TOML_REALWORLD)
+    path = tmp_path / "doc.toml"
+    path.write_bytes(TOML_REALWORLD.encode("utf-8"))
+    assert rebuild(fasttoml.iter_events(path, chunk_size=100)) == expected
+    assert rebuild(fasttoml.iter_events(str(path))) == expected
+    with open(path, "rb") as f:
+        assert rebuild(fasttoml.iter_events(f, chunk_size=100)) == expected
+    assert rebuild(fasttoml.iter_events(bytearray(path.read_bytes()))) == expected
+    assert rebuild(fasttoml.iter_events(memoryview(path.read_bytes()))) == expected
+
+
+def test_event_parser():
+    parser = fasttoml.EventParser()
+    # Nothing is reported until the statement is complete
+    assert parser.feed("a = [1,\n") == []
+    assert parser.feed(b"2]\nb = ") == [("key", ("a",)), ("begin_array", None), ("scalar", 1), ("scalar", 2), ("end", None)]
+    assert parser.feed("true") == []
+    assert parser.finish() == [("key", ("b",)), ("scalar", True)]
+    with pytest.raises(RuntimeError):
+        parser.feed("c = 1\n")
+    with pytest.raises(TypeError):
+        fasttoml.EventParser().feed(1)
+
+
+def test_errors():
+    for doc in ['a = "unterminated\nb = 1\n', "a = [1, 2\n", "[t\nb = 2\n", "a = 1 b = 2\n", "a = \n", "= 1\n"]:
+        with pytest.raises(fasttoml.TOMLDecodeError):
+            list(fasttoml.iter_events([doc]))
+    # Events before the failing statement are delivered
+    events = fasttoml.iter_events(["a = 1\n", "b = [\n"])
+    assert next(events) == ("key", ("a",))
+    assert next(events) == ("scalar", 1)
+    with pytest.raises(fasttoml.TOMLDecodeError, match="TOML parse error") as exc_info:
+        next(events)
+    # Located from the start of the stream, not of the failing statement
+    assert (exc_info.value.lineno, exc_info.value.colno, exc_info.value.pos) == (3, 1, 12)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__, "-v"])
@@ -223,5 +223,123 @@ dc = "eqdc10"
     ]
 
 
+
+def test_many_nested_array_of_tables_headers():
+    """Thousands of repeated [[a.b]] headers, each with its own subtable and nested array."""
+    n = 3000
+    toml_str = "".join(
+        f'[[servers.backends]]\nname = "b{i}"\n[servers.backends.health]\nok = true\n'
+        f"[[servers.backends.ports]]\nn = {i}\n"
+        for i in range(n)
+    )
+    result = fasttoml.loads(toml_str)
+    backends = result["servers"]["backends"]
+    assert len(backends) == n
+    assert backends[1234] == {"name": "b1234", "health": {"ok": True}, "ports": [{"n": 1234}]}
+
+
+def test_array_of_tables_quoted_and_dotted_paths():
+    toml_str = """
+[["a.b"]]
+x = 1
+[[a.b]]
+y = 2
+[["a.b"]]
+x = 3
+["a.b".sub]
+z = 4
+"""
+    assert fasttoml.loads(toml_str) == {
+        "a.b": [{"x": 1}, {"x": 3, "sub": {"z": 4}}],
+        "a": {"b": [{"y": 2}]},
+    }
+
+
+@pytest.mark.parametrize("toml_str", [
+    "a = []\n[[a]]",
+    "a = [1]\n[a.b]",
+    "[a]\nb = [{}]\n[[a.b]]",
+    "[a.b]\n[[a]]",
+])
+def test_array_of_tables_conflicts(toml_str):
+    with pytest.raises(ValueError):
+        fasttoml.loads(toml_str)
+
+
+def _order_doc(n):
+    root = "".join(f"z{i} = {i}\n" for i in range(n, 0, -1))
+    table = "".join(f"k{i}.x = {i}\n" for i in range(n, 0, -1))
+    return root + "inline = { c = 1, a = 2, b = 3 }\n[t]\n" + table
+
+
+@pytest.mark.parametrize("n", [3, 16, 17, 200])
+def test_key_order_preserved(n, tmp_path):
+    """Keys come back in document order, on every parse path."""
+    doc = _order_doc(n)
+    root_keys = [f"z{i}" for i in range(n, 0, -1)] + ["inline", "t"]
+    table_keys = [f"k{i}" for i in range(n, 0, -1)]
+    path = tmp_path / "doc.toml"
+    path.write_bytes(doc.encode("utf-8"))
+    # Padding past 64 KiB takes the GIL-free path of loads()
+    big = doc + "".join(f"p{i} = {i}\n" for i in range(8000))
+    results = [
+        fasttoml.loads(doc),
+        fasttoml.loads_bytes(doc.encode("utf-8")),
+        fasttoml.load_path(path),
+        fasttoml.Parser().loads(doc),
+        fasttoml.loads(big),
+    ] + fasttoml.loads_many([doc, doc.encode("utf-8")])
+    for result in results:
+        assert list(result)[:len(root_keys)] == root_keys
+        assert list(result["inline"]) == ["c", "a", "b"]
+        assert list(result["t"])[:n] == table_keys
+        assert result["t"]["k1"] == {"x": 1}
+
+
+@pytest.mark.parametrize("toml_str", [
+    "".join(f"k{i} = {i}\n" for i in range(40)) + "k7.x = 1\n",
+    "[t]\n" + "".join(f"k{i} = {i}\n" for i in range(40)) + "[t.k39]\n",
+    "".join(f"[t{i}]\n" for i in range(40)) + "[[t3]]\n",
+])
+def test_conflicts_in_wide_tables(toml_str):
+    with pytest.raises(ValueError):
+        fasttoml.loads(toml_str)
+    with pytest.raises(ValueError):
+        fasttoml.loads_bytes(toml_str.encode("utf-8"))
+
+
+def _key_objects(table):
+    return [id(k) for k in table]
+
+
+def test_repeated_keys_share_one_str(tmp_path):
+    entry = '[[package]]\nname = "p"\nsource.git = "x"\nmeta = { long_key_name_for_sharing = 1 }\n'
+    small = entry * 3
+    big = entry * 2000  # parsed through the C++ tree
+    path = tmp_path / "big.toml"
+    path.write_bytes(big.encode("utf-8"))
+    parser = fasttoml.Parser()
+    results = [
+        [fasttoml.loads(small)],
+        [fasttoml.loads(big)],
+        [fasttoml.loads_bytes(big.encode("utf-8"))],
+        [fasttoml.load_path(path)],
+        [fasttoml.loads(big * 8, threads=2)],
+        [fasttoml.loads(small, numeric_arrays="buffer")],
+        [fasttoml.loads_lazy(big).to_dict()],
+        [parser.loads(small), parser.loads_bytes(small.encode("utf-8"))],
+        fasttoml.loads_many([small, big]),
+    ]
+    for docs in results:
+        packages = [p for doc in docs for p in doc["package"]]
+        first = packages[0]
+        for p in packages[1:]:
+            assert _key_objects(p) == _key_objects(first)
+            assert _key_objects(p["source"]) == _key_objects(first["source"])
+            assert _key_objects(p["meta"]) == _key_objects(first["meta"])
+    names = [path[0] for kind, path in fasttoml.iter_events([small]) if kind == "key" and path == ("name",)]
+    assert len(names) == 3 and names[0] is names[1] is names[2]
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])